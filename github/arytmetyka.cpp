@@ -0,0 +1,393 @@
+/**
+ * @file arytmetyka.cpp
+ * @brief Implementacja jąder polityk przepełnienia i operacji elementami.
+ */
+
+#include "arytmetyka.h"
+#include "sledzenie.h"
+#include "strojenie.h"
+#include "watki.h"
+#include <climits>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Stosuje działanie dwuargumentowe do kolejnych elementów.
+ *
+ * Działanie dopisuje do `blad` wartość niezerową przy przepełnieniu; pętla nie ma
+ * rozgałęzień, więc kompilator może ją wektoryzować.
+ *
+ * @param a Pierwszy argument.
+ * @param b Drugi argument.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @param f Działanie f(a, b, blad).
+ * @return Czy wystąpiło przepełnienie.
+ */
+template <class F>
+static bool elementami(const int* a, const int* b, int* c, size_t n, F f) {
+	unsigned int blad = 0;
+	for (size_t i = 0; i < n; i++) {
+		c[i] = f(a[i], b[i], blad);
+	}
+	return blad != 0;
+}
+
+/**
+ * @brief Stosuje działanie z liczbą do kolejnych elementów.
+ * @param a Argument.
+ * @param x Liczba.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @param f Działanie f(a, x, blad).
+ * @return Czy wystąpiło przepełnienie.
+ */
+template <class F>
+static bool z_liczba(const int* a, int x, int* c, size_t n, F f) {
+	unsigned int blad = 0;
+	for (size_t i = 0; i < n; i++) {
+		c[i] = f(a[i], x, blad);
+	}
+	return blad != 0;
+}
+
+/**
+ * @brief Suma zawijana; do `blad` trafia 1 przy przepełnieniu.
+ *
+ * Przepełnienie wystąpiło, gdy oba argumenty mają ten sam znak, a wynik inny.
+ */
+static inline int suma_bitowo(int a, int b, unsigned int& blad) {
+	unsigned int ua = (unsigned int)a, ub = (unsigned int)b, r = ua + ub;
+	blad |= ((ua ^ r) & (ub ^ r)) >> 31;
+	return (int)r;
+}
+
+/**
+ * @brief Różnica zawijana; do `blad` trafia 1 przy przepełnieniu.
+ *
+ * Przepełnienie wystąpiło, gdy argumenty mają różne znaki, a wynik ma znak odjemnika.
+ */
+static inline int roznica_bitowo(int a, int b, unsigned int& blad) {
+	unsigned int ua = (unsigned int)a, ub = (unsigned int)b, r = ua - ub;
+	blad |= ((ua ^ ub) & (ua ^ r)) >> 31;
+	return (int)r;
+}
+
+/**
+ * @brief Iloczyn zawijany; do `blad` trafia wartość niezerowa przy przepełnieniu.
+ */
+static inline int iloczyn_bitowo(int a, int b, unsigned int& blad) {
+	long long p = (long long)a * b;
+	blad |= (unsigned int)((p + 0x80000000LL) >> 32);
+	return (int)(unsigned int)p;
+}
+
+/**
+ * @brief Wartość nasycenia przy przepełnieniu sumy lub różnicy: INT_MAX dla a >= 0,
+ * INT_MIN dla a < 0.
+ */
+static inline int nasycenie(int a) {
+	return (int)(((unsigned int)a >> 31) + (unsigned int)INT_MAX);
+}
+
+/**
+ * @brief Suma z nasyceniem.
+ */
+static inline int suma_nasycona(int a, int b, unsigned int&) {
+	unsigned int blad = 0;
+	int r = suma_bitowo(a, b, blad);
+	return blad ? nasycenie(a) : r;
+}
+
+/**
+ * @brief Różnica z nasyceniem.
+ */
+static inline int roznica_nasycona(int a, int b, unsigned int&) {
+	unsigned int blad = 0;
+	int r = roznica_bitowo(a, b, blad);
+	return blad ? nasycenie(a) : r;
+}
+
+/**
+ * @brief Iloczyn z nasyceniem.
+ */
+static inline int iloczyn_nasycony(int a, int b, unsigned int&) {
+	long long p = (long long)a * b;
+	return p > INT_MAX ? INT_MAX : p < INT_MIN ? INT_MIN : (int)p;
+}
+
+/**
+ * @brief Działanie zawijane bez zgłaszania przepełnienia.
+ */
+template <int (*F)(int, int, unsigned int&)>
+static inline int bez_zgloszenia(int a, int b, unsigned int&) {
+	unsigned int pominiety = 0;
+	return F(a, b, pominiety);
+}
+
+/**
+ * @brief Suma elementami z zawijaniem.
+ * @param a Argument.
+ * @param b Drugi argument.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return false (polityka nie zgłasza przepełnień).
+ */
+bool zawijanie::dodaj(const int* a, const int* b, int* c, size_t n) {
+	return elementami(a, b, c, n, bez_zgloszenia<suma_bitowo>);
+}
+
+/**
+ * @brief Iloczyn elementami z zawijaniem.
+ * @param a Argument.
+ * @param b Drugi argument.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return false (polityka nie zgłasza przepełnień).
+ */
+bool zawijanie::pomnoz(const int* a, const int* b, int* c, size_t n) {
+	return elementami(a, b, c, n, bez_zgloszenia<iloczyn_bitowo>);
+}
+
+/**
+ * @brief Dodaje liczbę do elementów z zawijaniem.
+ * @param a Argument.
+ * @param x Liczba.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return false (polityka nie zgłasza przepełnień).
+ */
+bool zawijanie::dodaj(const int* a, int x, int* c, size_t n) {
+	return z_liczba(a, x, c, n, bez_zgloszenia<suma_bitowo>);
+}
+
+/**
+ * @brief Odejmuje liczbę od elementów z zawijaniem.
+ * @param a Argument.
+ * @param x Liczba.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return false (polityka nie zgłasza przepełnień).
+ */
+bool zawijanie::odejmij(const int* a, int x, int* c, size_t n) {
+	return z_liczba(a, x, c, n, bez_zgloszenia<roznica_bitowo>);
+}
+
+/**
+ * @brief Mnoży elementy przez liczbę z zawijaniem.
+ * @param a Argument.
+ * @param x Liczba.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return false (polityka nie zgłasza przepełnień).
+ */
+bool zawijanie::pomnoz(const int* a, int x, int* c, size_t n) {
+	return z_liczba(a, x, c, n, bez_zgloszenia<iloczyn_bitowo>);
+}
+
+/**
+ * @brief Suma elementami z nasyceniem.
+ * @param a Argument.
+ * @param b Drugi argument.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return false (polityka nie zgłasza przepełnień).
+ */
+bool nasycanie::dodaj(const int* a, const int* b, int* c, size_t n) {
+	return elementami(a, b, c, n, suma_nasycona);
+}
+
+/**
+ * @brief Iloczyn elementami z nasyceniem.
+ * @param a Argument.
+ * @param b Drugi argument.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return false (polityka nie zgłasza przepełnień).
+ */
+bool nasycanie::pomnoz(const int* a, const int* b, int* c, size_t n) {
+	return elementami(a, b, c, n, iloczyn_nasycony);
+}
+
+/**
+ * @brief Dodaje liczbę do elementów z nasyceniem.
+ * @param a Argument.
+ * @param x Liczba.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return false (polityka nie zgłasza przepełnień).
+ */
+bool nasycanie::dodaj(const int* a, int x, int* c, size_t n) {
+	return z_liczba(a, x, c, n, suma_nasycona);
+}
+
+/**
+ * @brief Odejmuje liczbę od elementów z nasyceniem.
+ * @param a Argument.
+ * @param x Liczba.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return false (polityka nie zgłasza przepełnień).
+ */
+bool nasycanie::odejmij(const int* a, int x, int* c, size_t n) {
+	return z_liczba(a, x, c, n, roznica_nasycona);
+}
+
+/**
+ * @brief Mnoży elementy przez liczbę z nasyceniem.
+ * @param a Argument.
+ * @param x Liczba.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return false (polityka nie zgłasza przepełnień).
+ */
+bool nasycanie::pomnoz(const int* a, int x, int* c, size_t n) {
+	return z_liczba(a, x, c, n, iloczyn_nasycony);
+}
+
+/**
+ * @brief Suma elementami ze sprawdzaniem przepełnienia.
+ * @param a Argument.
+ * @param b Drugi argument.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return Czy wystąpiło przepełnienie.
+ */
+bool sprawdzanie::dodaj(const int* a, const int* b, int* c, size_t n) {
+	return elementami(a, b, c, n, suma_bitowo);
+}
+
+/**
+ * @brief Iloczyn elementami ze sprawdzaniem przepełnienia.
+ * @param a Argument.
+ * @param b Drugi argument.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return Czy wystąpiło przepełnienie.
+ */
+bool sprawdzanie::pomnoz(const int* a, const int* b, int* c, size_t n) {
+	return elementami(a, b, c, n, iloczyn_bitowo);
+}
+
+/**
+ * @brief Dodaje liczbę do elementów ze sprawdzaniem przepełnienia.
+ * @param a Argument.
+ * @param x Liczba.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return Czy wystąpiło przepełnienie.
+ */
+bool sprawdzanie::dodaj(const int* a, int x, int* c, size_t n) {
+	return z_liczba(a, x, c, n, suma_bitowo);
+}
+
+/**
+ * @brief Odejmuje liczbę od elementów ze sprawdzaniem przepełnienia.
+ * @param a Argument.
+ * @param x Liczba.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return Czy wystąpiło przepełnienie.
+ */
+bool sprawdzanie::odejmij(const int* a, int x, int* c, size_t n) {
+	return z_liczba(a, x, c, n, roznica_bitowo);
+}
+
+/**
+ * @brief Mnoży elementy przez liczbę ze sprawdzaniem przepełnienia.
+ * @param a Argument.
+ * @param x Liczba.
+ * @param c Wynik (może być równy a).
+ * @param n Liczba elementów.
+ * @return Czy wystąpiło przepełnienie.
+ */
+bool sprawdzanie::pomnoz(const int* a, int x, int* c, size_t n) {
+	return z_liczba(a, x, c, n, iloczyn_bitowo);
+}
+
+/**
+ * @brief Dzieli wiersze macierzy między wątki puli i zgłasza przepełnienie raz.
+ *
+ * Elementy macierzy leżą w jednym ciągłym bloku, więc każdy wątek wywołuje jądro
+ * raz dla swojego fragmentu wierszy.
+ *
+ * @param n Rozmiar macierzy.
+ * @param fragment Funkcja fragment(od, do_) zwracająca, czy wystąpiło przepełnienie.
+ * @throws std::overflow_error Jeśli którykolwiek fragment zgłosił przepełnienie.
+ */
+template <class F>
+static void po_wierszach(int n, F fragment) {
+	pula_watkow& pula = pula_watkow::globalna();
+	vector<char> bledy(pula.liczba_watkow(), 0);
+	pula.rownolegle(n, [&](int od, int do_, int watek) {
+		bledy[watek] = fragment(od, do_);
+	}, strojenie::biezace().prog);
+	for (size_t t = 0; t < bledy.size(); t++) {
+		if (bledy[t]) {
+			throw overflow_error("Arithmetic overflow");
+		}
+	}
+}
+
+/**
+ * @brief Wykonuje działanie elementami na dwóch macierzach.
+ * @param a Pierwsza macierz.
+ * @param b Druga macierz.
+ * @param j Jądro polityki.
+ * @param nazwa Nazwa operacji (do śledzenia).
+ * @return Nowa macierz.
+ * @throws std::invalid_argument Jeśli rozmiary się różnią.
+ * @throws std::overflow_error Jeśli jądro zgłosiło przepełnienie.
+ */
+matrix arytmetyka::wykonaj(const matrix& a, const matrix& b, jadro_macierzy j, const char* nazwa) {
+	if (a.n != b.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	int n = a.n;
+	sledzenie::zakres sledz(nazwa, n, (long long)n * n * 3 * (long long)sizeof(int));
+	matrix c(n);
+	po_wierszach(n, [&](int od, int do_) {
+		return j(a.data[od], b.data[od], c.data[od], (size_t)(do_ - od) * n);
+	});
+	return c;
+}
+
+/**
+ * @brief Wykonuje działanie z liczbą na każdym elemencie macierzy.
+ * @param a Macierz.
+ * @param x Liczba.
+ * @param j Jądro polityki.
+ * @param nazwa Nazwa operacji (do śledzenia).
+ * @return Nowa macierz.
+ * @throws std::overflow_error Jeśli jądro zgłosiło przepełnienie.
+ */
+matrix arytmetyka::wykonaj(const matrix& a, int x, jadro_liczby j, const char* nazwa) {
+	int n = a.n;
+	sledzenie::zakres sledz(nazwa, n, (long long)n * n * 2 * (long long)sizeof(int));
+	matrix c(n);
+	po_wierszach(n, [&](int od, int do_) {
+		return j(a.data[od], x, c.data[od], (size_t)(do_ - od) * n);
+	});
+	return c;
+}
+
+/**
+ * @brief Wykonuje działanie z liczbą w miejscu.
+ * @param a Macierz modyfikowana.
+ * @param x Liczba.
+ * @param j Jądro polityki.
+ * @param nazwa Nazwa operacji (do śledzenia).
+ * @return Referencja do a.
+ * @throws std::overflow_error Jeśli jądro zgłosiło przepełnienie (a zawiera wtedy wartości zawinięte).
+ */
+matrix& arytmetyka::wykonaj_w_miejscu(matrix& a, int x, jadro_liczby j, const char* nazwa) {
+	int n = a.n;
+	sledzenie::zakres sledz(nazwa, n, (long long)n * n * 2 * (long long)sizeof(int));
+	a.do_zapisu();
+	po_wierszach(n, [&](int od, int do_) {
+		return j(a.data[od], x, a.data[od], (size_t)(do_ - od) * n);
+	});
+	return a;
+}
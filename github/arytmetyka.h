@@ -0,0 +1,300 @@
+#pragma once
+#ifndef ARYTMETYKA_H
+#define ARYTMETYKA_H
+
+#include "matrix.h"
+#include <cstddef>
+using namespace std;
+
+/**
+ * @struct zawijanie
+ * @brief Arytmetyka zawijana modulo 2^32 (jak operatory klasy matrix, ale bez zachowania
+ * niezdefiniowanego przy przepełnieniu).
+ *
+ * Jądra liczą c[i] = a[i] op b[i] (lub op x) dla n elementów i zwracają, czy wystąpiło
+ * przepełnienie, które polityka zgłasza (tu nigdy).
+ */
+struct zawijanie {
+    static const char* nazwa() { return "zawijanie"; }
+    static bool dodaj(const int* a, const int* b, int* c, size_t n);
+    static bool pomnoz(const int* a, const int* b, int* c, size_t n);
+    static bool dodaj(const int* a, int x, int* c, size_t n);
+    static bool odejmij(const int* a, int x, int* c, size_t n);
+    static bool pomnoz(const int* a, int x, int* c, size_t n);
+};
+
+/**
+ * @struct nasycanie
+ * @brief Arytmetyka z nasyceniem: wynik spoza zakresu int jest zastępowany przez
+ * INT_MAX lub INT_MIN.
+ */
+struct nasycanie {
+    static const char* nazwa() { return "nasycanie"; }
+    static bool dodaj(const int* a, const int* b, int* c, size_t n);
+    static bool pomnoz(const int* a, const int* b, int* c, size_t n);
+    static bool dodaj(const int* a, int x, int* c, size_t n);
+    static bool odejmij(const int* a, int x, int* c, size_t n);
+    static bool pomnoz(const int* a, int x, int* c, size_t n);
+};
+
+/**
+ * @struct sprawdzanie
+ * @brief Arytmetyka sprawdzana: wyniki są zawijane, a jądro zwraca true, jeśli
+ * którykolwiek element się przepełnił.
+ */
+struct sprawdzanie {
+    static const char* nazwa() { return "sprawdzanie"; }
+    static bool dodaj(const int* a, const int* b, int* c, size_t n);
+    static bool pomnoz(const int* a, const int* b, int* c, size_t n);
+    static bool dodaj(const int* a, int x, int* c, size_t n);
+    static bool odejmij(const int* a, int x, int* c, size_t n);
+    static bool pomnoz(const int* a, int x, int* c, size_t n);
+};
+
+/**
+ * @class arytmetyka
+ * @brief Operacje elementami na macierzach z polityką przepełnienia wybieraną parametrem szablonu.
+ *
+ * Jądra polityk to proste pętle bez rozgałęzień na elementach (przepełnienie jest
+ * wykrywane bitami znaku i sumowane alternatywą), wektoryzowane przez kompilator.
+ * Operacja jest dzielona między wątki puli; polityka sprawdzanie zgłasza przepełnienie
+ * raz, po zakończeniu całej operacji. Operacje w miejscu zostawiają wtedy w macierzy
+ * wartości zawinięte.
+ *
+ * @code
+ * matrix c = arytmetyka::suma<nasycanie>(a, b);
+ * arytmetyka::pomnoz<sprawdzanie>(a, 3);
+ * @endcode
+ */
+class arytmetyka {
+public:
+    /**
+     * @brief Suma macierzy elementami.
+     * @tparam P Polityka przepełnienia.
+     * @param a Pierwsza macierz.
+     * @param b Druga macierz.
+     * @return Nowa macierz a + b.
+     * @throws std::invalid_argument Jeśli rozmiary się różnią.
+     * @throws std::overflow_error Jeśli P zgłasza przepełnienie i ono wystąpiło.
+     */
+    template <class P>
+    static matrix suma(const matrix& a, const matrix& b) {
+        return wykonaj(a, b, &P::dodaj, "arytmetyka::suma");
+    }
+
+    /**
+     * @brief Iloczyn macierzy elementami.
+     * @tparam P Polityka przepełnienia.
+     * @param a Pierwsza macierz.
+     * @param b Druga macierz.
+     * @return Nowa macierz a * b (elementami).
+     * @throws std::invalid_argument Jeśli rozmiary się różnią.
+     * @throws std::overflow_error Jeśli P zgłasza przepełnienie i ono wystąpiło.
+     */
+    template <class P>
+    static matrix iloczyn_elementow(const matrix& a, const matrix& b) {
+        return wykonaj(a, b, &P::pomnoz, "arytmetyka::iloczyn_elementow");
+    }
+
+    /**
+     * @brief Dodaje liczbę do każdego elementu.
+     * @tparam P Polityka przepełnienia.
+     * @param a Macierz.
+     * @param x Liczba.
+     * @return Nowa macierz a + x.
+     * @throws std::overflow_error Jeśli P zgłasza przepełnienie i ono wystąpiło.
+     */
+    template <class P>
+    static matrix suma(const matrix& a, int x) {
+        return wykonaj(a, x, &P::dodaj, "arytmetyka::suma");
+    }
+
+    /**
+     * @brief Odejmuje liczbę od każdego elementu.
+     * @tparam P Polityka przepełnienia.
+     * @param a Macierz.
+     * @param x Liczba.
+     * @return Nowa macierz a - x.
+     * @throws std::overflow_error Jeśli P zgłasza przepełnienie i ono wystąpiło.
+     */
+    template <class P>
+    static matrix roznica(const matrix& a, int x) {
+        return wykonaj(a, x, &P::odejmij, "arytmetyka::roznica");
+    }
+
+    /**
+     * @brief Mnoży każdy element przez liczbę.
+     * @tparam P Polityka przepełnienia.
+     * @param a Macierz.
+     * @param x Liczba.
+     * @return Nowa macierz a * x.
+     * @throws std::overflow_error Jeśli P zgłasza przepełnienie i ono wystąpiło.
+     */
+    template <class P>
+    static matrix iloczyn(const matrix& a, int x) {
+        return wykonaj(a, x, &P::pomnoz, "arytmetyka::iloczyn");
+    }
+
+    /**
+     * @brief Dodaje liczbę do każdego elementu w miejscu (`+=`, dla x == 1 `++`).
+     * @tparam P Polityka przepełnienia.
+     * @param a Macierz modyfikowana.
+     * @param x Liczba.
+     * @return Referencja do a.
+     * @throws std::overflow_error Jeśli P zgłasza przepełnienie i ono wystąpiło.
+     */
+    template <class P>
+    static matrix& dodaj(matrix& a, int x) {
+        return wykonaj_w_miejscu(a, x, &P::dodaj, "arytmetyka::dodaj");
+    }
+
+    /**
+     * @brief Odejmuje liczbę od każdego elementu w miejscu (`-=`).
+     * @tparam P Polityka przepełnienia.
+     * @param a Macierz modyfikowana.
+     * @param x Liczba.
+     * @return Referencja do a.
+     * @throws std::overflow_error Jeśli P zgłasza przepełnienie i ono wystąpiło.
+     */
+    template <class P>
+    static matrix& odejmij(matrix& a, int x) {
+        return wykonaj_w_miejscu(a, x, &P::odejmij, "arytmetyka::odejmij");
+    }
+
+    /**
+     * @brief Mnoży każdy element przez liczbę w miejscu (`*=`).
+     * @tparam P Polityka przepełnienia.
+     * @param a Macierz modyfikowana.
+     * @param x Liczba.
+     * @return Referencja do a.
+     * @throws std::overflow_error Jeśli P zgłasza przepełnienie i ono wystąpiło.
+     */
+    template <class P>
+    static matrix& pomnoz(matrix& a, int x) {
+        return wykonaj_w_miejscu(a, x, &P::pomnoz, "arytmetyka::pomnoz");
+    }
+
+private:
+    typedef bool (*jadro_macierzy)(const int*, const int*, int*, size_t);
+    typedef bool (*jadro_liczby)(const int*, int, int*, size_t);
+
+    static matrix wykonaj(const matrix& a, const matrix& b, jadro_macierzy j, const char* nazwa);
+    static matrix wykonaj(const matrix& a, int x, jadro_liczby j, const char* nazwa);
+    static matrix& wykonaj_w_miejscu(matrix& a, int x, jadro_liczby j, const char* nazwa);
+};
+
+/**
+ * @class macierz_z_polityka
+ * @brief Macierz, której operatory stosują politykę przepełnienia P.
+ *
+ * Przechowuje zwykłą macierz (kopia współdzieli bufor do pierwszego zapisu), więc
+ * przejście między typami nie kopiuje elementów.
+ *
+ * @tparam P Polityka przepełnienia (zawijanie, nasycanie, sprawdzanie).
+ */
+template <class P>
+class macierz_z_polityka {
+private:
+    matrix m; ///< Elementy
+
+public:
+    typedef P polityka; ///< Polityka przepełnienia
+
+    /**
+     * @brief Tworzy macierz z polityką P z macierzy klasy matrix.
+     * @param m Macierz źródłowa.
+     */
+    explicit macierz_z_polityka(const matrix& m) : m(m) {}
+
+    /**
+     * @brief Zwraca przechowywaną macierz (kopia współdzieli bufor).
+     * @return Macierz.
+     */
+    matrix macierz() const { return m; }
+
+    /**
+     * @brief Suma elementami.
+     * @param b Druga macierz.
+     * @return Nowa macierz.
+     */
+    macierz_z_polityka operator+(const macierz_z_polityka& b) const {
+        return macierz_z_polityka(arytmetyka::suma<P>(m, b.m));
+    }
+
+    /**
+     * @brief Iloczyn elementami.
+     * @param b Druga macierz.
+     * @return Nowa macierz.
+     */
+    macierz_z_polityka operator*(const macierz_z_polityka& b) const {
+        return macierz_z_polityka(arytmetyka::iloczyn_elementow<P>(m, b.m));
+    }
+
+    /**
+     * @brief Dodaje liczbę do każdego elementu.
+     * @param x Liczba.
+     * @return Nowa macierz.
+     */
+    macierz_z_polityka operator+(int x) const {
+        return macierz_z_polityka(arytmetyka::suma<P>(m, x));
+    }
+
+    /**
+     * @brief Odejmuje liczbę od każdego elementu.
+     * @param x Liczba.
+     * @return Nowa macierz.
+     */
+    macierz_z_polityka operator-(int x) const {
+        return macierz_z_polityka(arytmetyka::roznica<P>(m, x));
+    }
+
+    /**
+     * @brief Mnoży każdy element przez liczbę.
+     * @param x Liczba.
+     * @return Nowa macierz.
+     */
+    macierz_z_polityka operator*(int x) const {
+        return macierz_z_polityka(arytmetyka::iloczyn<P>(m, x));
+    }
+
+    /**
+     * @brief Dodaje liczbę do każdego elementu w miejscu.
+     * @param x Liczba.
+     * @return Referencja do bieżącej macierzy.
+     */
+    macierz_z_polityka& operator+=(int x) {
+        arytmetyka::dodaj<P>(m, x);
+        return *this;
+    }
+
+    /**
+     * @brief Odejmuje liczbę od każdego elementu w miejscu.
+     * @param x Liczba.
+     * @return Referencja do bieżącej macierzy.
+     */
+    macierz_z_polityka& operator-=(int x) {
+        arytmetyka::odejmij<P>(m, x);
+        return *this;
+    }
+
+    /**
+     * @brief Mnoży każdy element przez liczbę w miejscu.
+     * @param x Liczba.
+     * @return Referencja do bieżącej macierzy.
+     */
+    macierz_z_polityka& operator*=(int x) {
+        arytmetyka::pomnoz<P>(m, x);
+        return *this;
+    }
+
+    /**
+     * @brief Zwiększa każdy element o 1 w miejscu.
+     * @return Referencja do bieżącej macierzy.
+     */
+    macierz_z_polityka& operator++(int) {
+        arytmetyka::dodaj<P>(m, 1);
+        return *this;
+    }
+};
+
+#endif // !ARYTMETYKA_H
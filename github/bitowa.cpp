@@ -0,0 +1,373 @@
+/**
+ * @file bitowa.cpp
+ * @brief Implementacja macierzy logicznej upakowanej po 64 elementy w słowie.
+ */
+
+#include "bitowa.h"
+#include "watki.h"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Transponuje blok 64 x 64 bitów w miejscu.
+ *
+ * Bit j słowa r to element (r, j). W kolejnych krokach zamieniane są ćwiartki
+ * 32 x 32, 16 x 16, ..., 1 x 1 leżące poza przekątną (Hacker's Delight, 7-3).
+ *
+ * @param a 64 słowa bloku.
+ */
+static void transponuj_blok(uint64_t* a) {
+	uint64_t m = 0x00000000FFFFFFFFULL;
+	for (int j = 32; j != 0; j >>= 1, m ^= m << j) {
+		for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+			uint64_t t = ((a[k] >> j) ^ a[k | j]) & m;
+			a[k] ^= t << j;
+			a[k | j] ^= t;
+		}
+	}
+}
+
+/**
+ * @brief Konstruktor tworzący macierz wypełnioną zerami.
+ * @param size Rozmiar macierzy.
+ */
+macierz_bitowa::macierz_bitowa(int size) : n(size > 0 ? size : 0), slowa((n + 63) / 64), bity((size_t)n * slowa, 0) {}
+
+/**
+ * @brief Maska bitów należących do macierzy w ostatnim słowie wiersza.
+ * @return Maska.
+ */
+uint64_t macierz_bitowa::maska_konca() const {
+	return n % 64 == 0 ? ~0ULL : (1ULL << (n % 64)) - 1;
+}
+
+/**
+ * @brief Tworzy macierz bitową z macierzy.
+ *
+ * Słowo jest składane bez rozgałęzień z 64 porównań z zerem; wiersze są dzielone
+ * między wątki puli.
+ *
+ * @param m Macierz źródłowa.
+ * @return Macierz bitowa.
+ */
+macierz_bitowa macierz_bitowa::z_macierzy(const matrix& m) {
+	macierz_bitowa w(m.n);
+	int n = w.n;
+	int slowa = w.slowa;
+	uint64_t* bity = w.bity.data();
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			const int* wiersz = m.data[i];
+			uint64_t* cel = bity + (size_t)i * slowa;
+			for (int s = 0; s < slowa; s++) {
+				int koniec = min(64, n - s * 64);
+				const int* e = wiersz + s * 64;
+				uint64_t slowo = 0;
+				for (int b = 0; b < koniec; b++) {
+					slowo |= (uint64_t)(e[b] != 0) << b;
+				}
+				cel[s] = slowo;
+			}
+		}
+	});
+	return w;
+}
+
+/**
+ * @brief Przepisuje macierz do klasy matrix.
+ * @return Nowa macierz z wartościami 0 i 1.
+ */
+matrix macierz_bitowa::do_macierzy() const {
+	matrix m(n);
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			const uint64_t* zrodlo = wiersz(i);
+			int* cel = m.data[i];
+			for (int j = 0; j < n; j++) {
+				cel[j] = (int)((zrodlo[j >> 6] >> (j & 63)) & 1);
+			}
+		}
+	});
+	return m;
+}
+
+int macierz_bitowa::rozmiar() const {
+	return n;
+}
+
+/**
+ * @brief Ustawia element.
+ * @param x Indeks wiersza.
+ * @param y Indeks kolumny.
+ * @param wartosc Nowa wartość.
+ * @return Referencja do macierzy.
+ */
+macierz_bitowa& macierz_bitowa::wstaw(int x, int y, bool wartosc) {
+	if (x >= 0 && x < n && y >= 0 && y < n) {
+		uint64_t& slowo = bity[(size_t)x * slowa + (y >> 6)];
+		uint64_t bit = 1ULL << (y & 63);
+		slowo = wartosc ? slowo | bit : slowo & ~bit;
+	}
+	return *this;
+}
+
+/**
+ * @brief Pobiera element.
+ * @param x Indeks wiersza.
+ * @param y Indeks kolumny.
+ * @return Wartość lub false poza zakresem.
+ */
+bool macierz_bitowa::pokaz(int x, int y) const {
+	if (x >= 0 && x < n && y >= 0 && y < n) {
+		return (bity[(size_t)x * slowa + (y >> 6)] >> (y & 63)) & 1;
+	}
+	return false;
+}
+
+const uint64_t* macierz_bitowa::wiersz(int i) const {
+	return bity.data() + (size_t)i * slowa;
+}
+
+/**
+ * @brief Koniunkcja element po elemencie.
+ * @param m Druga macierz.
+ * @return Nowa macierz.
+ * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+ */
+macierz_bitowa macierz_bitowa::operator&(const macierz_bitowa& m) const {
+	if (n != m.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	macierz_bitowa w(n);
+	for (size_t i = 0; i < bity.size(); i++) {
+		w.bity[i] = bity[i] & m.bity[i];
+	}
+	return w;
+}
+
+/**
+ * @brief Alternatywa element po elemencie.
+ * @param m Druga macierz.
+ * @return Nowa macierz.
+ * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+ */
+macierz_bitowa macierz_bitowa::operator|(const macierz_bitowa& m) const {
+	if (n != m.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	macierz_bitowa w(n);
+	for (size_t i = 0; i < bity.size(); i++) {
+		w.bity[i] = bity[i] | m.bity[i];
+	}
+	return w;
+}
+
+/**
+ * @brief Różnica symetryczna element po elemencie.
+ * @param m Druga macierz.
+ * @return Nowa macierz.
+ * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+ */
+macierz_bitowa macierz_bitowa::operator^(const macierz_bitowa& m) const {
+	if (n != m.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	macierz_bitowa w(n);
+	for (size_t i = 0; i < bity.size(); i++) {
+		w.bity[i] = bity[i] ^ m.bity[i];
+	}
+	return w;
+}
+
+/**
+ * @brief Negacja każdego elementu.
+ *
+ * Bity poza macierzą w ostatnim słowie wiersza pozostają zerowe.
+ *
+ * @return Nowa macierz.
+ */
+macierz_bitowa macierz_bitowa::operator~() const {
+	macierz_bitowa w(n);
+	uint64_t koniec = maska_konca();
+	for (int i = 0; i < n; i++) {
+		for (int s = 0; s < slowa; s++) {
+			size_t k = (size_t)i * slowa + s;
+			w.bity[k] = ~bity[k] & (s == slowa - 1 ? koniec : ~0ULL);
+		}
+	}
+	return w;
+}
+
+macierz_bitowa macierz_bitowa::operator*(const macierz_bitowa& m) const {
+	return *this & m;
+}
+
+macierz_bitowa macierz_bitowa::operator+(const macierz_bitowa& m) const {
+	return *this | m;
+}
+
+/**
+ * @brief Porównuje dwie macierze.
+ * @param m Macierz do porównania.
+ * @return True, jeśli macierze są równe.
+ */
+bool macierz_bitowa::operator==(const macierz_bitowa& m) const {
+	return n == m.n && bity == m.bity;
+}
+
+/**
+ * @brief Transpozycja.
+ *
+ * Blok słów (bi, bj) - 64 wiersze od 64 * bi, słowo bj - jest transponowany
+ * i zapisywany jako blok (bj, bi). Wiersze bloków są dzielone między wątki puli.
+ *
+ * @return Referencja do macierzy.
+ */
+macierz_bitowa& macierz_bitowa::odwroc() {
+	vector<uint64_t> wynik(bity.size(), 0);
+	const uint64_t* zrodlo = bity.data();
+	uint64_t* cel = wynik.data();
+	int n = this->n;
+	int slowa = this->slowa;
+	pula_watkow::globalna().rownolegle(slowa, [=](int od, int do_, int) {
+		uint64_t blok[64];
+		for (int bi = od; bi < do_; bi++) {
+			for (int bj = 0; bj < slowa; bj++) {
+				for (int r = 0; r < 64; r++) {
+					int i = bi * 64 + r;
+					blok[r] = i < n ? zrodlo[(size_t)i * slowa + bj] : 0;
+				}
+				transponuj_blok(blok);
+				for (int r = 0; r < 64; r++) {
+					int i = bj * 64 + r;
+					if (i < n) {
+						cel[(size_t)i * slowa + bi] = blok[r];
+					}
+				}
+			}
+		}
+	}, 2);
+	bity.swap(wynik);
+	return *this;
+}
+
+/**
+ * @brief Liczba jedynek w macierzy.
+ * @return Liczba ustawionych elementów.
+ */
+long long macierz_bitowa::liczba() const {
+	long long s = 0;
+	for (size_t i = 0; i < bity.size(); i++) {
+		s += popcount(bity[i]);
+	}
+	return s;
+}
+
+/**
+ * @brief Liczba jedynek w każdym wierszu.
+ * @return Wektor n liczników.
+ */
+vector<int> macierz_bitowa::sumy_wierszy() const {
+	vector<int> wynik(n, 0);
+	for (int i = 0; i < n; i++) {
+		const uint64_t* w = wiersz(i);
+		int s = 0;
+		for (int k = 0; k < slowa; k++) {
+			s += popcount(w[k]);
+		}
+		wynik[i] = s;
+	}
+	return wynik;
+}
+
+/**
+ * @brief Liczba jedynek w każdej kolumnie (sumy wierszy macierzy transponowanej).
+ * @return Wektor n liczników.
+ */
+vector<int> macierz_bitowa::sumy_kolumn() const {
+	macierz_bitowa t(*this);
+	t.odwroc();
+	return t.sumy_wierszy();
+}
+
+/**
+ * @brief Iloczyn logiczny metodą czterech Rosjan.
+ *
+ * Wiersze prawego czynnika są brane grupami po 8. Dla grupy budowana jest tablica
+ * 256 alternatyw wszystkich podzbiorów jej wierszy (każdy wpis z poprzedniego jednym OR),
+ * a następnie do wiersza i wyniku dodawany jest wpis wskazany przez 8 bitów wiersza i
+ * lewego czynnika. Zamiast n operacji na wiersz wyniku wykonywanych jest n / 8.
+ *
+ * @param m Prawy czynnik.
+ * @return Nowa macierz.
+ * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+ */
+macierz_bitowa macierz_bitowa::iloczyn(const macierz_bitowa& m) const {
+	if (n != m.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	macierz_bitowa w(n);
+	vector<uint64_t> tablica((size_t)256 * slowa, 0);
+	for (int k0 = 0; k0 < n; k0 += 8) {
+		int liczba_k = min(8, n - k0);
+		for (int x = 1; x < (1 << liczba_k); x++) {
+			const uint64_t* poprzedni = tablica.data() + (size_t)(x & (x - 1)) * slowa;
+			const uint64_t* dodany = m.wiersz(k0 + countr_zero((unsigned int)x));
+			uint64_t* wpis = tablica.data() + (size_t)x * slowa;
+			for (int s = 0; s < slowa; s++) {
+				wpis[s] = poprzedni[s] | dodany[s];
+			}
+		}
+		const uint64_t* t = tablica.data();
+		pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+			for (int i = od; i < do_; i++) {
+				unsigned int indeks = (unsigned int)(wiersz(i)[k0 >> 6] >> (k0 & 63)) & 0xff;
+				if (indeks) {
+					const uint64_t* wpis = t + (size_t)indeks * slowa;
+					uint64_t* cel = w.bity.data() + (size_t)i * slowa;
+					for (int s = 0; s < slowa; s++) {
+						cel[s] |= wpis[s];
+					}
+				}
+			}
+		});
+	}
+	return w;
+}
+
+/**
+ * @brief Iloczyn liczbowy macierzy 0/1.
+ *
+ * Prawy czynnik jest transponowany, a element (i, j) to suma popcount koniunkcji
+ * słów wiersza i i wiersza j transpozycji - 64 mnożenia i dodawania na instrukcję.
+ *
+ * @param m Prawy czynnik.
+ * @return Macierz liczników.
+ * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+ */
+matrix macierz_bitowa::iloczyn_liczbowy(const macierz_bitowa& m) const {
+	if (n != m.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	macierz_bitowa t(m);
+	t.odwroc();
+	matrix wynik(n);
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			const uint64_t* a = wiersz(i);
+			int* cel = wynik.data[i];
+			for (int j = 0; j < n; j++) {
+				const uint64_t* b = t.wiersz(j);
+				int s = 0;
+				for (int k = 0; k < slowa; k++) {
+					s += popcount(a[k] & b[k]);
+				}
+				cel[j] = s;
+			}
+		}
+	}, 16);
+	return wynik;
+}
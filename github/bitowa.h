@@ -0,0 +1,171 @@
+#pragma once
+#ifndef BITOWA_H
+#define BITOWA_H
+
+#include "matrix.h"
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+/**
+ * @class macierz_bitowa
+ * @brief Macierz logiczna n x n przechowująca 64 elementy w jednym słowie.
+ *
+ * Wiersz zajmuje (n + 63) / 64 słów; kolumna j leży w bicie j % 64 słowa j / 64.
+ * Bity poza macierzą są zawsze zerowe. Zajmuje 32 razy mniej pamięci niż matrix
+ * z wartościami 0/1, a operacje przetwarzają 64 elementy naraz.
+ */
+class macierz_bitowa {
+private:
+    int n; ///< Rozmiar macierzy (n x n)
+    int slowa; ///< Liczba słów w wierszu
+    vector<uint64_t> bity; ///< Wiersze macierzy (po slowa słów)
+
+    uint64_t maska_konca() const;
+
+public:
+    /**
+     * @brief Konstruktor tworzący macierz wypełnioną zerami.
+     * @param size Rozmiar macierzy.
+     */
+    explicit macierz_bitowa(int size = 0);
+
+    /**
+     * @brief Tworzy macierz bitową z macierzy (element różny od zera -> 1).
+     * @param m Macierz źródłowa.
+     * @return Macierz bitowa.
+     */
+    static macierz_bitowa z_macierzy(const matrix& m);
+
+    /**
+     * @brief Przepisuje macierz do klasy matrix (wartości 0 i 1).
+     * @return Nowa macierz.
+     */
+    matrix do_macierzy() const;
+
+    /**
+     * @brief Zwraca rozmiar macierzy.
+     * @return Rozmiar n.
+     */
+    int rozmiar() const;
+
+    /**
+     * @brief Ustawia element (poza zakresem nic nie robi).
+     * @param x Indeks wiersza.
+     * @param y Indeks kolumny.
+     * @param wartosc Nowa wartość.
+     * @return Referencja do macierzy.
+     */
+    macierz_bitowa& wstaw(int x, int y, bool wartosc);
+
+    /**
+     * @brief Pobiera element.
+     * @param x Indeks wiersza.
+     * @param y Indeks kolumny.
+     * @return Wartość lub false poza zakresem.
+     */
+    bool pokaz(int x, int y) const;
+
+    /**
+     * @brief Zwraca wskaźnik na słowa wiersza.
+     * @param i Indeks wiersza.
+     * @return Wskaźnik na (n + 63) / 64 słów.
+     */
+    const uint64_t* wiersz(int i) const;
+
+    /**
+     * @brief Koniunkcja element po elemencie.
+     * @param m Druga macierz.
+     * @return Nowa macierz.
+     * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+     */
+    macierz_bitowa operator&(const macierz_bitowa& m) const;
+
+    /**
+     * @brief Alternatywa element po elemencie.
+     * @param m Druga macierz.
+     * @return Nowa macierz.
+     * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+     */
+    macierz_bitowa operator|(const macierz_bitowa& m) const;
+
+    /**
+     * @brief Różnica symetryczna element po elemencie.
+     * @param m Druga macierz.
+     * @return Nowa macierz.
+     * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+     */
+    macierz_bitowa operator^(const macierz_bitowa& m) const;
+
+    /**
+     * @brief Negacja każdego elementu.
+     * @return Nowa macierz.
+     */
+    macierz_bitowa operator~() const;
+
+    /**
+     * @brief Iloczyn element po elemencie (odpowiednik matrix::operator* dla 0/1, czyli AND).
+     * @param m Druga macierz.
+     * @return Nowa macierz.
+     */
+    macierz_bitowa operator*(const macierz_bitowa& m) const;
+
+    /**
+     * @brief Suma logiczna element po elemencie (odpowiednik matrix::operator+ z nasyceniem, czyli OR).
+     * @param m Druga macierz.
+     * @return Nowa macierz.
+     */
+    macierz_bitowa operator+(const macierz_bitowa& m) const;
+
+    /**
+     * @brief Porównuje dwie macierze.
+     * @param m Macierz do porównania.
+     * @return True, jeśli macierze są równe.
+     */
+    bool operator==(const macierz_bitowa& m) const;
+
+    /**
+     * @brief Transpozycja (bloki 64 x 64 transponowane przestawieniami bitów).
+     * @return Referencja do macierzy.
+     */
+    macierz_bitowa& odwroc();
+
+    /**
+     * @brief Liczba jedynek w macierzy.
+     * @return Liczba ustawionych elementów.
+     */
+    long long liczba() const;
+
+    /**
+     * @brief Liczba jedynek w każdym wierszu.
+     * @return Wektor n liczników.
+     */
+    vector<int> sumy_wierszy() const;
+
+    /**
+     * @brief Liczba jedynek w każdej kolumnie.
+     * @return Wektor n liczników.
+     */
+    vector<int> sumy_kolumn() const;
+
+    /**
+     * @brief Iloczyn logiczny (AND-OR) metodą czterech Rosjan.
+     * @param m Prawy czynnik.
+     * @return Nowa macierz: wynik[i][j] = OR_k (a[i][k] AND m[k][j]).
+     * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+     */
+    macierz_bitowa iloczyn(const macierz_bitowa& m) const;
+
+    /**
+     * @brief Iloczyn liczbowy macierzy 0/1 (liczba ścieżek długości 2).
+     *
+     * Element (i, j) to liczba jedynek w koniunkcji wiersza i z kolumną j prawego czynnika.
+     *
+     * @param m Prawy czynnik.
+     * @return Macierz liczników (równa iloczynowi do_macierzy() obu czynników).
+     * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+     */
+    matrix iloczyn_liczbowy(const macierz_bitowa& m) const;
+};
+
+#endif // !BITOWA_H
@@ -4,19 +4,85 @@
  */
 
 #include "matrix.h"
+#include "lu.h"
+#include "graf.h"
+#include "wektor.h"
+#include "pamiec.h"
+#include "maska.h"
+#include "ulozenie.h"
+#include "numa.h"
+#include "watki.h"
+#include "rozproszona.h"
+#include "strumien.h"
+#include "bitowa.h"
+#include "kompresja.h"
+#include "strojenie.h"
+#include "wspolbiezna.h"
+#include "sledzenie.h"
+#include "redukcja.h"
+#include "arytmetyka.h"
+#include <chrono>
 #include <iostream>
+#include <vector>
+#include <memory>
+#include <sstream>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <climits>
+#include <stdexcept>
+#include <string>
 
 using namespace std;
 
+/**
+ * @brief Pomiar potęgowania macierzy dla rozmiarów 256...2048.
+ *
+ * Dla każdego rozmiaru mierzy potęgę 10^9 modulo 1000000007 losowej macierzy oraz
+ * sprawdza wynik dla k = 5 z kolejnymi iloczynami. Dla n = 2048 pomiar trwa minuty,
+ * dlatego jest uruchamiany osobno (`github potega`), a nie w teście 11.
+ */
+static void pomiar_potegi() {
+    cout << "----------------Pomiar: Potegowanie macierzy----------------------------" << endl;
+    for (int n = 256; n <= 2048; n *= 2) {
+        matrix a(n);
+        a.losuj();
+        matrix kolejno(a);
+        for (int i = 1; i < 5; i++) {
+            kolejno = kolejno.iloczyn(a);
+        }
+        matrix piata(a);
+        piata.potega(5);
+        matrix duza(a);
+        auto start = chrono::steady_clock::now();
+        duza.potega(1000000000LL, 1000000007);
+        auto czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "n = " << n << ": potega 10^9 (mod 1000000007) " << czas.count() << " ms"
+            << ", potega 5 zgodna z iloczynami? " << (piata == kolejno ? "Tak" : "Nie") << endl;
+    }
+}
+
 /**
  * @brief Funkcja główna programu.
  *
  * Testuje różne funkcje i operacje na klasie matrix, takie jak tworzenie macierzy,
- * wstawianie wartości, operacje matematyczne i inne.
+ * wstawianie wartości, operacje matematyczne i inne. Wywołany z argumentem `potega`
+ * wykonuje tylko pomiar potęgowania dla rozmiarów 256...2048.
  *
+ * @param argc Liczba argumentów.
+ * @param argv Argumenty.
  * @return int Zwraca 0, jeśli program zakończył się poprawnie.
  */
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "potega") {
+        pomiar_potegi();
+        return 0;
+    }
+
     /**
      * @brief Test 1: Tworzenie i wyświetlenie macierzy.
      *
@@ -161,5 +227,1049 @@ int main() {
     cout << "----------------Test 10: Szachownica----------------------------" << endl;
     m1.szachownica();
 
+    /**
+     * @brief Test 11: Potęgowanie macierzy.
+     *
+     * Zlicza ścieżki w grafie przez potęgowanie macierzy sąsiedztwa, liczy liczbę Fibonacciego
+     * modulo 1000000007 dla bardzo dużego wykładnika i mierzy czas potęgowania większej macierzy
+     * (pomiar dla rozmiarów do 2048: `github potega`).
+     * Sprawdza też, że wyjątek z fragmentu zadania puli wątków trafia do wywołującego.
+     */
+    cout << "----------------Test 11: Potegowanie macierzy----------------------------" << endl;
+    int sasiedztwo[] = { 0, 1, 1, 1, 0, 1, 1, 1, 0 };
+    matrix graf(3, sasiedztwo);
+    graf.potega(4);
+    cout << "Liczba sciezek dlugosci 4 w trojkacie:" << endl;
+    cout << graf << endl;
+
+    int fib[] = { 1, 1, 1, 0 };
+    matrix f(2, fib);
+    f.potega(1000000000LL, 1000000007);
+    cout << "F(10^9) mod 1000000007 = " << f.pokaz(0, 1) << endl;
+
+    matrix duza(256);
+    duza.losuj();
+    auto start = chrono::steady_clock::now();
+    duza.potega(1000000000LL, 1000000007);
+    auto czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+    cout << "Potega 10^9 macierzy 256x256 (mod 1000000007): " << czas.count() << " ms" << endl;
+
+    bool zgloszony = false;
+    try {
+        pula_watkow::globalna().rownolegle(1000, [](int, int, int watek) {
+            if (watek == pula_watkow::globalna().liczba_watkow() - 1) {
+                throw runtime_error("Task failed");
+            }
+        }, 1);
+    }
+    catch (const runtime_error&) {
+        zgloszony = true;
+    }
+    matrix po_bledzie(256);
+    po_bledzie.alokuj(256);
+    po_bledzie += 1;
+    cout << "Wyjatek z zadania puli przekazany? " << (zgloszony ? "Tak" : "Nie")
+        << ", pula dziala dalej? " << (po_bledzie.pokaz(255, 255) == 1 ? "Tak" : "Nie") << endl;
+
+    /**
+     * @brief Test 12: Wyznacznik, układ równań i macierz odwrotna.
+     *
+     * Liczy dokładny wyznacznik metodą Bareissa, rozwiązuje układ równań z dwiema prawymi
+     * stronami i wyznacza macierz odwrotną, a na końcu mierzy czas rozkładu LU macierzy 512, 1024 i 2048.
+     */
+    cout << "----------------Test 12: Wyznacznik, uklad rownan i odwrotnosc----------------" << endl;
+    int elementy[] = { 2, 1, 1, 4, -6, 0, -2, 7, 2 };
+    matrix a(3, elementy);
+    cout << "Macierz a:" << endl;
+    cout << a << endl;
+    cout << "Wyznacznik (Bareiss): " << a.wyznacznik() << endl;
+
+    rozklad_lu lu(a);
+    cout << "Wyznacznik (LU): " << lu.wyznacznik() << endl;
+
+    double prawe[] = { 5, 1, -2, 2, 9, 3 };
+    lu.rozwiaz(prawe, 2);
+    cout << "Rozwiazania ax = b dla dwoch prawych stron:" << endl;
+    for (int i = 0; i < 3; i++) {
+        cout << prawe[i * 2] << " " << prawe[i * 2 + 1] << endl;
+    }
+
+    vector<double> odwrotna = lu.odwrotna();
+    cout << "Macierz odwrotna:" << endl;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            cout << odwrotna[i * 3 + j] << " ";
+        }
+        cout << endl;
+    }
+
+    for (int rozmiar_lu : { 512, 1024, 2048 }) {
+        matrix b(rozmiar_lu);
+        b.losuj();
+        start = chrono::steady_clock::now();
+        rozklad_lu lu_b(b);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "Rozklad LU macierzy " << rozmiar_lu << "x" << rozmiar_lu << ": " << czas.count() << " ms" << endl;
+    }
+    cout << endl;
+
+    /**
+     * @brief Test 13: Asynchroniczny graf operacji.
+     *
+     * Buduje graf: wypełnienia, transpozycja, suma, połączony potok
+     * element po elemencie i porównanie. Wątek główny tylko dodaje węzły, a następnie
+     * czeka na wynik i wypisuje graf w formacie DOT. Na koniec sprawdza, że wyjątek
+     * zgłoszony przez etap potoku trafia do przyszłości węzła i jego następnika.
+     */
+    cout << "----------------Test 13: Asynchroniczny graf operacji----------------------------" << endl;
+    {
+        graf_zadan graf_op;
+        matrix x(4), y(4), suma(4), potok(4);
+        bool rowne = false;
+        graf_zadan::uchwyt wx = graf_op.wypelnij(x);
+        graf_zadan::uchwyt wy = graf_op.wypelnij(y, { wx });
+        graf_zadan::uchwyt tx = graf_op.transponuj(x, { wx });
+        graf_zadan::uchwyt s = graf_op.dodaj_macierze(x, y, suma, { tx, wy });
+        graf_zadan::uchwyt p = graf_op.potok(suma, potok,
+            { graf_zadan::etap_dodaj(1), graf_zadan::etap_mnoz(2), graf_zadan::etap_dodaj(y) }, { s });
+        graf_zadan::uchwyt c = graf_op.porownaj(suma, potok, rowne, { p });
+        graf_op.czekaj(c);
+        cout << "Suma x^T + y:" << endl;
+        cout << suma << endl;
+        cout << "Potok 2 * (suma + 1) + y:" << endl;
+        cout << potok << endl;
+        cout << "Czy suma == potok? " << (rowne ? "Tak" : "Nie") << endl;
+        cout << graf_op.eksportuj_dot() << endl;
+
+        matrix duza(256), wynik_bledu;
+        duza.losuj();
+        graf_zadan::etap zly = [](int*, int i, int) {
+            if (i == 200) {
+                throw runtime_error("etap");
+            }
+        };
+        graf_zadan::uchwyt b = graf_op.potok(duza, wynik_bledu, { graf_zadan::etap_dodaj(1), zly });
+        graf_zadan::uchwyt po = graf_op.porownaj(duza, wynik_bledu, rowne, { b });
+        bool blad_potoku = false, blad_nastepnika = false;
+        try {
+            graf_op.czekaj(b);
+        }
+        catch (const runtime_error&) {
+            blad_potoku = true;
+        }
+        try {
+            graf_op.czekaj(po);
+        }
+        catch (const runtime_error&) {
+            blad_nastepnika = true;
+        }
+        cout << "Wyjatek etapu potoku przekazany? " << (blad_potoku ? "Tak" : "Nie")
+            << ", nastepnik pominiety? " << (blad_nastepnika ? "Tak" : "Nie") << endl;
+    }
+
+    /**
+     * @brief Test 14: Kopiowanie przy zapisie.
+     *
+     * Kopiuje dużą macierz, sprawdza współdzielenie bufora przed i po modyfikacji
+     * oraz porównuje czas kopii współdzielonej i głębokiej.
+     */
+    cout << "----------------Test 14: Kopiowanie przy zapisie----------------------------" << endl;
+    {
+        matrix oryginal(2048);
+        oryginal.losuj();
+        start = chrono::steady_clock::now();
+        matrix kopia(oryginal);
+        auto czas_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+        cout << "Kopia wspoldzielona 2048x2048: " << czas_us.count() << " us" << endl;
+        cout << "Czy bufor wspoldzielony? " << (kopia.wspoldzielona() ? "Tak" : "Nie") << endl;
+        kopia.wstaw(0, 0, oryginal.pokaz(0, 0) + 1);
+        cout << "Po wstaw: czy bufor wspoldzielony? " << (kopia.wspoldzielona() ? "Tak" : "Nie") << endl;
+        cout << "Czy oryginal == kopia? " << (oryginal == kopia ? "Tak" : "Nie") << endl;
+
+        matrix::wspoldzielenie(false);
+        start = chrono::steady_clock::now();
+        matrix gleboka(oryginal);
+        czas_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+        matrix::wspoldzielenie(true);
+        cout << "Kopia gleboka 2048x2048: " << czas_us.count() << " us" << endl << endl;
+    }
+
+    /**
+     * @brief Test 15: Operacje macierz-wektor.
+     *
+     * Mnoży macierz przez wektor (także transponowaną i dla paczki wektorów),
+     * wykonuje aktualizację rzędu 1 oraz operacje axpy, dot i skalowanie.
+     */
+    cout << "----------------Test 15: Operacje macierz-wektor----------------------------" << endl;
+    {
+        int elementy_a[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+        int elementy_x[] = { 1, 0, -1 };
+        matrix a(3, elementy_a);
+        wektor x(3, elementy_x), y(3);
+        blas::gemv(1, a, x, 0, y);
+        cout << "A * x: " << y;
+        blas::gemv_t(1, a, x, 0, y);
+        cout << "A^T * x: " << y;
+
+        vector<wektor> paczka(2, x), wyniki(2, wektor(3));
+        paczka[1].wstaw(1, 1);
+        blas::gemv(2, a, paczka, 0, wyniki);
+        cout << "2 * A * x dla paczki dwoch wektorow:" << endl << wyniki[0] << wyniki[1];
+
+        blas::ger(1, x, x, a);
+        cout << "A + x * x^T:" << endl << a << endl;
+
+        blas::axpy(3, x, y);
+        cout << "3 * x + y: " << y;
+        cout << "x . y = " << blas::dot(x, y) << endl;
+        blas::skaluj(-1, y);
+        cout << "-y: " << y << endl;
+    }
+
+    /**
+     * @brief Test 16: Pamięć podręczna wyników.
+     *
+     * Powtarza te same operacje na niezmienionych macierzach, modyfikuje argument
+     * i wypisuje statystyki trafień oraz czasy pierwszego i kolejnego wywołania.
+     * Sprawdza też trafienie dla równej kopii argumentu, której elementy są porównywane
+     * z argumentem zapamiętanym we wpisie.
+     */
+    cout << "----------------Test 16: Pamiec podreczna wynikow----------------------------" << endl;
+    {
+        pamiec_wynikow pamiec(64 << 20);
+        matrix p(512), q(512);
+        p.losuj();
+        q.losuj();
+        start = chrono::steady_clock::now();
+        matrix pq = pamiec.iloczyn(p, q);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "Pierwsze iloczyn(p, q) 512x512: " << czas.count() << " ms" << endl;
+        start = chrono::steady_clock::now();
+        matrix pq2 = pamiec.iloczyn(p, q);
+        auto czas_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+        cout << "Powtorne iloczyn(p, q): " << czas_us.count() << " us" << endl;
+        cout << "Czy wyniki rowne? " << (pq == pq2 ? "Tak" : "Nie") << endl;
+
+        pamiec.suma(p, q);
+        pamiec.suma(p, q);
+        p.wstaw(0, 0, p.pokaz(0, 0) + 1);
+        matrix po_zmianie = pamiec.suma(p, q);
+        cout << "Suma po wstaw uwzglednia zmiane? " << (po_zmianie.pokaz(0, 0) == p.pokaz(0, 0) + q.pokaz(0, 0) ? "Tak" : "Nie") << endl;
+
+        matrix q_kopia(q);
+        q_kopia.wstaw(0, 0, q.pokaz(0, 0));
+        unsigned long long trafienia = pamiec.stat().trafienia;
+        matrix z_kopii = pamiec.suma(p, q_kopia);
+        cout << "Trafienie dla rownej kopii argumentu (osobny bufor)? "
+            << (pamiec.stat().trafienia == trafienia + 1 && z_kopii == po_zmianie ? "Tak" : "Nie") << endl;
+
+        pamiec_wynikow::statystyki st = pamiec.stat();
+        cout << "Trafienia: " << st.trafienia << ", chybienia: " << st.chybienia << ", wpisy: " << st.wpisy
+            << ", bajty: " << st.bajty << endl << endl;
+    }
+
+    /**
+     * @brief Test 17: Operacje maskowane.
+     *
+     * Tworzy macierz szachownicy jako wynik (zamiast wypisywania), wybiera elementy
+     * trójkąta dolnego, dodaje skalar w paśmie i liczy sumy oraz ekstrema maskowane.
+     */
+    cout << "----------------Test 17: Operacje maskowane----------------------------" << endl;
+    {
+        int elementy_m[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+        matrix m(4, elementy_m);
+        cout << "Szachownica jako macierz:" << endl;
+        cout << maska::gdzie(maska::szachownica(4), m, 0) << endl;
+        cout << "Trojkat dolny z m, reszta z -m:" << endl;
+        matrix minus_m(m);
+        minus_m *= -1;
+        cout << maska::gdzie(maska::trojkat_dolny(4), m, minus_m) << endl;
+
+        maska::dodaj(m, maska::pasmo(4, 1, 1), 100);
+        cout << "m po dodaniu 100 w pasmie trojprzekatniowym:" << endl;
+        cout << m << endl;
+
+        maska parzyste = maska::z_predykatu(4, [](int i, int j) { return (i * 4 + j) % 2 == 0; });
+        cout << "Suma nad przekatna: " << maska::suma(m, maska::trojkat_gorny(4, false)) << endl;
+        cout << "Minimum i maksimum na szachownicy: " << maska::minimum(m, maska::szachownica(4))
+            << " " << maska::maksimum(m, maska::szachownica(4)) << endl;
+        cout << "Liczba elementow o parzystym indeksie poza pasmem: "
+            << (parzyste & ~maska::pasmo(4, 1, 1)).liczba() << endl << endl;
+    }
+
+
+    /**
+     * @brief Test 18: Ułożenia pamięci.
+     *
+     * Przepisuje losową macierz do ułożenia wierszami, kolumnami i kaflowego (Morton),
+     * sprawdza zgodność iloczynu i transpozycji z klasą matrix oraz mierzy czas
+     * sumowania kolumn, transpozycji i mnożenia w każdym ułożeniu.
+     */
+    cout << "----------------Test 18: Ulozenia pamieci------------------------------" << endl;
+    {
+        const int n = 512;
+        matrix a(n), b(n);
+        a.losuj();
+        b.losuj();
+        matrix c = a.iloczyn(b);
+        matrix at(a);
+        at.odwroc();
+
+        auto pomiar = [&](auto wa, auto wb) {
+            cout << decltype(wa)::ulozenie::nazwa() << ":" << endl;
+            start = chrono::steady_clock::now();
+            long long s = 0;
+            for (int j = 0; j < n; j++) {
+                s += wa.suma_kolumny(j);
+            }
+            auto czas_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+            cout << "  sumy kolumn: " << czas_us.count() << " us (suma " << s << ")" << endl;
+
+            auto wc = wa.iloczyn(wb);
+            start = chrono::steady_clock::now();
+            wc = wa.iloczyn(wb);
+            czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+            cout << "  iloczyn: " << czas.count() << " ms, zgodny z matrix? " << (wc.do_macierzy() == c ? "Tak" : "Nie") << endl;
+
+            start = chrono::steady_clock::now();
+            wa.odwroc();
+            czas_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+            cout << "  transpozycja: " << czas_us.count() << " us, zgodna z matrix? " << (wa.do_macierzy() == at ? "Tak" : "Nie") << endl;
+        };
+
+        macierz_ulozona<wierszowe> wa = macierz_ulozona<wierszowe>::z_macierzy(a);
+        macierz_ulozona<wierszowe> wb = macierz_ulozona<wierszowe>::z_macierzy(b);
+        pomiar(wa, wb);
+        pomiar(wa.przeksztalc<kolumnowe>(), wb.przeksztalc<kolumnowe>());
+        pomiar(wa.przeksztalc<morton>(), wb.przeksztalc<morton>());
+        cout << "Powrot z ulozenia Mortona bez zmian? "
+            << (wa.przeksztalc<morton>().przeksztalc<wierszowe>() == wa ? "Tak" : "Nie") << endl;
+
+        auto konwersje = [&](auto wzor) {
+            typedef decltype(wzor) typ;
+            start = chrono::steady_clock::now();
+            typ w = typ::z_macierzy(a);
+            auto czas_z = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+            start = chrono::steady_clock::now();
+            matrix m = w.do_macierzy();
+            auto czas_do = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+            cout << typ::ulozenie::nazwa() << ": z_macierzy " << czas_z.count() << " us, do_macierzy " << czas_do.count()
+                << " us, zgodne? " << (m == a ? "Tak" : "Nie") << endl;
+        };
+        konwersje(macierz_ulozona<wierszowe>());
+        konwersje(macierz_ulozona<kolumnowe>());
+        konwersje(macierz_ulozona<morton>());
+
+        const int n2 = 1025;
+        matrix d(n2);
+        d.losuj();
+        matrix dt(d);
+        dt.odwroc();
+        macierz_ulozona<morton> md = macierz_ulozona<morton>::z_macierzy(d);
+        cout << "Morton dla n = " << n2 << ": elementy bufora " << morton::rozmiar(n2) << " (n^2 = " << (size_t)n2 * n2
+            << "), powrot bez zmian? " << (md.do_macierzy() == d ? "Tak" : "Nie")
+            << ", przez kolumnowe? " << (md.przeksztalc<kolumnowe>().przeksztalc<morton>() == md ? "Tak" : "Nie")
+            << ", transpozycja zgodna? " << (md.odwroc().do_macierzy() == dt ? "Tak" : "Nie") << endl;
+        matrix e(200), f(200);
+        e.losuj();
+        f.losuj();
+        cout << "Morton dla n = 200: iloczyn zgodny z matrix? "
+            << (macierz_ulozona<morton>::z_macierzy(e).iloczyn(macierz_ulozona<morton>::z_macierzy(f)).do_macierzy() == e.iloczyn(f) ? "Tak" : "Nie")
+            << endl << endl;
+    }
+
+
+    /**
+     * @brief Test 19: Rozmieszczenie NUMA.
+     *
+     * Przypina wątki puli do węzłów i mierzy przepustowość odczytu macierzy 4096x4096
+     * dla rosnącej liczby wątków przy zasadzie pierwszego dotyku oraz przy przeplocie.
+     * Na systemie z jednym węzłem obie zasady dają to samo rozmieszczenie.
+     */
+    cout << "----------------Test 19: Rozmieszczenie NUMA---------------------------" << endl;
+    {
+        int watki = pula_watkow::globalna().liczba_watkow();
+        cout << "Wezly NUMA: " << numa::liczba_wezlow() << ", watki puli: " << watki
+            << ", przypiete: " << numa::przypnij_pule() << endl;
+        for (int w = 1; w <= watki; w *= 2) {
+            cout << "Pierwszy dotyk, " << w << " watk(i): " << numa::przepustowosc(4096, w) << " GB/s" << endl;
+        }
+        if (watki & (watki - 1)) {
+            cout << "Pierwszy dotyk, " << watki << " watk(i): " << numa::przepustowosc(4096, watki) << " GB/s" << endl;
+        }
+        numa::ustaw_polityke(numa::przeplot);
+        cout << "Przeplot, " << watki << " watk(i): " << numa::przepustowosc(4096, watki) << " GB/s" << endl;
+        numa::ustaw_polityke(numa::pierwszy_dotyk);
+
+        matrix z;
+        z.alokuj(1024);
+        matrix l(1024);
+        l.losuj();
+        matrix kopia(l);
+        kopia.wstaw(0, 0, kopia.pokaz(0, 0));
+        cout << "Zerowanie, losowanie i kopia rownolegla poprawne? "
+            << (z.pokaz(1023, 1023) == 0 && kopia == l && l.pokaz(1023, 1023) >= 0 && l.pokaz(1023, 1023) < 10 ? "Tak" : "Nie")
+            << endl << endl;
+    }
+
+
+    /**
+     * @brief Test 20: Macierz rozproszona.
+     *
+     * Czterech uczestników (siatka 2 x 2) połączonych segmentem pamięci współdzielonej, a następnie
+     * gniazdami TCP przez pętlę zwrotną, liczy sumę, transpozycję i iloczyn SUMMA.
+     * Wyniki zebrane u uczestnika 0 są porównywane z obliczeniami klasy matrix.
+     */
+    cout << "----------------Test 20: Macierz rozproszona---------------------------" << endl;
+    {
+        const int n = 256;
+        matrix a(n), b(n);
+        a.losuj();
+        b.losuj();
+        matrix suma_ab(a);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                suma_ab.wstaw(i, j, a.pokaz(i, j) + b.pokaz(i, j));
+            }
+        }
+        matrix at(a);
+        at.odwroc();
+        matrix ab = a.iloczyn(b);
+
+        for (int tryb = 0; tryb < 2; tryb++) {
+            vector<unique_ptr<transport>> uczestnicy = tryb == 0 ? transport_pamieci::utworz(4) : transport_tcp::utworz_lokalnie(4);
+            matrix z_sumy, z_transpozycji, z_iloczynu;
+            bool mniejsza = false;
+            start = chrono::steady_clock::now();
+            transport::uruchom(uczestnicy, [&](transport& t) {
+                macierz_rozproszona da = macierz_rozproszona::rozprosz(t, a, n);
+                macierz_rozproszona db = macierz_rozproszona::rozprosz(t, b, n);
+                macierz_rozproszona ds = da;
+                ds += db;
+                macierz_rozproszona dt = da.transpozycja();
+                macierz_rozproszona dab = da.iloczyn(db);
+                bool m = da < ds;
+                matrix s = ds.zbierz();
+                matrix tr = dt.zbierz();
+                matrix il = dab.zbierz();
+                if (t.ranga() == 0) {
+                    z_sumy = s;
+                    z_transpozycji = tr;
+                    z_iloczynu = il;
+                    mniejsza = m;
+                }
+            });
+            czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+            cout << (tryb == 0 ? "Pamiec wspoldzielona" : "TCP (127.0.0.1)") << ": " << czas.count() << " ms" << endl;
+            cout << "  suma, transpozycja, iloczyn zgodne z matrix? "
+                << (z_sumy == suma_ab && z_transpozycji == at && z_iloczynu == ab ? "Tak" : "Nie")
+                << ", a < a + b? " << (mniejsza ? "Tak" : "Nie") << endl;
+        }
+        cout << endl;
+    }
+
+
+    /**
+     * @brief Test 21: Przetwarzanie strumieniowe.
+     *
+     * Przepuszcza małą macierz przez etapy +1 i *2 i wypisuje wynik wiersz po wierszu,
+     * a następnie sumuje losową macierz 8192x8192 generowaną blokami po 64 wiersze,
+     * nie tworząc jej w całości. Wynik potoku wielowątkowego jest porównywany z leniwym
+     * przetwarzaniem w jednym wątku. Na koniec sprawdza, że wyjątek z funkcji etapu
+     * elementami() zatrzymuje potok i trafia do wywołującego uruchom().
+     */
+    cout << "----------------Test 21: Przetwarzanie strumieniowe--------------------" << endl;
+    {
+        int elementy_s[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+        matrix s(3, elementy_s);
+        cout << "2 * (s + 1) strumieniowo:" << endl;
+        strumien::uruchom(strumien::z_macierzy(s, 1), { strumien::dodaj(1), strumien::mnoz(2) }, strumien::wypisz(cout));
+
+        const int n = 8192;
+        long long suma_potoku = 0;
+        start = chrono::steady_clock::now();
+        strumien::statystyki st = strumien::uruchom(strumien::losowe(n, 64, 2024),
+            { strumien::elementami([](int x) { return x * x; }), strumien::dodaj(1) }, strumien::sumuj(suma_potoku));
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "Suma potoku 8192x8192: " << suma_potoku << " (" << czas.count() << " ms, bloki: " << st.bloki
+            << ", najwiecej naraz: " << st.najwiecej_blokow << ")" << endl;
+
+        long long suma_leniwa = 0;
+        generator<blok_wierszy> g = strumien::przeksztalc(strumien::przeksztalc(strumien::losowe(n, 64, 2024),
+            strumien::elementami([](int x) { return x * x; })), strumien::dodaj(1));
+        strumien::ujscie sumuj = strumien::sumuj(suma_leniwa);
+        while (g.nastepny()) {
+            sumuj(g.wartosc());
+        }
+        cout << "Zgodna z przetwarzaniem leniwym? " << (suma_potoku == suma_leniwa ? "Tak" : "Nie") << endl;
+
+        long long suma_bledu = 0;
+        bool blad_etapu = false;
+        try {
+            strumien::uruchom(strumien::losowe(1024, 64, 7), { strumien::elementami([](int x) {
+                if (x == 0) {
+                    throw runtime_error("etap");
+                }
+                return x;
+            }) }, strumien::sumuj(suma_bledu));
+        }
+        catch (const runtime_error&) {
+            blad_etapu = true;
+        }
+        cout << "Wyjatek z etapu elementami przekazany? " << (blad_etapu ? "Tak" : "Nie") << endl << endl;
+    }
+
+
+    /**
+     * @brief Test 22: Macierz bitowa.
+     *
+     * Losowy graf 1024 wierzchołków jako macierz sąsiedztwa: porównuje zużycie pamięci,
+     * iloczyn logiczny (ścieżki długości 2) z iloczynem klasy matrix oraz sprawdza
+     * liczniki wierszy i kolumn.
+     */
+    cout << "----------------Test 22: Macierz bitowa--------------------------------" << endl;
+    {
+        const int n = 1024;
+        matrix sasiedztwo;
+        sasiedztwo.alokuj(n);
+        sasiedztwo.losuj(n * n / 8);
+        macierz_bitowa g = macierz_bitowa::z_macierzy(sasiedztwo);
+        matrix g01 = g.do_macierzy();
+        cout << "Pamiec: matrix " << (size_t)n * n * sizeof(int) / 1024 << " KB, bitowa "
+            << (size_t)n * ((n + 63) / 64) * 8 / 1024 << " KB, krawedzie: " << g.liczba() << endl;
+
+        start = chrono::steady_clock::now();
+        matrix sciezki = g01.iloczyn(g01);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "matrix::iloczyn: " << czas.count() << " ms" << endl;
+
+        start = chrono::steady_clock::now();
+        macierz_bitowa g2 = g.iloczyn(g);
+        auto czas_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+        cout << "macierz_bitowa::iloczyn: " << czas_us.count() << " us" << endl;
+
+        bool zgodne = true;
+        for (int i = 0; i < n && zgodne; i++) {
+            for (int j = 0; j < n; j++) {
+                if (g2.pokaz(i, j) != (sciezki.pokaz(i, j) != 0)) {
+                    zgodne = false;
+                    break;
+                }
+            }
+        }
+        cout << "Iloczyn logiczny zgodny? " << (zgodne ? "Tak" : "Nie")
+            << ", iloczyn liczbowy zgodny? " << (g.iloczyn_liczbowy(g) == sciezki ? "Tak" : "Nie") << endl;
+
+        macierz_bitowa gt(g);
+        gt.odwroc();
+        cout << "Stopnie wychodzace = wchodzace w transpozycji? " << (g.sumy_wierszy() == gt.sumy_kolumn() ? "Tak" : "Nie")
+            << ", (g & ~g) pusta? " << ((g & ~g).liczba() == 0 ? "Tak" : "Nie") << endl << endl;
+    }
+
+    /**
+     * @brief Test 23: Macierz skompresowana.
+     *
+     * Macierz 2048 x 2048 z wartościami 0-9 w kaflach z odniesieniem do minimum:
+     * porównuje zajętość i czas sumy z klasą matrix, sprawdza poszerzenie zapisu
+     * po mnożeniu oraz zapis i odczyt pliku.
+     */
+    cout << "----------------Test 23: Macierz skompresowana-------------------------" << endl;
+    {
+        const int n = 2048;
+        matrix m;
+        m.alokuj(n);
+        m.losuj();
+        macierz_skompresowana s = macierz_skompresowana::z_macierzy(m);
+        macierz_skompresowana::zajetosc z = s.zuzycie();
+        cout << "Pamiec: matrix " << z.bez_kompresji / 1024 << " KB, skompresowana " << z.w_pamieci / 1024
+            << " KB, na dysku " << z.na_dysku / 1024 << " KB" << endl;
+
+        start = chrono::steady_clock::now();
+        long long suma_m = 0;
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                suma_m += m.pokaz(i, j);
+            }
+        }
+        auto czas_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+        cout << "Suma matrix: " << suma_m << " (" << czas_us.count() << " us)" << endl;
+        start = chrono::steady_clock::now();
+        long long suma_s = s.suma();
+        czas_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+        cout << "Suma skompresowana: " << suma_s << " (" << czas_us.count() << " us)" << endl;
+
+        s += 1000;
+        s *= 300;
+        m += 1000;
+        m *= 300;
+        z = s.zuzycie();
+        cout << "Po (m + 1000) * 300: zgodna? " << (s.do_macierzy() == m ? "Tak" : "Nie")
+            << ", kafle 16-bitowe: " << z.kafle[5] << ", min " << s.minimum() << ", max " << s.maksimum() << endl;
+
+        stringstream plik;
+        s.zapisz(plik);
+        cout << "Odczyt z pliku zgodny? " << (macierz_skompresowana::wczytaj(plik) == s ? "Tak" : "Nie")
+            << ", bajty: " << plik.str().size() << " (przewidziane " << z.na_dysku << ")" << endl << endl;
+    }
+
+    /**
+     * @brief Test 24: Strojenie parametrów.
+     *
+     * Dobiera parametry jąder pomiarem i zapisuje je do pliku tymczasowego, wczytuje je
+     * ponownie z tego pliku, porównuje czasy transpozycji i iloczynu z wartościami domyślnymi
+     * oraz sprawdza ręczne ustawienie parametrów. Plik jest usuwany na końcu testu.
+     */
+    cout << "----------------Test 24: Strojenie parametrow--------------------------" << endl;
+    {
+        const char* pochodzenia[] = { "domyslne", "z pliku", "zmierzone", "reczne" };
+        const int n = 1024;
+        matrix a;
+        a.alokuj(n);
+        a.losuj();
+        matrix t_dom(a);
+        matrix c_dom = a.iloczyn(a);
+        start = chrono::steady_clock::now();
+        t_dom.odwroc();
+        auto czas_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+        cout << "Domyslne: odwroc " << czas_us.count() << " us" << endl;
+
+        const string plik_strojenia = (filesystem::temp_directory_path() / "strojenie_test.txt").string();
+        filesystem::remove(plik_strojenia);
+        start = chrono::steady_clock::now();
+        strojenie::ustawienia u = strojenie::uruchom(plik_strojenia);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "Maszyna: " << strojenie::klucz_maszyny() << endl;
+        cout << "Parametry (" << pochodzenia[strojenie::pochodzenie()] << ", " << czas.count() << " ms): kafel " << u.kafel
+            << ", pasek " << u.pasek_kb << " KB, rozwiniecie " << u.rozwiniecie << ", prog " << u.prog << endl;
+        strojenie::ustawienia z_pliku = strojenie::uruchom(plik_strojenia);
+        cout << "Ponowne uruchomienie: " << pochodzenia[strojenie::pochodzenie()] << ", zgodne? "
+            << (z_pliku.kafel == u.kafel && z_pliku.pasek_kb == u.pasek_kb && z_pliku.rozwiniecie == u.rozwiniecie
+                && z_pliku.prog == u.prog ? "Tak" : "Nie") << endl;
+
+        matrix t(a);
+        start = chrono::steady_clock::now();
+        t.odwroc();
+        czas_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+        cout << "Dostrojone: odwroc " << czas_us.count() << " us, zgodne? " << (t == t_dom ? "Tak" : "Nie")
+            << ", iloczyn zgodny? " << (a.iloczyn(a) == c_dom ? "Tak" : "Nie") << endl;
+
+        strojenie::ustawienia r = u;
+        r.rozwiniecie = 3;
+        try {
+            strojenie::ustaw(r);
+        }
+        catch (const invalid_argument& e) {
+            cout << "Rozwiniecie 3 odrzucone: " << e.what() << endl;
+        }
+        r.rozwiniecie = 4;
+        r.kafel = 8;
+        strojenie::ustaw(r);
+        cout << "Po ustaw(): " << pochodzenia[strojenie::pochodzenie()] << ", kafel " << strojenie::biezace().kafel << endl;
+        strojenie::ustaw(u);
+        filesystem::remove(plik_strojenia);
+        cout << endl;
+    }
+
+    /**
+     * @brief Test 25: Macierz współbieżna.
+     *
+     * Czytelnicy (1 - 64 wątków) wykonują zapytania po 16 odczytów, a jeden pisarz
+     * w tym czasie publikuje partie ustawiające cały losowy wiersz na numer partii.
+     * Porównuje przepustowość migawek z macierzą chronioną muteksem (ta sama praca
+     * czytelników i pisarza, błędy liczone lokalnie w każdym wątku) i sprawdza, że żaden
+     * czytelnik nie zobaczył wiersza zmienionego tylko częściowo. Na koniec migawka jest przenoszona do innego
+     * wątku i tam niszczona, a jej wersja zwalniana dopiero potem.
+     */
+    cout << "----------------Test 25: Macierz wspolbiezna---------------------------" << endl;
+    {
+        const int n = 512;
+        const int zapytania = 20000;
+        matrix zera;
+        zera.alokuj(n);
+        vector<int> wiersz_partii(n);
+        for (int watki_czytelnikow : { 1, 2, 4, 8, 16, 32, 64 }) {
+            double przepustowosc[2];
+            long long niespojne = 0;
+            for (int tryb = 0; tryb < 2; tryb++) {
+                macierz_wspolbiezna wspolbiezna(zera);
+                matrix chroniona(zera);
+                mutex mtx;
+                atomic<bool> koniec(false);
+                atomic<long long> bledy_razem(0);
+                thread pisarz([&] {
+                    minstd_rand gen(7);
+                    for (int numer = 1; !koniec.load(); numer++) {
+                        int y = (int)(gen() % n);
+                        fill(wiersz_partii.begin(), wiersz_partii.end(), numer);
+                        if (tryb == 0) {
+                            macierz_wspolbiezna::partia p = wspolbiezna.zmiany();
+                            p.wiersz(y, wiersz_partii.data());
+                            wspolbiezna.opublikuj(p);
+                        }
+                        else {
+                            lock_guard<mutex> blokada(mtx);
+                            chroniona.wiersz(y, wiersz_partii.data());
+                        }
+                        this_thread::yield();
+                    }
+                });
+                start = chrono::steady_clock::now();
+                vector<thread> czytelnicy;
+                for (int c = 0; c < watki_czytelnikow; c++) {
+                    czytelnicy.emplace_back([&, c] {
+                        minstd_rand gen(c + 1);
+                        long long suma = 0;
+                        long long bledy = 0;
+                        for (int q = 0; q < zapytania; q++) {
+                            int x = (int)(gen() % n);
+                            if (tryb == 0) {
+                                macierz_wspolbiezna::migawka m = wspolbiezna.czytaj();
+                                int pierwszy = m.pokaz(x, 0);
+                                for (int k = 1; k < 16; k++) {
+                                    int v = m.pokaz(x, (int)(gen() % n));
+                                    suma += v;
+                                    bledy += v != pierwszy;
+                                }
+                            }
+                            else {
+                                lock_guard<mutex> blokada(mtx);
+                                int pierwszy = chroniona.pokaz(x, 0);
+                                for (int k = 1; k < 16; k++) {
+                                    int v = chroniona.pokaz(x, (int)(gen() % n));
+                                    suma += v;
+                                    bledy += v != pierwszy;
+                                }
+                            }
+                        }
+                        bledy_razem += bledy;
+                        if (suma < 0) {
+                            cout << suma;
+                        }
+                    });
+                }
+                for (size_t c = 0; c < czytelnicy.size(); c++) {
+                    czytelnicy[c].join();
+                }
+                auto czas_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+                koniec = true;
+                pisarz.join();
+                przepustowosc[tryb] = (double)watki_czytelnikow * zapytania * 16 / max((long long)czas_us.count(), 1LL);
+                niespojne += bledy_razem.load();
+            }
+            cout << "Czytelnicy: " << watki_czytelnikow << ", odczyty/us: migawki " << przepustowosc[0]
+                << ", muteks " << przepustowosc[1] << ", niespojne wiersze: " << niespojne << endl;
+        }
+
+        macierz_wspolbiezna w(zera);
+        macierz_wspolbiezna::migawka przed = w.czytaj();
+        macierz_wspolbiezna::partia p = w.zmiany();
+        p.wstaw(0, 0, 5).wstaw(n - 1, n - 1, 7);
+        w.opublikuj(p);
+        macierz_wspolbiezna::migawka po = w.czytaj();
+        cout << "Wersje " << przed.numer() << " i " << po.numer() << ": wspolne kafle " << po.wspolne_kafle(przed)
+            << " z " << (n / macierz_wspolbiezna::KAFEL) * (n / macierz_wspolbiezna::KAFEL)
+            << ", stara wersja nadal 0? " << (przed.pokaz(0, 0) == 0 ? "Tak" : "Nie")
+            << ", nowa 5? " << (po.pokaz(0, 0) == 5 ? "Tak" : "Nie") << endl;
+
+        macierz_wspolbiezna::migawka stara = w.czytaj();
+        w.opublikuj(w.zmiany().wstaw(1, 1, 9));
+        bool przed_przeniesieniem = w.oczekujace() > 0;
+        thread([&stara] {
+            macierz_wspolbiezna::migawka m(move(stara));
+        }).join();
+        {
+            macierz_wspolbiezna::migawka a = move(przed), b = move(po);
+        }
+        w.opublikuj(w.zmiany());
+        cout << "Migawka zniszczona w innym watku: wersja trzymana przed? " << (przed_przeniesieniem ? "Tak" : "Nie")
+            << ", zwolniona po? " << (w.oczekujace() == 0 ? "Tak" : "Nie") << endl << endl;
+    }
+
+    /**
+     * @brief Test 26: Wstawianie i odczyt partiami.
+     *
+     * Porównuje 4 mln losowych wstawień wywołaniami wstaw() z rozrzuc() (bez układania
+     * i z ułożeniem pasami wierszy) oraz odczyt pokaz() z zbierz(), sprawdzając zgodność wyników.
+     */
+    cout << "----------------Test 26: Wstawianie i odczyt partiami-----------------" << endl;
+    {
+        const int n = 4096;
+        const size_t m = 1 << 22;
+        minstd_rand gen(11);
+        vector<pair<int, int>> pozycje(m);
+        vector<int> wartosci(m);
+        for (size_t i = 0; i < m; i++) {
+            pozycje[i] = make_pair((int)(gen() % n), (int)(gen() % n));
+            wartosci[i] = (int)(gen() % 1000);
+        }
+        matrix a;
+        a.alokuj(n);
+        matrix b(a);
+        matrix c(a);
+
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < m; i++) {
+            a.wstaw(pozycje[i].first, pozycje[i].second, wartosci[i]);
+        }
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "wstaw(): " << czas.count() << " ms" << endl;
+        start = chrono::steady_clock::now();
+        b.rozrzuc(pozycje, wartosci);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "rozrzuc(): " << czas.count() << " ms, zgodne? " << (a == b ? "Tak" : "Nie") << endl;
+        start = chrono::steady_clock::now();
+        c.rozrzuc(pozycje, wartosci, true);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "rozrzuc() pasami: " << czas.count() << " ms, zgodne? " << (a == c ? "Tak" : "Nie") << endl;
+
+        vector<int> odczyt(m);
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < m; i++) {
+            odczyt[i] = a.pokaz(pozycje[i].first, pozycje[i].second);
+        }
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "pokaz(): " << czas.count() << " ms" << endl;
+        vector<int> partia;
+        start = chrono::steady_clock::now();
+        a.zbierz(pozycje, partia);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "zbierz(): " << czas.count() << " ms, zgodne? " << (partia == odczyt ? "Tak" : "Nie") << endl;
+        start = chrono::steady_clock::now();
+        a.zbierz(pozycje, partia, true);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "zbierz() pasami: " << czas.count() << " ms, zgodne? " << (partia == odczyt ? "Tak" : "Nie") << endl;
+
+        pozycje.push_back(make_pair(n, 0));
+        wartosci.push_back(1);
+        try {
+            b.rozrzuc(pozycje, wartosci);
+        }
+        catch (const invalid_argument& e) {
+            cout << "Pozycja poza macierza: " << e.what() << ", macierz bez zmian? " << (a == b ? "Tak" : "Nie") << endl;
+        }
+        cout << endl;
+    }
+
+    /**
+     * @brief Test 27: Śledzenie operacji.
+     *
+     * Mierzy czas miliona małych operacji przy wyłączonym i włączonym śledzeniu, zapisuje
+     * przebieg kilku operacji na dużej macierzy do pliku sledzenie.json (do otwarcia
+     * w ui.perfetto.dev) i sprawdza liczbę zapisanych zdarzeń oraz to, że eksport przy
+     * włączonym śledzeniu jest odrzucany. Na koniec uruchamia po kolei wiele krótkich
+     * wątków i sprawdza, że przejmują bufory zakończonych wątków zamiast przydzielać nowe.
+     */
+    cout << "----------------Test 27: Sledzenie operacji-----------------" << endl;
+    {
+        matrix mala(8);
+        mala.alokuj(8);
+        const int powtorzenia = 1000000;
+        for (int tryb = 0; tryb < 2; tryb++) {
+            sledzenie::wlacz(tryb == 1);
+            start = chrono::steady_clock::now();
+            for (int i = 0; i < powtorzenia; i++) {
+                mala += 1;
+            }
+            auto czas_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+            cout << "Sledzenie " << (tryb == 1 ? "wlaczone" : "wylaczone") << ": "
+                << (double)czas_us.count() * 1000.0 / powtorzenia << " ns na operacje" << endl;
+        }
+        cout << "Zdarzenia w buforach (najwyzej " << sledzenie::POJEMNOSC << " na watek): " << sledzenie::liczba_zdarzen() << endl;
+
+        sledzenie::wlacz(false);
+        sledzenie::wyczysc();
+        sledzenie::wlacz();
+        matrix duza(1024);
+        duza.losuj();
+        duza.odwroc();
+        duza += 3;
+        matrix kopia(duza);
+        bool rowne = duza == kopia;
+        kopia *= 2;
+        matrix iloczyn = duza.iloczyn(kopia);
+        sledzenie::wlacz(false);
+        size_t zdarzenia = sledzenie::liczba_zdarzen();
+        cout << "Zdarzenia operacji na macierzy 1024x1024: " << zdarzenia << ", rowne? " << (rowne ? "Tak" : "Nie") << endl;
+        sledzenie::zapisz(string("sledzenie.json"));
+        ostringstream json;
+        sledzenie::zapisz(json);
+        cout << "Plik sledzenie.json zapisany, zdarzenie odwroc obecne? "
+            << (json.str().find("\"name\":\"odwroc\",\"ph\":\"X\"") != string::npos ? "Tak" : "Nie") << endl;
+        sledzenie::wlacz();
+        bool odrzucone = false;
+        try {
+            sledzenie::zapisz(json);
+        }
+        catch (const logic_error&) {
+            odrzucone = true;
+        }
+        sledzenie::wlacz(false);
+        cout << "Eksport przy wlaczonym sledzeniu odrzucony? " << (odrzucone ? "Tak" : "Nie") << endl;
+
+        sledzenie::wyczysc();
+        size_t bufory_przed = sledzenie::liczba_buforow();
+        sledzenie::wlacz();
+        for (int runda = 0; runda < 16; runda++) {
+            vector<thread> krotkie;
+            for (int t = 0; t < 8; t++) {
+                krotkie.emplace_back([] {
+                    matrix m(8);
+                    m += 1;
+                });
+            }
+            for (size_t t = 0; t < krotkie.size(); t++) {
+                krotkie[t].join();
+            }
+        }
+        sledzenie::wlacz(false);
+        size_t bufory_po = sledzenie::liczba_buforow();
+        size_t zdarzenia_watkow = sledzenie::liczba_zdarzen();
+        sledzenie::wyczysc();
+        cout << "128 krotkich watkow (po 8 naraz): bufory " << bufory_przed << " -> " << bufory_po
+            << ", zdarzenia " << zdarzenia_watkow << ", po wyczysc() bufory " << sledzenie::liczba_buforow()
+            << ", najwyzej 8 nowych? " << (bufory_po <= bufory_przed + 8 ? "Tak" : "Nie") << endl;
+        cout << endl;
+    }
+
+    /**
+     * @brief Test 28: Redukcje.
+     *
+     * Porównuje sumy, wartości skrajne z położeniem, ślad, sumy wierszy i kolumn, normy
+     * i zliczanie z pętlami pokaz() na macierzy 4096x4096, mierzy czas osobnych redukcji
+     * i redukcji w jednym przebiegu oraz sprawdza porównanie sum, które nie mieszczą się w int.
+     */
+    cout << "----------------Test 28: Redukcje-----------------" << endl;
+    {
+        const int n = 4096;
+        matrix a(n);
+        a.losuj();
+        a -= 5;
+        a.wstaw(1000, 17, -123456);
+        a.wstaw(3000, 5, 654321);
+
+        start = chrono::steady_clock::now();
+        long long suma = 0, slad = 0, ile_ujemnych = 0;
+        unsigned long long l1 = 0;
+        double l2 = 0;
+        int minimum = a.pokaz(0, 0), maksimum = a.pokaz(0, 0);
+        vector<long long> wiersze(n, 0), kolumny(n, 0);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                int x = a.pokaz(i, j);
+                suma += x;
+                l1 += (unsigned long long)(x < 0 ? -(long long)x : x);
+                l2 += (double)x * x;
+                minimum = min(minimum, x);
+                maksimum = max(maksimum, x);
+                ile_ujemnych += x < 0;
+                wiersze[i] += x;
+                kolumny[j] += x;
+            }
+            slad += a.pokaz(i, i);
+        }
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "Petle pokaz(): " << czas.count() << " ms" << endl;
+
+        start = chrono::steady_clock::now();
+        long long r_suma = redukcja::suma(a);
+        pozycja_wartosci r_min = redukcja::minimum(a);
+        pozycja_wartosci r_maks = redukcja::maksimum(a);
+        unsigned long long r_l1 = redukcja::norma_l1(a);
+        double r_l2 = redukcja::norma_l2(a);
+        unsigned int r_max = redukcja::norma_max(a);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "Szesc osobnych redukcji: " << czas.count() << " ms" << endl;
+        start = chrono::steady_clock::now();
+        statystyki s = redukcja::wszystkie(a);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "Redukcje w jednym przebiegu: " << czas.count() << " ms" << endl;
+
+        bool zgodne = r_suma == suma && s.suma == suma && redukcja::slad(a) == slad && s.slad == slad
+            && r_l1 == l1 && s.norma_l1 == l1 && fabs(r_l2 - sqrt(l2)) < 1e-6 * sqrt(l2) && r_l2 == s.norma_l2
+            && r_max == 654321 && s.norma_max == r_max
+            && redukcja::sumy_wierszy(a) == wiersze && redukcja::sumy_kolumn(a) == kolumny
+            && redukcja::policz(a, redukcja::mniejsze, 0) == ile_ujemnych
+            && redukcja::policz(a, [](int x) { return x < 0; }) == ile_ujemnych;
+        cout << "Wyniki zgodne z petlami? " << (zgodne ? "Tak" : "Nie") << endl;
+        cout << "Minimum " << r_min.wartosc << " w (" << r_min.wiersz << ", " << r_min.kolumna << ")"
+            << ", maksimum " << r_maks.wartosc << " w (" << r_maks.wiersz << ", " << r_maks.kolumna << ")"
+            << ", zgodne? " << (r_min.wartosc == minimum && r_maks.wartosc == maksimum
+                && s.minimum.wiersz == 1000 && s.minimum.kolumna == 17 && s.maksimum.wiersz == 3000 ? "Tak" : "Nie") << endl;
+
+        int duze[] = { 2000000000, 2000000000, 2000000000, 2000000000 };
+        matrix b(2, duze), c(2);
+        c.alokuj(2);
+        cout << "Suma " << redukcja::suma(b) << " > 0, b > c? " << (b > c ? "Tak" : "Nie") << endl;
+        cout << endl;
+    }
+
+    /**
+     * @brief Test 29: Polityki przepełnienia.
+     *
+     * Mierzy `+=` i iloczyn elementami macierzy 4096x4096 z politykami zawijanie, nasycanie
+     * i sprawdzanie oraz dla porównania operator `+=` i dodawanie na kopii 64-bitowej,
+     * a następnie sprawdza wyniki na elementach bliskich INT_MAX i INT_MIN.
+     */
+    cout << "----------------Test 29: Polityki przepelnienia-----------------" << endl;
+    {
+        const int n = 4096;
+        matrix a(n);
+        a.losuj();
+        start = chrono::steady_clock::now();
+        a += 7;
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "operator+=: " << czas.count() << " ms" << endl;
+        start = chrono::steady_clock::now();
+        vector<long long> szerokie((size_t)n * n);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                szerokie[(size_t)i * n + j] = (long long)a.pokaz(i, j) + 7;
+            }
+        }
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "Kopia 64-bitowa przez pokaz() + 7: " << czas.count() << " ms" << endl;
+
+        start = chrono::steady_clock::now();
+        arytmetyka::dodaj<zawijanie>(a, 7);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "dodaj<zawijanie>: " << czas.count() << " ms" << endl;
+        start = chrono::steady_clock::now();
+        arytmetyka::dodaj<nasycanie>(a, 7);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "dodaj<nasycanie>: " << czas.count() << " ms" << endl;
+        start = chrono::steady_clock::now();
+        arytmetyka::dodaj<sprawdzanie>(a, 7);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "dodaj<sprawdzanie>: " << czas.count() << " ms" << endl;
+        bool zgodne = a.pokaz(0, 0) == szerokie[0] + 14 && a.pokaz(n - 1, n - 1) == szerokie[(size_t)n * n - 1] + 14;
+        start = chrono::steady_clock::now();
+        matrix c = arytmetyka::iloczyn_elementow<sprawdzanie>(a, a);
+        czas = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        cout << "iloczyn_elementow<sprawdzanie>: " << czas.count() << " ms, zgodne? "
+            << (zgodne && c.pokaz(5, 6) == a.pokaz(5, 6) * a.pokaz(5, 6) ? "Tak" : "Nie") << endl;
+
+        int t[] = { INT_MAX - 1, 5, INT_MIN + 1, -5 };
+        matrix m(2, t);
+        matrix s = arytmetyka::suma<nasycanie>(m, 3);
+        matrix r = arytmetyka::roznica<nasycanie>(m, 3);
+        matrix z = arytmetyka::suma<zawijanie>(m, 3);
+        cout << "nasycanie: " << s.pokaz(0, 0) << " " << r.pokaz(1, 0)
+            << ", zawijanie: " << z.pokaz(0, 0) << endl;
+        macierz_z_polityka<nasycanie> mn(m);
+        mn *= 1000;
+        mn++;
+        cout << "macierz_z_polityka<nasycanie> *1000 +1:" << endl << mn.macierz();
+        macierz_z_polityka<sprawdzanie> ms(m);
+        try {
+            ms = ms + 1;
+            cout << "Bez przepelnienia: " << ms.macierz().pokaz(0, 0) << endl;
+            ms = ms * ms;
+        }
+        catch (const overflow_error& e) {
+            cout << "sprawdzanie: " << e.what() << " (zgloszone raz dla calej operacji)" << endl;
+        }
+        cout << endl;
+    }
+
     return 0;
 }
@@ -0,0 +1,402 @@
+/**
+ * @file graf.cpp
+ * @brief Implementacja asynchronicznego grafu operacji na macierzach.
+ */
+
+#include "graf.h"
+#include "watki.h"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Konstruktor.
+ *
+ * Uruchamia wątki, które pobierają gotowe węzły z kolejki i je wykonują.
+ *
+ * @param watki Liczba wątków wykonujących węzły (0 - liczba rdzeni).
+ */
+graf_zadan::graf_zadan(int watki) : niezakonczone(0), zatrzymaj(false) {
+	if (watki <= 0) {
+		watki = max(1, (int)thread::hardware_concurrency());
+	}
+	for (int i = 0; i < watki; i++) {
+		this->watki.emplace_back(&graf_zadan::petla, this);
+	}
+}
+
+/**
+ * @brief Destruktor.
+ *
+ * Czeka na zakończenie wszystkich węzłów, a następnie zatrzymuje wątki grafu.
+ */
+graf_zadan::~graf_zadan() {
+	czekaj_wszystkie();
+	{
+		lock_guard<mutex> blokada(mtx);
+		zatrzymaj = true;
+	}
+	praca.notify_all();
+	for (size_t i = 0; i < watki.size(); i++) {
+		watki[i].join();
+	}
+}
+
+/**
+ * @brief Dodaje zadanie jako węzeł grafu.
+ *
+ * Węzeł bez niezakończonych zależności trafia od razu do kolejki gotowych.
+ * Jeśli któraś z zależności zakończyła się wyjątkiem, zadanie nie jest wykonywane,
+ * a wyjątek przechodzi na przyszłość nowego węzła.
+ *
+ * @param nazwa Nazwa węzła (widoczna w eksporcie).
+ * @param f Zadanie do wykonania.
+ * @param zaleznosci Węzły, które muszą zakończyć się wcześniej.
+ * @return Uchwyt nowego węzła.
+ * @throws std::invalid_argument Jeśli uchwyt zależności jest nieprawidłowy.
+ */
+graf_zadan::uchwyt graf_zadan::dodaj(const string& nazwa, function<void()> f, const vector<uchwyt>& zaleznosci) {
+	lock_guard<mutex> blokada(mtx);
+	uchwyt h = (uchwyt)wezly.size();
+	unique_ptr<wezel> w(new wezel());
+	w->nazwa = nazwa;
+	w->f = move(f);
+	w->zaleznosci = zaleznosci;
+	w->brakujace = 0;
+	w->s = oczekuje;
+	w->przyszlosc = w->obietnica.get_future().share();
+
+	for (size_t i = 0; i < zaleznosci.size(); i++) {
+		if (zaleznosci[i] < 0 || zaleznosci[i] >= h) {
+			throw invalid_argument("Invalid task handle");
+		}
+	}
+	for (size_t i = 0; i < zaleznosci.size(); i++) {
+		wezel* p = wezly[zaleznosci[i]].get();
+		if (p->s != zakonczony) {
+			p->nastepniki.push_back(h);
+			w->brakujace++;
+		}
+		else if (p->blad && !w->blad) {
+			w->blad = p->blad;
+		}
+	}
+
+	if (w->brakujace == 0) {
+		w->s = gotowy;
+		gotowe.push_back(h);
+	}
+	wezly.push_back(move(w));
+	niezakonczone++;
+	praca.notify_one();
+	return h;
+}
+
+/**
+ * @brief Dodaje węzeł losowo wypełniający macierz.
+ * @param m Macierz do wypełnienia.
+ * @param zaleznosci Węzły, które muszą zakończyć się wcześniej.
+ * @return Uchwyt nowego węzła.
+ */
+graf_zadan::uchwyt graf_zadan::wypelnij(matrix& m, const vector<uchwyt>& zaleznosci) {
+	matrix* p = &m;
+	return dodaj("losuj", [p] { p->losuj(); }, zaleznosci);
+}
+
+/**
+ * @brief Dodaje węzeł transponujący macierz.
+ * @param m Macierz do transpozycji.
+ * @param zaleznosci Węzły, które muszą zakończyć się wcześniej.
+ * @return Uchwyt nowego węzła.
+ */
+graf_zadan::uchwyt graf_zadan::transponuj(matrix& m, const vector<uchwyt>& zaleznosci) {
+	matrix* p = &m;
+	return dodaj("odwroc", [p] { p->odwroc(); }, zaleznosci);
+}
+
+/**
+ * @brief Dodaje węzeł sumujący dwie macierze.
+ * @param a Pierwszy składnik.
+ * @param b Drugi składnik.
+ * @param wynik Macierz wynikowa.
+ * @param zaleznosci Węzły, które muszą zakończyć się wcześniej.
+ * @return Uchwyt nowego węzła.
+ * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+ */
+graf_zadan::uchwyt graf_zadan::dodaj_macierze(const matrix& a, const matrix& b, matrix& wynik, const vector<uchwyt>& zaleznosci) {
+	if (a.n != b.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	const matrix* pa = &a;
+	matrix* pw = &wynik;
+	vector<etap> etapy(1, etap_dodaj(b));
+	return dodaj("dodaj", [pa, pw, etapy] { przetworz(*pa, *pw, etapy); }, zaleznosci);
+}
+
+/**
+ * @brief Dodaje węzeł porównujący dwie macierze.
+ * @param a Pierwsza macierz.
+ * @param b Druga macierz.
+ * @param wynik Zmienna, do której zostanie zapisany wynik porównania.
+ * @param zaleznosci Węzły, które muszą zakończyć się wcześniej.
+ * @return Uchwyt nowego węzła.
+ */
+graf_zadan::uchwyt graf_zadan::porownaj(const matrix& a, const matrix& b, bool& wynik, const vector<uchwyt>& zaleznosci) {
+	const matrix* pa = &a;
+	const matrix* pb = &b;
+	bool* pw = &wynik;
+	return dodaj("porownaj", [pa, pb, pw] { *pw = (*pa == *pb); }, zaleznosci);
+}
+
+/**
+ * @brief Dodaje węzeł wykonujący połączone etapy element po elemencie.
+ * @param wejscie Macierz wejściowa.
+ * @param wyjscie Macierz wynikowa (może być tą samą macierzą co wejście).
+ * @param etapy Kolejne etapy potoku.
+ * @param zaleznosci Węzły, które muszą zakończyć się wcześniej.
+ * @return Uchwyt nowego węzła.
+ */
+graf_zadan::uchwyt graf_zadan::potok(const matrix& wejscie, matrix& wyjscie, const vector<etap>& etapy, const vector<uchwyt>& zaleznosci) {
+	const matrix* pwe = &wejscie;
+	matrix* pwy = &wyjscie;
+	ostringstream nazwa;
+	nazwa << "potok[" << etapy.size() << "]";
+	return dodaj(nazwa.str(), [pwe, pwy, etapy] { przetworz(*pwe, *pwy, etapy); }, zaleznosci);
+}
+
+/**
+ * @brief Wykonuje połączone etapy na macierzy.
+ *
+ * Macierz jest dzielona na kafle wierszy po około 32 KB, które mieszczą się w pamięci
+ * podręcznej L1/L2. Kafel jest kopiowany do macierzy wynikowej i przechodzi przez wszystkie
+ * etapy, zanim zostanie pobrany następny, więc każdy element jest czytany z pamięci
+ * głównej tylko raz. Kafle są dzielone między wątki puli.
+ *
+ * @param wejscie Macierz wejściowa.
+ * @param wyjscie Macierz wynikowa.
+ * @param etapy Kolejne etapy potoku.
+ * @throws Pierwszy wyjątek zgłoszony przez etap (przekazany przez pulę po zakończeniu
+ *         wszystkich kafli); część wierszy wyniku może być już przetworzona.
+ */
+void graf_zadan::przetworz(const matrix& wejscie, matrix& wyjscie, const vector<etap>& etapy) {
+	int n = wejscie.n;
+	bool w_miejscu = (&wejscie == &wyjscie);
+	if (!w_miejscu && wyjscie.n != n) {
+		wyjscie.alokuj(n);
+	}
+	wyjscie.do_zapisu();
+	int kafel = max(1, 8192 / max(n, 1));
+	int kafle = (n + kafel - 1) / kafel;
+
+	pula_watkow::globalna().rownolegle(kafle, [&](int od, int do_, int) {
+		for (int t = od; t < do_; t++) {
+			int i0 = t * kafel;
+			int i1 = min(n, i0 + kafel);
+			if (!w_miejscu) {
+				for (int i = i0; i < i1; i++) {
+					copy(wejscie.data[i], wejscie.data[i] + n, wyjscie.data[i]);
+				}
+			}
+			for (size_t e = 0; e < etapy.size(); e++) {
+				for (int i = i0; i < i1; i++) {
+					etapy[e](wyjscie.data[i], i, n);
+				}
+			}
+		}
+	}, 2);
+}
+
+/**
+ * @brief Zwraca przyszłość związaną z węzłem.
+ * @param h Uchwyt węzła.
+ * @return Przyszłość spełniana po zakończeniu węzła.
+ * @throws std::invalid_argument Jeśli uchwyt jest nieprawidłowy.
+ */
+shared_future<void> graf_zadan::przyszlosc(uchwyt h) const {
+	lock_guard<mutex> blokada(mtx);
+	if (h < 0 || h >= (uchwyt)wezly.size()) {
+		throw invalid_argument("Invalid task handle");
+	}
+	return wezly[h]->przyszlosc;
+}
+
+/**
+ * @brief Czeka na zakończenie węzła.
+ * @param h Uchwyt węzła.
+ * @throws Wyjątek zgłoszony przez węzeł lub którąś z jego zależności.
+ */
+void graf_zadan::czekaj(uchwyt h) const {
+	przyszlosc(h).get();
+}
+
+/**
+ * @brief Czeka na zakończenie wszystkich dodanych węzłów.
+ *
+ * Wyjątki zgłoszone przez węzły nie są przekazywane; można je odczytać przez czekaj().
+ */
+void graf_zadan::czekaj_wszystkie() {
+	unique_lock<mutex> blokada(mtx);
+	wszystkie.wait(blokada, [this] { return niezakonczone == 0; });
+}
+
+/**
+ * @brief Eksportuje graf w formacie DOT.
+ *
+ * Etykieta węzła zawiera jego numer, nazwę i bieżący stan; węzły zakończone wyjątkiem
+ * są oznaczone kolorem czerwonym.
+ *
+ * @return Opis grafu w formacie DOT.
+ */
+string graf_zadan::eksportuj_dot() const {
+	static const char* nazwy_stanow[] = { "oczekuje", "gotowy", "wykonywany", "zakonczony" };
+	lock_guard<mutex> blokada(mtx);
+	ostringstream o;
+	o << "digraph graf_zadan {" << endl;
+	for (size_t i = 0; i < wezly.size(); i++) {
+		const wezel& w = *wezly[i];
+		o << "    n" << i << " [label=\"" << i << ": " << w.nazwa << "\\n" << nazwy_stanow[w.s] << "\"";
+		if (w.s == zakonczony && w.blad) {
+			o << ", color=red";
+		}
+		o << "];" << endl;
+	}
+	for (size_t i = 0; i < wezly.size(); i++) {
+		const vector<uchwyt>& z = wezly[i]->zaleznosci;
+		for (size_t j = 0; j < z.size(); j++) {
+			o << "    n" << z[j] << " -> n" << i << ";" << endl;
+		}
+	}
+	o << "}" << endl;
+	return o.str();
+}
+
+/**
+ * @brief Pętla wątku grafu.
+ *
+ * Pobiera gotowy węzeł, wykonuje jego zadanie poza blokadą i zgłasza zakończenie.
+ */
+void graf_zadan::petla() {
+	for (;;) {
+		wezel* w;
+		uchwyt h;
+		exception_ptr blad;
+		{
+			unique_lock<mutex> blokada(mtx);
+			praca.wait(blokada, [this] { return zatrzymaj || !gotowe.empty(); });
+			if (gotowe.empty()) {
+				return;
+			}
+			h = gotowe.front();
+			gotowe.pop_front();
+			w = wezly[h].get();
+			w->s = wykonywany;
+			blad = w->blad;
+		}
+
+		if (!blad) {
+			try {
+				w->f();
+			}
+			catch (...) {
+				blad = current_exception();
+			}
+		}
+
+		lock_guard<mutex> blokada(mtx);
+		w->blad = blad;
+		zakoncz(h);
+	}
+}
+
+/**
+ * @brief Oznacza węzeł jako zakończony i zwalnia jego następniki.
+ *
+ * Wywoływana z założoną blokadą `mtx`.
+ *
+ * @param h Uchwyt węzła.
+ */
+void graf_zadan::zakoncz(uchwyt h) {
+	wezel* w = wezly[h].get();
+	w->s = zakonczony;
+	w->f = nullptr;
+	if (w->blad) {
+		w->obietnica.set_exception(w->blad);
+	}
+	else {
+		w->obietnica.set_value();
+	}
+
+	for (size_t i = 0; i < w->nastepniki.size(); i++) {
+		wezel* nast = wezly[w->nastepniki[i]].get();
+		if (w->blad && !nast->blad) {
+			nast->blad = w->blad;
+		}
+		if (--nast->brakujace == 0) {
+			nast->s = gotowy;
+			gotowe.push_back(w->nastepniki[i]);
+			praca.notify_one();
+		}
+	}
+
+	if (--niezakonczone == 0) {
+		wszystkie.notify_all();
+	}
+}
+
+/**
+ * @brief Etap dodający skalar do każdego elementu.
+ * @param a Skalar do dodania.
+ * @return Etap potoku.
+ */
+graf_zadan::etap graf_zadan::etap_dodaj(int a) {
+	return [a](int* w, int, int n) {
+		for (int j = 0; j < n; j++) {
+			w[j] += a;
+		}
+	};
+}
+
+/**
+ * @brief Etap mnożący każdy element przez skalar.
+ * @param a Skalar do mnożenia.
+ * @return Etap potoku.
+ */
+graf_zadan::etap graf_zadan::etap_mnoz(int a) {
+	return [a](int* w, int, int n) {
+		for (int j = 0; j < n; j++) {
+			w[j] *= a;
+		}
+	};
+}
+
+/**
+ * @brief Etap dodający odpowiadające elementy innej macierzy.
+ * @param m Macierz do dodania (musi mieć ten sam rozmiar).
+ * @return Etap potoku.
+ */
+graf_zadan::etap graf_zadan::etap_dodaj(const matrix& m) {
+	const matrix* p = &m;
+	return [p](int* w, int i, int n) {
+		const int* r = p->data[i];
+		for (int j = 0; j < n; j++) {
+			w[j] += r[j];
+		}
+	};
+}
+
+/**
+ * @brief Etap mnożący element po elemencie przez inną macierz.
+ * @param m Macierz do mnożenia (musi mieć ten sam rozmiar).
+ * @return Etap potoku.
+ */
+graf_zadan::etap graf_zadan::etap_mnoz(const matrix& m) {
+	const matrix* p = &m;
+	return [p](int* w, int i, int n) {
+		const int* r = p->data[i];
+		for (int j = 0; j < n; j++) {
+			w[j] *= r[j];
+		}
+	};
+}
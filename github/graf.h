@@ -0,0 +1,204 @@
+#pragma once
+#ifndef GRAF_H
+#define GRAF_H
+
+#include "matrix.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+/**
+ * @class graf_zadan
+ * @brief Asynchroniczne wykonywanie operacji na macierzach w postaci grafu zależności.
+ *
+ * Każda dodana operacja staje się węzłem grafu i od razu zwraca uchwyt, a wątek
+ * wywołujący może dodawać kolejne operacje. Węzeł jest uruchamiany przez jeden z wątków
+ * grafu, gdy zakończą się wszystkie jego zależności; niezależne węzły działają równolegle.
+ * Macierze przekazane do operacji muszą istnieć do czasu zakończenia węzłów, które ich używają.
+ */
+class graf_zadan {
+public:
+    /**
+     * @brief Uchwyt węzła grafu.
+     */
+    typedef int uchwyt;
+
+    /**
+     * @brief Etap potoku element po elemencie.
+     *
+     * Argumenty: wskaźnik na wiersz (n elementów), numer wiersza, rozmiar macierzy.
+     * Etap modyfikuje wiersz w miejscu. Wyjątek zgłoszony przez etap kończy węzeł
+     * i przechodzi na jego przyszłość.
+     */
+    typedef function<void(int*, int, int)> etap;
+
+    /**
+     * @brief Konstruktor.
+     * @param watki Liczba wątków wykonujących węzły (0 - liczba rdzeni).
+     */
+    explicit graf_zadan(int watki = 0);
+
+    /**
+     * @brief Destruktor. Czeka na zakończenie wszystkich węzłów.
+     */
+    ~graf_zadan();
+
+    graf_zadan(const graf_zadan&) = delete;
+    graf_zadan& operator=(const graf_zadan&) = delete;
+
+    /**
+     * @brief Dodaje dowolne zadanie jako węzeł grafu.
+     * @param nazwa Nazwa węzła (widoczna w eksporcie).
+     * @param f Zadanie do wykonania.
+     * @param zaleznosci Węzły, które muszą zakończyć się wcześniej.
+     * @return Uchwyt nowego węzła.
+     */
+    uchwyt dodaj(const string& nazwa, function<void()> f, const vector<uchwyt>& zaleznosci = {});
+
+    /**
+     * @brief Losowo wypełnia macierz (losuj).
+     * @param m Macierz do wypełnienia.
+     * @param zaleznosci Węzły, które muszą zakończyć się wcześniej.
+     * @return Uchwyt nowego węzła.
+     */
+    uchwyt wypelnij(matrix& m, const vector<uchwyt>& zaleznosci = {});
+
+    /**
+     * @brief Transponuje macierz (odwroc).
+     * @param m Macierz do transpozycji.
+     * @param zaleznosci Węzły, które muszą zakończyć się wcześniej.
+     * @return Uchwyt nowego węzła.
+     */
+    uchwyt transponuj(matrix& m, const vector<uchwyt>& zaleznosci = {});
+
+    /**
+     * @brief Dodaje dwie macierze: wynik = a + b.
+     * @param a Pierwszy składnik.
+     * @param b Drugi składnik.
+     * @param wynik Macierz wynikowa.
+     * @param zaleznosci Węzły, które muszą zakończyć się wcześniej.
+     * @return Uchwyt nowego węzła.
+     */
+    uchwyt dodaj_macierze(const matrix& a, const matrix& b, matrix& wynik, const vector<uchwyt>& zaleznosci = {});
+
+    /**
+     * @brief Porównuje dwie macierze (==).
+     * @param a Pierwsza macierz.
+     * @param b Druga macierz.
+     * @param wynik Zmienna, do której zostanie zapisany wynik porównania.
+     * @param zaleznosci Węzły, które muszą zakończyć się wcześniej.
+     * @return Uchwyt nowego węzła.
+     */
+    uchwyt porownaj(const matrix& a, const matrix& b, bool& wynik, const vector<uchwyt>& zaleznosci = {});
+
+    /**
+     * @brief Wykonuje ciąg etapów element po elemencie jako jeden węzeł.
+     *
+     * Etapy są łączone: macierz jest przetwarzana kaflami wierszy, a każdy kafel przechodzi
+     * przez wszystkie etapy, zanim zostanie pobrany następny.
+     *
+     * @param wejscie Macierz wejściowa.
+     * @param wyjscie Macierz wynikowa (może być tą samą macierzą co wejście).
+     * @param etapy Kolejne etapy potoku.
+     * @param zaleznosci Węzły, które muszą zakończyć się wcześniej.
+     * @return Uchwyt nowego węzła.
+     */
+    uchwyt potok(const matrix& wejscie, matrix& wyjscie, const vector<etap>& etapy, const vector<uchwyt>& zaleznosci = {});
+
+    /**
+     * @brief Zwraca przyszłość związaną z węzłem.
+     * @param h Uchwyt węzła.
+     * @return Przyszłość spełniana po zakończeniu węzła.
+     */
+    shared_future<void> przyszlosc(uchwyt h) const;
+
+    /**
+     * @brief Czeka na zakończenie węzła i przekazuje ewentualny wyjątek.
+     * @param h Uchwyt węzła.
+     */
+    void czekaj(uchwyt h) const;
+
+    /**
+     * @brief Czeka na zakończenie wszystkich dodanych węzłów.
+     */
+    void czekaj_wszystkie();
+
+    /**
+     * @brief Eksportuje graf w formacie DOT (Graphviz).
+     * @return Opis grafu z nazwami, stanami i krawędziami węzłów.
+     */
+    string eksportuj_dot() const;
+
+    /**
+     * @brief Etap dodający skalar do każdego elementu.
+     * @param a Skalar do dodania.
+     * @return Etap potoku.
+     */
+    static etap etap_dodaj(int a);
+
+    /**
+     * @brief Etap mnożący każdy element przez skalar.
+     * @param a Skalar do mnożenia.
+     * @return Etap potoku.
+     */
+    static etap etap_mnoz(int a);
+
+    /**
+     * @brief Etap dodający odpowiadające elementy innej macierzy.
+     * @param m Macierz do dodania.
+     * @return Etap potoku.
+     */
+    static etap etap_dodaj(const matrix& m);
+
+    /**
+     * @brief Etap mnożący element po elemencie przez inną macierz.
+     * @param m Macierz do mnożenia.
+     * @return Etap potoku.
+     */
+    static etap etap_mnoz(const matrix& m);
+
+private:
+    /**
+     * @brief Stan węzła grafu.
+     */
+    enum stan { oczekuje, gotowy, wykonywany, zakonczony };
+
+    /**
+     * @brief Węzeł grafu.
+     */
+    struct wezel {
+        string nazwa; ///< Nazwa węzła
+        function<void()> f; ///< Zadanie
+        vector<uchwyt> zaleznosci; ///< Poprzedniki
+        vector<uchwyt> nastepniki; ///< Węzły czekające na ten węzeł
+        int brakujace; ///< Liczba niezakończonych poprzedników
+        stan s; ///< Bieżący stan
+        exception_ptr blad; ///< Wyjątek zgłoszony przez węzeł lub jego poprzednika
+        promise<void> obietnica; ///< Spełniana po zakończeniu węzła
+        shared_future<void> przyszlosc; ///< Przyszłość związana z obietnicą
+    };
+
+    static void przetworz(const matrix& wejscie, matrix& wyjscie, const vector<etap>& etapy);
+
+    void petla();
+    void zakoncz(uchwyt h);
+
+    vector<unique_ptr<wezel>> wezly; ///< Wszystkie węzły w kolejności dodania
+    deque<uchwyt> gotowe; ///< Węzły gotowe do wykonania
+    vector<thread> watki; ///< Wątki wykonujące węzły
+    mutable mutex mtx; ///< Chroni stan grafu
+    condition_variable praca; ///< Sygnał pojawienia się gotowego węzła
+    condition_variable wszystkie; ///< Sygnał zakończenia wszystkich węzłów
+    int niezakonczone; ///< Liczba węzłów, które jeszcze się nie zakończyły
+    bool zatrzymaj; ///< Flaga zakończenia pracy wątków
+};
+
+#endif // !GRAF_H
@@ -0,0 +1,610 @@
+/**
+ * @file kompresja.cpp
+ * @brief Implementacja macierzy zapisanej kaflami o zmiennej szerokości bitowej.
+ */
+
+#include "kompresja.h"
+#include "watki.h"
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <stdexcept>
+
+using namespace std;
+
+static const unsigned char SZEROKOSCI[7] = { 0, 1, 2, 4, 8, 16, 32 }; ///< Dozwolone szerokości różnic
+static const char NAGLOWEK[4] = { 'M', 'S', 'K', '1' }; ///< Początek pliku zapisz()
+
+/**
+ * @brief Zwraca pozycję szerokości w tablicy SZEROKOSCI.
+ * @param bity Szerokość.
+ * @return Pozycja lub -1, jeśli szerokość jest niedozwolona.
+ */
+static int pozycja_szerokosci(int bity) {
+	for (int i = 0; i < 7; i++) {
+		if (SZEROKOSCI[i] == bity) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief Najmniejsza dozwolona szerokość mieszcząca różnicę.
+ * @param roznica Największa różnica w kaflu.
+ * @return Szerokość w bitach.
+ */
+static unsigned char szerokosc(uint64_t roznica) {
+	for (int i = 0; i < 6; i++) {
+		if (roznica < (1ULL << SZEROKOSCI[i])) {
+			return SZEROKOSCI[i];
+		}
+	}
+	return 32;
+}
+
+/**
+ * @brief Rozpakowuje różnice i dodaje minimum.
+ *
+ * Szerokość jest parametrem szablonu, więc przesunięcia i maska są stałymi,
+ * a pętla jest wektoryzowana przez kompilator.
+ *
+ * @tparam W Szerokość różnicy w bitach.
+ * @param s Upakowane słowa.
+ * @param ile Liczba elementów.
+ * @param minimum Minimum kafla.
+ * @param wynik Bufor na ile elementów.
+ */
+template <int W>
+static void rozpakuj(const uint64_t* s, int ile, int minimum, int* wynik) {
+	if constexpr (W == 0) {
+		fill(wynik, wynik + ile, minimum);
+	}
+	else {
+		const int NA_SLOWO = 64 / W;
+		const uint64_t MASKA = (1ULL << W) - 1;
+		for (int i = 0; i < ile; i++) {
+			unsigned int d = (unsigned int)((s[i / NA_SLOWO] >> (i % NA_SLOWO * W)) & MASKA);
+			wynik[i] = (int)((unsigned int)minimum + d);
+		}
+	}
+}
+
+/**
+ * @brief Pakuje różnice elementów od minimum.
+ * @tparam W Szerokość różnicy w bitach.
+ * @param e Elementy.
+ * @param ile Liczba elementów.
+ * @param minimum Minimum kafla.
+ * @param s Wyzerowane słowa docelowe.
+ */
+template <int W>
+static void spakuj(const int* e, int ile, int minimum, uint64_t* s) {
+	if constexpr (W != 0) {
+		const int NA_SLOWO = 64 / W;
+		for (int i = 0; i < ile; i++) {
+			uint64_t d = (unsigned int)e[i] - (unsigned int)minimum;
+			s[i / NA_SLOWO] |= d << (i % NA_SLOWO * W);
+		}
+	}
+}
+
+/**
+ * @brief Sumuje różnice bezpośrednio w upakowanych słowach.
+ *
+ * Sąsiednie pola słowa są dodawane parami do pól dwa razy szerszych (W -> 2W -> ...
+ * -> 32 bity), więc 64 / W różnic jest sumowanych kilkoma operacjami na słowie.
+ * Bity za ostatnim elementem są zerowe i nie zmieniają sumy.
+ *
+ * @tparam W Szerokość różnicy w bitach.
+ * @param s Upakowane słowa.
+ * @param slowa Liczba słów.
+ * @return Suma różnic.
+ */
+template <int W>
+static uint64_t suma_roznic(const uint64_t* s, size_t slowa) {
+	static const uint64_t MASKI[5] = { 0x5555555555555555ULL, 0x3333333333333333ULL, 0x0F0F0F0F0F0F0F0FULL,
+		0x00FF00FF00FF00FFULL, 0x0000FFFF0000FFFFULL };
+	uint64_t suma = 0;
+	for (size_t k = 0; k < slowa; k++) {
+		uint64_t w = s[k];
+		for (int b = W, p = bit_width((unsigned int)W) - 1; b < 32; b *= 2, p++) {
+			w = (w & MASKI[p]) + ((w >> b) & MASKI[p]);
+		}
+		suma += (w & 0xFFFFFFFFULL) + (w >> 32);
+	}
+	return suma;
+}
+
+/**
+ * @brief Szuka największej różnicy w kaflu.
+ * @tparam W Szerokość różnicy w bitach (większa od 0).
+ * @param s Upakowane słowa.
+ * @param ile Liczba elementów.
+ * @return Największa różnica.
+ */
+template <int W>
+static unsigned int najwieksza_roznica(const uint64_t* s, int ile) {
+	const int NA_SLOWO = 64 / W;
+	const uint64_t MASKA = (1ULL << W) - 1;
+	unsigned int m = 0;
+	for (int i = 0; i < ile; i++) {
+		m = max(m, (unsigned int)((s[i / NA_SLOWO] >> (i % NA_SLOWO * W)) & MASKA));
+	}
+	return m;
+}
+
+/**
+ * @brief Wybiera wersję rozpakuj() dla szerokości.
+ */
+static void rozpakuj(int bity, const uint64_t* s, int ile, int minimum, int* wynik) {
+	switch (bity) {
+	case 0: rozpakuj<0>(s, ile, minimum, wynik); break;
+	case 1: rozpakuj<1>(s, ile, minimum, wynik); break;
+	case 2: rozpakuj<2>(s, ile, minimum, wynik); break;
+	case 4: rozpakuj<4>(s, ile, minimum, wynik); break;
+	case 8: rozpakuj<8>(s, ile, minimum, wynik); break;
+	case 16: rozpakuj<16>(s, ile, minimum, wynik); break;
+	default: rozpakuj<32>(s, ile, minimum, wynik); break;
+	}
+}
+
+/**
+ * @brief Wybiera wersję spakuj() dla szerokości.
+ */
+static void spakuj(int bity, const int* e, int ile, int minimum, uint64_t* s) {
+	switch (bity) {
+	case 0: spakuj<0>(e, ile, minimum, s); break;
+	case 1: spakuj<1>(e, ile, minimum, s); break;
+	case 2: spakuj<2>(e, ile, minimum, s); break;
+	case 4: spakuj<4>(e, ile, minimum, s); break;
+	case 8: spakuj<8>(e, ile, minimum, s); break;
+	case 16: spakuj<16>(e, ile, minimum, s); break;
+	default: spakuj<32>(e, ile, minimum, s); break;
+	}
+}
+
+/**
+ * @brief Wybiera wersję suma_roznic() dla szerokości.
+ */
+static uint64_t suma_roznic(int bity, const uint64_t* s, size_t slowa) {
+	switch (bity) {
+	case 0: return 0;
+	case 1: return suma_roznic<1>(s, slowa);
+	case 2: return suma_roznic<2>(s, slowa);
+	case 4: return suma_roznic<4>(s, slowa);
+	case 8: return suma_roznic<8>(s, slowa);
+	case 16: return suma_roznic<16>(s, slowa);
+	default: return suma_roznic<32>(s, slowa);
+	}
+}
+
+/**
+ * @brief Wybiera wersję najwieksza_roznica() dla szerokości.
+ */
+static unsigned int najwieksza_roznica(int bity, const uint64_t* s, int ile) {
+	switch (bity) {
+	case 0: return 0;
+	case 1: return najwieksza_roznica<1>(s, ile);
+	case 2: return najwieksza_roznica<2>(s, ile);
+	case 4: return najwieksza_roznica<4>(s, ile);
+	case 8: return najwieksza_roznica<8>(s, ile);
+	case 16: return najwieksza_roznica<16>(s, ile);
+	default: return najwieksza_roznica<32>(s, ile);
+	}
+}
+
+/**
+ * @brief Konstruktor tworzący macierz wypełnioną zerami (wszystkie kafle mają szerokość 0).
+ * @param size Rozmiar macierzy.
+ */
+macierz_skompresowana::macierz_skompresowana(int size) : n(size > 0 ? size : 0) {
+	size_t elementy = (size_t)n * n;
+	kafle.resize((elementy + KAFEL - 1) / KAFEL);
+}
+
+/**
+ * @brief Liczba elementów w kaflu (ostatni może być niepełny).
+ * @param k Numer kafla.
+ * @return Liczba elementów.
+ */
+size_t macierz_skompresowana::dlugosc(size_t k) const {
+	return min((size_t)KAFEL, (size_t)n * n - k * KAFEL);
+}
+
+/**
+ * @brief Rozpakowuje kafel do bufora.
+ * @param k Numer kafla.
+ * @param bufor Bufor na KAFEL elementów.
+ */
+void macierz_skompresowana::dekoduj(size_t k, int* bufor) const {
+	const kafel& t = kafle[k];
+	rozpakuj(t.bity, t.slowa.data(), (int)dlugosc(k), t.minimum, bufor);
+}
+
+/**
+ * @brief Koduje kafel z bufora, dobierając minimum i najmniejszą wystarczającą szerokość.
+ * @param k Numer kafla.
+ * @param bufor Elementy kafla.
+ */
+void macierz_skompresowana::koduj(size_t k, const int* bufor) {
+	int ile = (int)dlugosc(k);
+	int mn = bufor[0];
+	int mx = bufor[0];
+	for (int i = 1; i < ile; i++) {
+		mn = min(mn, bufor[i]);
+		mx = max(mx, bufor[i]);
+	}
+	kafel& t = kafle[k];
+	t.minimum = mn;
+	t.bity = szerokosc((uint64_t)((long long)mx - mn));
+	t.slowa.assign(((size_t)ile * t.bity + 63) / 64, 0);
+	spakuj(t.bity, bufor, ile, mn, t.slowa.data());
+}
+
+/**
+ * @brief Kompresuje macierz (kafle są dzielone między wątki puli).
+ * @param m Macierz źródłowa.
+ * @return Macierz skompresowana.
+ */
+macierz_skompresowana macierz_skompresowana::z_macierzy(const matrix& m) {
+	macierz_skompresowana w(m.n);
+	int n = m.n;
+	pula_watkow::globalna().rownolegle((int)w.kafle.size(), [&](int od, int do_, int) {
+		int bufor[KAFEL];
+		for (int k = od; k < do_; k++) {
+			size_t poczatek = (size_t)k * KAFEL;
+			int ile = (int)w.dlugosc(k);
+			for (int i = 0; i < ile; i++) {
+				size_t e = poczatek + i;
+				bufor[i] = m.data[e / n][e % n];
+			}
+			w.koduj(k, bufor);
+		}
+	}, 4);
+	return w;
+}
+
+/**
+ * @brief Dekompresuje macierz.
+ * @return Nowa macierz.
+ */
+matrix macierz_skompresowana::do_macierzy() const {
+	matrix m(n);
+	pula_watkow::globalna().rownolegle((int)kafle.size(), [&](int od, int do_, int) {
+		int bufor[KAFEL];
+		for (int k = od; k < do_; k++) {
+			dekoduj(k, bufor);
+			size_t poczatek = (size_t)k * KAFEL;
+			int ile = (int)dlugosc(k);
+			for (int i = 0; i < ile; i++) {
+				size_t e = poczatek + i;
+				m.data[e / n][e % n] = bufor[i];
+			}
+		}
+	}, 4);
+	return m;
+}
+
+/**
+ * @brief Zwraca rozmiar macierzy.
+ * @return Rozmiar n.
+ */
+int macierz_skompresowana::rozmiar() const {
+	return n;
+}
+
+/**
+ * @brief Pobiera wartość z macierzy (rozpakowuje jedną różnicę).
+ * @param x Indeks wiersza.
+ * @param y Indeks kolumny.
+ * @return Wartość lub 0 poza zakresem.
+ */
+int macierz_skompresowana::pokaz(int x, int y) const {
+	if (x < 0 || x >= n || y < 0 || y >= n) {
+		return 0;
+	}
+	size_t e = (size_t)x * n + y;
+	const kafel& t = kafle[e / KAFEL];
+	if (t.bity == 0) {
+		return t.minimum;
+	}
+	size_t i = e % KAFEL;
+	int na_slowo = 64 / t.bity;
+	uint64_t d = (t.slowa[i / na_slowo] >> (i % na_slowo * t.bity)) & ((1ULL << t.bity) - 1);
+	return (int)((unsigned int)t.minimum + (unsigned int)d);
+}
+
+/**
+ * @brief Wstawia wartość.
+ * @param x Indeks wiersza.
+ * @param y Indeks kolumny.
+ * @param wartosc Wartość do wstawienia.
+ * @return Referencja do macierzy.
+ */
+macierz_skompresowana& macierz_skompresowana::wstaw(int x, int y, int wartosc) {
+	if (x < 0 || x >= n || y < 0 || y >= n) {
+		return *this;
+	}
+	size_t e = (size_t)x * n + y;
+	int bufor[KAFEL];
+	dekoduj(e / KAFEL, bufor);
+	bufor[e % KAFEL] = wartosc;
+	koduj(e / KAFEL, bufor);
+	return *this;
+}
+
+/**
+ * @brief Dodaje skalar do każdego elementu.
+ *
+ * Różnice od minimum się nie zmieniają, więc wystarczy przesunąć minimum. Gdy
+ * największy możliwy element kafla przekroczyłby zakres int, kafel jest
+ * rozpakowywany, wartości zawijane i kodowane ponownie.
+ *
+ * @param a Skalar.
+ * @return Referencja do macierzy.
+ */
+macierz_skompresowana& macierz_skompresowana::operator+=(int a) {
+	pula_watkow::globalna().rownolegle((int)kafle.size(), [&](int od, int do_, int) {
+		int bufor[KAFEL];
+		for (int k = od; k < do_; k++) {
+			kafel& t = kafle[k];
+			long long dolna = (long long)t.minimum + a;
+			long long gorna = dolna + (long long)((1ULL << t.bity) - 1);
+			if (dolna >= INT_MIN && gorna <= INT_MAX) {
+				t.minimum = (int)dolna;
+				continue;
+			}
+			dekoduj(k, bufor);
+			int ile = (int)dlugosc(k);
+			for (int i = 0; i < ile; i++) {
+				bufor[i] = (int)((unsigned int)bufor[i] + (unsigned int)a);
+			}
+			koduj(k, bufor);
+		}
+	}, 4);
+	return *this;
+}
+
+/**
+ * @brief Odejmuje skalar od każdego elementu.
+ * @param a Skalar.
+ * @return Referencja do macierzy.
+ */
+macierz_skompresowana& macierz_skompresowana::operator-=(int a) {
+	return *this += (int)(0U - (unsigned int)a);
+}
+
+/**
+ * @brief Mnoży każdy element przez skalar.
+ * @param a Skalar.
+ * @return Referencja do macierzy.
+ */
+macierz_skompresowana& macierz_skompresowana::operator*=(int a) {
+	if (a == 1) {
+		return *this;
+	}
+	pula_watkow::globalna().rownolegle((int)kafle.size(), [&](int od, int do_, int) {
+		int bufor[KAFEL];
+		for (int k = od; k < do_; k++) {
+			dekoduj(k, bufor);
+			int ile = (int)dlugosc(k);
+			for (int i = 0; i < ile; i++) {
+				bufor[i] = (int)((unsigned int)bufor[i] * (unsigned int)a);
+			}
+			koduj(k, bufor);
+		}
+	}, 4);
+	return *this;
+}
+
+/**
+ * @brief Dodaje macierz element po elemencie.
+ * @param m Druga macierz.
+ * @return Referencja do macierzy.
+ * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+ */
+macierz_skompresowana& macierz_skompresowana::operator+=(const macierz_skompresowana& m) {
+	if (n != m.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	pula_watkow::globalna().rownolegle((int)kafle.size(), [&](int od, int do_, int) {
+		int bufor[KAFEL];
+		int drugi[KAFEL];
+		for (int k = od; k < do_; k++) {
+			dekoduj(k, bufor);
+			m.dekoduj(k, drugi);
+			int ile = (int)dlugosc(k);
+			for (int i = 0; i < ile; i++) {
+				bufor[i] = (int)((unsigned int)bufor[i] + (unsigned int)drugi[i]);
+			}
+			koduj(k, bufor);
+		}
+	}, 4);
+	return *this;
+}
+
+/**
+ * @brief Mnoży macierz element po elemencie.
+ * @param m Druga macierz.
+ * @return Referencja do macierzy.
+ * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+ */
+macierz_skompresowana& macierz_skompresowana::operator*=(const macierz_skompresowana& m) {
+	if (n != m.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	pula_watkow::globalna().rownolegle((int)kafle.size(), [&](int od, int do_, int) {
+		int bufor[KAFEL];
+		int drugi[KAFEL];
+		for (int k = od; k < do_; k++) {
+			dekoduj(k, bufor);
+			m.dekoduj(k, drugi);
+			int ile = (int)dlugosc(k);
+			for (int i = 0; i < ile; i++) {
+				bufor[i] = (int)((unsigned int)bufor[i] * (unsigned int)drugi[i]);
+			}
+			koduj(k, bufor);
+		}
+	}, 4);
+	return *this;
+}
+
+/**
+ * @brief Suma elementów.
+ *
+ * Element kafla to minimum + różnica bez przepełnienia, więc suma kafla to
+ * liczba elementów * minimum + suma różnic.
+ *
+ * @return Suma (64 bity).
+ */
+long long macierz_skompresowana::suma() const {
+	long long s = 0;
+	for (size_t k = 0; k < kafle.size(); k++) {
+		const kafel& t = kafle[k];
+		s += (long long)dlugosc(k) * t.minimum + (long long)suma_roznic(t.bity, t.slowa.data(), t.slowa.size());
+	}
+	return s;
+}
+
+/**
+ * @brief Najmniejszy element.
+ * @return Minimum (0 dla macierzy pustej).
+ */
+int macierz_skompresowana::minimum() const {
+	if (kafle.empty()) {
+		return 0;
+	}
+	int m = kafle[0].minimum;
+	for (size_t k = 1; k < kafle.size(); k++) {
+		m = min(m, kafle[k].minimum);
+	}
+	return m;
+}
+
+/**
+ * @brief Największy element (minimum kafla + największa różnica).
+ * @return Maksimum (0 dla macierzy pustej).
+ */
+int macierz_skompresowana::maksimum() const {
+	long long m = LLONG_MIN;
+	for (size_t k = 0; k < kafle.size(); k++) {
+		const kafel& t = kafle[k];
+		m = max(m, (long long)t.minimum + najwieksza_roznica(t.bity, t.slowa.data(), (int)dlugosc(k)));
+	}
+	return kafle.empty() ? 0 : (int)m;
+}
+
+/**
+ * @brief Porównuje dwie macierze (kafle są kodowane jednoznacznie, więc porównywane bez rozpakowania).
+ * @param m Macierz do porównania.
+ * @return True, jeśli macierze są równe.
+ */
+bool macierz_skompresowana::operator==(const macierz_skompresowana& m) const {
+	if (n != m.n) {
+		return false;
+	}
+	for (size_t k = 0; k < kafle.size(); k++) {
+		const kafel& a = kafle[k];
+		const kafel& b = m.kafle[k];
+		if (a.minimum != b.minimum || a.bity != b.bity || a.slowa != b.slowa) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Zwraca zużycie pamięci.
+ * @return Zajętość w pamięci i na dysku.
+ */
+macierz_skompresowana::zajetosc macierz_skompresowana::zuzycie() const {
+	zajetosc z;
+	z.w_pamieci = sizeof(*this) + kafle.size() * sizeof(kafel);
+	z.na_dysku = sizeof(NAGLOWEK) + sizeof(int);
+	z.bez_kompresji = (size_t)n * n * sizeof(int) + (size_t)n * sizeof(int*);
+	fill(z.kafle, z.kafle + 7, (size_t)0);
+	for (size_t k = 0; k < kafle.size(); k++) {
+		const kafel& t = kafle[k];
+		z.w_pamieci += t.slowa.size() * sizeof(uint64_t);
+		z.na_dysku += sizeof(int) + 1 + (dlugosc(k) * t.bity + 7) / 8;
+		z.kafle[pozycja_szerokosci(t.bity)]++;
+	}
+	return z;
+}
+
+/**
+ * @brief Zapisuje macierz.
+ *
+ * Format: "MSK1", n (int32), potem dla każdego kafla minimum (int32), szerokość
+ * (1 bajt) i ceil(liczba elementów * szerokość / 8) bajtów różnic (słowa od
+ * najmłodszego bajtu). Liczby całkowite są zapisywane od najmłodszego bajtu.
+ *
+ * @param o Strumień wyjściowy (binarny).
+ */
+void macierz_skompresowana::zapisz(ostream& o) const {
+	vector<char> bajty(NAGLOWEK, NAGLOWEK + sizeof(NAGLOWEK));
+	auto liczba = [&bajty](unsigned int v) {
+		for (int b = 0; b < 4; b++) {
+			bajty.push_back((char)((v >> (8 * b)) & 0xFF));
+		}
+	};
+	liczba((unsigned int)n);
+	for (size_t k = 0; k < kafle.size(); k++) {
+		const kafel& t = kafle[k];
+		liczba((unsigned int)t.minimum);
+		bajty.push_back((char)t.bity);
+		size_t ile = (dlugosc(k) * t.bity + 7) / 8;
+		for (size_t b = 0; b < ile; b++) {
+			bajty.push_back((char)((t.slowa[b / 8] >> (8 * (b % 8))) & 0xFF));
+		}
+	}
+	o.write(bajty.data(), (streamsize)bajty.size());
+}
+
+/**
+ * @brief Wczytuje macierz zapisaną przez zapisz().
+ * @param i Strumień wejściowy (binarny).
+ * @return Macierz skompresowana.
+ * @throws std::runtime_error Jeśli dane są niepoprawne.
+ */
+macierz_skompresowana macierz_skompresowana::wczytaj(istream& i) {
+	auto bajt = [&i]() {
+		char c;
+		if (!i.get(c)) {
+			throw runtime_error("Invalid compressed matrix data");
+		}
+		return (unsigned char)c;
+	};
+	auto liczba = [&bajt]() {
+		unsigned int v = 0;
+		for (int b = 0; b < 4; b++) {
+			v |= (unsigned int)bajt() << (8 * b);
+		}
+		return v;
+	};
+	for (size_t b = 0; b < sizeof(NAGLOWEK); b++) {
+		if (bajt() != (unsigned char)NAGLOWEK[b]) {
+			throw runtime_error("Invalid compressed matrix data");
+		}
+	}
+	int n = (int)liczba();
+	if (n < 0) {
+		throw runtime_error("Invalid compressed matrix data");
+	}
+	macierz_skompresowana w(n);
+	for (size_t k = 0; k < w.kafle.size(); k++) {
+		kafel& t = w.kafle[k];
+		t.minimum = (int)liczba();
+		t.bity = bajt();
+		if (pozycja_szerokosci(t.bity) < 0) {
+			throw runtime_error("Invalid compressed matrix data");
+		}
+		size_t ile = (w.dlugosc(k) * t.bity + 7) / 8;
+		t.slowa.assign((ile + 7) / 8, 0);
+		for (size_t b = 0; b < ile; b++) {
+			t.slowa[b / 8] |= (uint64_t)bajt() << (8 * (b % 8));
+		}
+	}
+	return w;
+}
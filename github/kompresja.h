@@ -0,0 +1,186 @@
+#pragma once
+#ifndef KOMPRESJA_H
+#define KOMPRESJA_H
+
+#include "matrix.h"
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+/**
+ * @class macierz_skompresowana
+ * @brief Macierz n x n zapisana kaflami z odniesieniem do minimum kafla.
+ *
+ * Elementy (wierszami) są dzielone na kafle po KAFEL elementów. Kafel przechowuje
+ * swoje minimum oraz różnice elementów od minimum, upakowane po 0, 1, 2, 4, 8, 16 lub 32
+ * bity - najmniej, ile wystarcza dla zakresu wartości w kaflu. Dla wartości 0-9
+ * (jak z losuj()) element zajmuje 4 bity zamiast 32.
+ *
+ * Operacje dekodują kafel do bufora mieszczącego się w L1, wykonują działanie
+ * i kodują wynik ponownie, dobierając szerokość od nowa - wynik wychodzący poza
+ * dotychczasowy zakres automatycznie dostaje szerszy zapis. Arytmetyka zawija się
+ * modulo 2^32 tak jak w klasie matrix.
+ */
+class macierz_skompresowana {
+public:
+    static const int KAFEL = 1024; ///< Liczba elementów w kaflu
+
+    /**
+     * @brief Zużycie pamięci.
+     */
+    struct zajetosc {
+        size_t w_pamieci; ///< Bajty w pamięci (słowa i opisy kafli)
+        size_t na_dysku; ///< Bajty pliku tworzonego przez zapisz()
+        size_t bez_kompresji; ///< Bajty tej samej macierzy w klasie matrix
+        size_t kafle[7]; ///< Liczba kafli o szerokości 0, 1, 2, 4, 8, 16, 32 bity
+    };
+
+    /**
+     * @brief Konstruktor tworzący macierz wypełnioną zerami.
+     * @param size Rozmiar macierzy.
+     */
+    explicit macierz_skompresowana(int size = 0);
+
+    /**
+     * @brief Kompresuje macierz.
+     * @param m Macierz źródłowa.
+     * @return Macierz skompresowana.
+     */
+    static macierz_skompresowana z_macierzy(const matrix& m);
+
+    /**
+     * @brief Dekompresuje macierz.
+     * @return Nowa macierz.
+     */
+    matrix do_macierzy() const;
+
+    /**
+     * @brief Zwraca rozmiar macierzy.
+     * @return Rozmiar n.
+     */
+    int rozmiar() const;
+
+    /**
+     * @brief Pobiera wartość z macierzy.
+     * @param x Indeks wiersza.
+     * @param y Indeks kolumny.
+     * @return Wartość lub 0 poza zakresem.
+     */
+    int pokaz(int x, int y) const;
+
+    /**
+     * @brief Wstawia wartość (koduje ponownie jeden kafel).
+     * @param x Indeks wiersza.
+     * @param y Indeks kolumny.
+     * @param wartosc Wartość do wstawienia.
+     * @return Referencja do macierzy.
+     */
+    macierz_skompresowana& wstaw(int x, int y, int wartosc);
+
+    /**
+     * @brief Dodaje skalar do każdego elementu.
+     *
+     * Zmienia tylko minima kafli; kafel jest kodowany ponownie jedynie wtedy,
+     * gdy jego wartości przekroczyłyby zakres int.
+     *
+     * @param a Skalar.
+     * @return Referencja do macierzy.
+     */
+    macierz_skompresowana& operator+=(int a);
+
+    /**
+     * @brief Odejmuje skalar od każdego elementu.
+     * @param a Skalar.
+     * @return Referencja do macierzy.
+     */
+    macierz_skompresowana& operator-=(int a);
+
+    /**
+     * @brief Mnoży każdy element przez skalar.
+     * @param a Skalar.
+     * @return Referencja do macierzy.
+     */
+    macierz_skompresowana& operator*=(int a);
+
+    /**
+     * @brief Dodaje macierz element po elemencie.
+     * @param m Druga macierz.
+     * @return Referencja do macierzy.
+     * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+     */
+    macierz_skompresowana& operator+=(const macierz_skompresowana& m);
+
+    /**
+     * @brief Mnoży macierz element po elemencie.
+     * @param m Druga macierz.
+     * @return Referencja do macierzy.
+     * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+     */
+    macierz_skompresowana& operator*=(const macierz_skompresowana& m);
+
+    /**
+     * @brief Suma elementów (czyta tylko upakowane różnice i minima kafli).
+     * @return Suma (64 bity).
+     */
+    long long suma() const;
+
+    /**
+     * @brief Najmniejszy element (z samych minimów kafli, bez dekodowania).
+     * @return Minimum (0 dla macierzy pustej).
+     */
+    int minimum() const;
+
+    /**
+     * @brief Największy element.
+     * @return Maksimum (0 dla macierzy pustej).
+     */
+    int maksimum() const;
+
+    /**
+     * @brief Porównuje dwie macierze.
+     * @param m Macierz do porównania.
+     * @return True, jeśli macierze są równe.
+     */
+    bool operator==(const macierz_skompresowana& m) const;
+
+    /**
+     * @brief Zwraca zużycie pamięci.
+     * @return Zajętość w pamięci i na dysku.
+     */
+    zajetosc zuzycie() const;
+
+    /**
+     * @brief Zapisuje macierz w postaci skompresowanej (format binarny).
+     * @param o Strumień wyjściowy (binarny).
+     */
+    void zapisz(ostream& o) const;
+
+    /**
+     * @brief Wczytuje macierz zapisaną przez zapisz().
+     * @param i Strumień wejściowy (binarny).
+     * @return Macierz skompresowana.
+     * @throws std::runtime_error Jeśli dane są niepoprawne.
+     */
+    static macierz_skompresowana wczytaj(istream& i);
+
+private:
+    /**
+     * @brief Kafel: minimum i upakowane różnice.
+     */
+    struct kafel {
+        int minimum = 0; ///< Najmniejszy element kafla
+        unsigned char bity = 0; ///< Szerokość różnicy w bitach
+        vector<uint64_t> slowa; ///< Upakowane różnice
+    };
+
+    int n; ///< Rozmiar macierzy (n x n)
+    vector<kafel> kafle; ///< Kafle w kolejności elementów
+
+    size_t dlugosc(size_t k) const;
+    void dekoduj(size_t k, int* bufor) const;
+    void koduj(size_t k, const int* bufor);
+};
+
+#endif // !KOMPRESJA_H
@@ -0,0 +1,265 @@
+/**
+ * @file lu.cpp
+ * @brief Implementacja rozkładu LU oraz opartych na nim operacji.
+ */
+
+#include "lu.h"
+#include "strojenie.h"
+#include "watki.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Konstruktor z macierzy całkowitoliczbowej.
+ *
+ * Kopiuje elementy macierzy do tablicy liczb zmiennoprzecinkowych i wykonuje rozkład.
+ *
+ * @param m Macierz do rozłożenia.
+ * @param blok Szerokość bloku kolumn.
+ */
+rozklad_lu::rozklad_lu(const matrix& m, int blok) : n(m.n), lu((size_t)m.n * m.n), piwoty(m.n), znak(1), osobliwa_(false) {
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			lu[(size_t)i * n + j] = m.data[i][j];
+		}
+	}
+	rozloz(blok);
+}
+
+/**
+ * @brief Konstruktor z tablicy liczb zmiennoprzecinkowych.
+ *
+ * Tablica `t` jest interpretowana jako elementy macierzy w kolejności wiersz po wierszu.
+ *
+ * @param size Rozmiar macierzy (n x n).
+ * @param t Tablica n*n elementów.
+ * @param blok Szerokość bloku kolumn.
+ */
+rozklad_lu::rozklad_lu(int size, const double* t, int blok) : n(size), lu(t, t + (size_t)size * size), piwoty(size), znak(1), osobliwa_(false) {
+	rozloz(blok);
+}
+
+/**
+ * @brief Liczba kolumn paska U12, tak aby pasek (blok wierszy) zajmował około kb KB.
+ * @param blok Szerokość bloku kolumn (liczba wierszy U12).
+ * @param kb Rozmiar paska w KB.
+ * @return Szerokość paska (wielokrotność 16, co najmniej 16).
+ */
+static int szerokosc_paska(int blok, int kb) {
+	int s = (int)((long long)kb * 1024 / sizeof(double) / blok);
+	s -= s % 16;
+	return s < 16 ? 16 : s;
+}
+
+/**
+ * @brief Wykonuje blokowy rozkład LU w miejscu.
+ *
+ * Dla każdego bloku kolumn:
+ * - panel jest rozkładany kolumna po kolumnie z wyborem największego co do modułu
+ *   elementu głównego (zamieniane są całe wiersze),
+ * - wiersze bloku na prawo od panelu są rozwiązywane względem L11,
+ * - pozostała część macierzy jest aktualizowana (A22 -= L21 * U12) równolegle po wierszach.
+ * Aktualizacja A22 wykonuje niemal całą pracę i przechodzi po pamięci w kolejności i-k-j,
+ * paskami kolumn (szerokość z parametru pasek_kb strojenia, jak w iloczynie macierzy):
+ * pasek U12 (blok wierszy) zostaje w pamięci podręcznej dla wszystkich wierszy wątku,
+ * zamiast czytać cały panel U12 od nowa dla każdego wiersza. Wiersze U12 są brane
+ * po cztery, więc fragment aktualizowanego wiersza jest czytany i zapisywany raz
+ * na cztery wiersze panelu.
+ *
+ * @param blok Szerokość bloku kolumn.
+ */
+void rozklad_lu::rozloz(int blok) {
+	if (blok < 1) {
+		blok = 1;
+	}
+	iota(piwoty.begin(), piwoty.end(), 0);
+	double* a = lu.data();
+	int pasek = szerokosc_paska(blok, strojenie::biezace().pasek_kb);
+
+	for (int kb = 0; kb < n; kb += blok) {
+		int ke = min(kb + blok, n);
+
+		for (int j = kb; j < ke; j++) {
+			int p = j;
+			double maks = fabs(a[(size_t)j * n + j]);
+			for (int i = j + 1; i < n; i++) {
+				double v = fabs(a[(size_t)i * n + j]);
+				if (v > maks) {
+					maks = v;
+					p = i;
+				}
+			}
+			if (p != j) {
+				swap_ranges(a + (size_t)p * n, a + (size_t)p * n + n, a + (size_t)j * n);
+				swap(piwoty[p], piwoty[j]);
+				znak = -znak;
+			}
+			if (maks == 0.0) {
+				osobliwa_ = true;
+				continue;
+			}
+
+			const double* wj = a + (size_t)j * n;
+			double odwrotnosc = 1.0 / wj[j];
+			for (int i = j + 1; i < n; i++) {
+				double* wi = a + (size_t)i * n;
+				double l = wi[j] *= odwrotnosc;
+				if (l != 0.0) {
+					for (int c = j + 1; c < ke; c++) {
+						wi[c] -= l * wj[c];
+					}
+				}
+			}
+		}
+		if (ke == n) {
+			break;
+		}
+
+		for (int i = kb + 1; i < ke; i++) {
+			double* wi = a + (size_t)i * n;
+			for (int p = kb; p < i; p++) {
+				double l = wi[p];
+				if (l != 0.0) {
+					const double* wp = a + (size_t)p * n;
+					for (int c = ke; c < n; c++) {
+						wi[c] -= l * wp[c];
+					}
+				}
+			}
+		}
+
+		pula_watkow::globalna().rownolegle(n - ke, [&](int od, int do_, int) {
+			for (int cc = ke; cc < n; cc += pasek) {
+				int ck = min(cc + pasek, n);
+				for (int i = ke + od; i < ke + do_; i++) {
+					double* wi = a + (size_t)i * n;
+					int p = kb;
+					for (; p + 4 <= ke; p += 4) {
+						double l0 = wi[p], l1 = wi[p + 1], l2 = wi[p + 2], l3 = wi[p + 3];
+						const double* w0 = a + (size_t)p * n;
+						const double* w1 = w0 + n;
+						const double* w2 = w1 + n;
+						const double* w3 = w2 + n;
+						for (int c = cc; c < ck; c++) {
+							wi[c] -= l0 * w0[c] + l1 * w1[c] + l2 * w2[c] + l3 * w3[c];
+						}
+					}
+					for (; p < ke; p++) {
+						double l = wi[p];
+						if (l != 0.0) {
+							const double* wp = a + (size_t)p * n;
+							for (int c = cc; c < ck; c++) {
+								wi[c] -= l * wp[c];
+							}
+						}
+					}
+				}
+			}
+		}, 16);
+	}
+}
+
+/**
+ * @brief Zwraca rozmiar rozłożonej macierzy.
+ * @return Rozmiar n.
+ */
+int rozklad_lu::rozmiar() const {
+	return n;
+}
+
+/**
+ * @brief Sprawdza, czy podczas rozkładu napotkano zerowy element główny.
+ * @return True, jeśli macierz jest osobliwa.
+ */
+bool rozklad_lu::osobliwa() const {
+	return osobliwa_;
+}
+
+/**
+ * @brief Oblicza wyznacznik jako iloczyn przekątnej U ze znakiem permutacji.
+ * @return Wyznacznik macierzy (0 dla macierzy osobliwej).
+ */
+double rozklad_lu::wyznacznik() const {
+	if (osobliwa_) {
+		return 0.0;
+	}
+	double w = znak;
+	for (int i = 0; i < n; i++) {
+		w *= lu[(size_t)i * n + i];
+	}
+	return w;
+}
+
+/**
+ * @brief Rozwiązuje układ równań AX = B.
+ *
+ * Wiersze B są najpierw permutowane zgodnie z rozkładem, a następnie wykonywane jest
+ * podstawianie w przód (L) i wstecz (U). Kolumny prawych stron są niezależne, więc
+ * przy wielu prawych stronach dzielone są między wątki puli.
+ *
+ * @param b Tablica n x k (wierszami); nadpisywana rozwiązaniem X.
+ * @param k Liczba prawych stron.
+ * @throws std::runtime_error Jeśli macierz jest osobliwa.
+ */
+void rozklad_lu::rozwiaz(double* b, int k) const {
+	if (osobliwa_) {
+		throw runtime_error("Matrix is singular");
+	}
+	vector<double> x((size_t)n * k);
+	for (int i = 0; i < n; i++) {
+		copy(b + (size_t)piwoty[i] * k, b + (size_t)piwoty[i] * k + k, x.begin() + (size_t)i * k);
+	}
+
+	const double* a = lu.data();
+	double* px = x.data();
+	pula_watkow::globalna().rownolegle(k, [&](int od, int do_, int) {
+		for (int i = 1; i < n; i++) {
+			double* xi = px + (size_t)i * k;
+			for (int p = 0; p < i; p++) {
+				double l = a[(size_t)i * n + p];
+				if (l != 0.0) {
+					const double* xp = px + (size_t)p * k;
+					for (int c = od; c < do_; c++) {
+						xi[c] -= l * xp[c];
+					}
+				}
+			}
+		}
+		for (int i = n - 1; i >= 0; i--) {
+			double* xi = px + (size_t)i * k;
+			for (int p = i + 1; p < n; p++) {
+				double u = a[(size_t)i * n + p];
+				if (u != 0.0) {
+					const double* xp = px + (size_t)p * k;
+					for (int c = od; c < do_; c++) {
+						xi[c] -= u * xp[c];
+					}
+				}
+			}
+			double odwrotnosc = 1.0 / a[(size_t)i * n + i];
+			for (int c = od; c < do_; c++) {
+				xi[c] *= odwrotnosc;
+			}
+		}
+	}, 8);
+
+	copy(x.begin(), x.end(), b);
+}
+
+/**
+ * @brief Oblicza macierz odwrotną przez rozwiązanie układu z macierzą jednostkową.
+ * @return Tablica n x n (wierszami) z macierzą odwrotną.
+ * @throws std::runtime_error Jeśli macierz jest osobliwa.
+ */
+vector<double> rozklad_lu::odwrotna() const {
+	vector<double> wynik((size_t)n * n, 0.0);
+	for (int i = 0; i < n; i++) {
+		wynik[(size_t)i * n + i] = 1.0;
+	}
+	rozwiaz(wynik.data(), n);
+	return wynik;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#ifndef LU_H
+#define LU_H
+
+#include "matrix.h"
+#include <vector>
+using namespace std;
+
+/**
+ * @class rozklad_lu
+ * @brief Rozkład LU macierzy z częściowym wyborem elementu głównego (PA = LU).
+ *
+ * Rozkład jest liczony blokowo w arytmetyce zmiennoprzecinkowej, a aktualizacja
+ * pozostałej części macierzy po każdym bloku jest dzielona między wątki puli.
+ * Na rozkładzie opierają się wyznacznik, rozwiązywanie układów równań i odwracanie.
+ */
+class rozklad_lu {
+private:
+    int n; ///< Rozmiar macierzy (n x n)
+    vector<double> lu; ///< Czynniki L (pod przekątną, jedynki na przekątnej pominięte) i U, wierszami
+    vector<int> piwoty; ///< piwoty[i] - wiersz macierzy wejściowej, który trafił na pozycję i
+    int znak; ///< Znak permutacji wierszy (+1 lub -1)
+    bool osobliwa_; ///< Czy napotkano zerowy element główny
+
+    void rozloz(int blok);
+
+public:
+    /**
+     * @brief Rozkłada podaną macierz.
+     * @param m Macierz do rozłożenia.
+     * @param blok Szerokość bloku kolumn.
+     */
+    explicit rozklad_lu(const matrix& m, int blok = 64);
+
+    /**
+     * @brief Rozkłada macierz podaną jako tablica wierszami.
+     * @param size Rozmiar macierzy.
+     * @param t Wskaźnik na tablicę n*n elementów.
+     * @param blok Szerokość bloku kolumn.
+     */
+    rozklad_lu(int size, const double* t, int blok = 64);
+
+    /**
+     * @brief Zwraca rozmiar rozłożonej macierzy.
+     * @return Rozmiar n.
+     */
+    int rozmiar() const;
+
+    /**
+     * @brief Sprawdza, czy macierz jest osobliwa.
+     * @return True, jeśli macierz jest osobliwa.
+     */
+    bool osobliwa() const;
+
+    /**
+     * @brief Oblicza wyznacznik z rozkładu.
+     * @return Wyznacznik macierzy.
+     */
+    double wyznacznik() const;
+
+    /**
+     * @brief Rozwiązuje układ AX = B dla wielu prawych stron.
+     * @param b Tablica n x k (wierszami); nadpisywana rozwiązaniem X.
+     * @param k Liczba prawych stron.
+     */
+    void rozwiaz(double* b, int k = 1) const;
+
+    /**
+     * @brief Oblicza macierz odwrotną.
+     * @return Tablica n x n (wierszami) z macierzą odwrotną.
+     */
+    vector<double> odwrotna() const;
+};
+
+#endif // !LU_H
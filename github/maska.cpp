@@ -0,0 +1,458 @@
+/**
+ * @file maska.cpp
+ * @brief Implementacja masek logicznych i operacji maskowanych.
+ */
+
+#include "maska.h"
+#include "watki.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Konstruktor prywatny.
+ * @param size Rozmiar maski.
+ * @param rodz Sposób przechowywania.
+ */
+maska::maska(int size, rodzaj rodz) : n(size > 0 ? size : 0), r(rodz), dolne(0), gorne(0) {}
+
+/**
+ * @brief Zwraca wiersz maski.
+ *
+ * Maska ogólna zwraca wskaźnik na zapamiętany wiersz, szachownica jeden z dwóch
+ * wzorców, a wiersz pasma jest wypełniany w buforze porównaniami bez rozgałęzień.
+ *
+ * @param i Indeks wiersza.
+ * @param bufor Bufor n elementów.
+ * @return Wskaźnik na n elementów maski.
+ */
+const int* maska::wiersz(int i, int* bufor) const {
+	switch (r) {
+	case szachownica_:
+		return dane.data() + (size_t)(i % 2) * n;
+	case pasmo_: {
+		int od = i - dolne;
+		int do_ = i + gorne;
+		for (int j = 0; j < n; j++) {
+			bufor[j] = -(int)((j >= od) & (j <= do_));
+		}
+		return bufor;
+	}
+	default:
+		return dane.data() + (size_t)i * n;
+	}
+}
+
+/**
+ * @brief Wywołuje f(i, wiersz_maski) dla każdego wiersza, dzieląc wiersze między wątki puli.
+ * @param rozmiar Rozmiar macierzy, na której działa operacja.
+ * @param f Funkcja wiersza.
+ * @throws std::invalid_argument Jeśli rozmiar maski jest inny niż rozmiar macierzy.
+ */
+template <class F>
+void maska::dla_wierszy(int rozmiar, F f) const {
+	if (rozmiar != n) {
+		throw invalid_argument("Mask and matrix dimensions mismatch");
+	}
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int watek) {
+		vector<int> bufor(r == pasmo_ ? n : 0);
+		for (int i = od; i < do_; i++) {
+			f(i, wiersz(i, bufor.data()), watek);
+		}
+	});
+}
+
+/**
+ * @brief Tworzy maskę szachownicy.
+ *
+ * Przechowywane są tylko dwa wzorce wierszy: dla wierszy parzystych i nieparzystych.
+ *
+ * @param size Rozmiar maski.
+ * @param parzyste True - wybrane są pola o parzystej sumie indeksów.
+ * @return Maska.
+ */
+maska maska::szachownica(int size, bool parzyste) {
+	maska m(size, szachownica_);
+	m.dane.resize((size_t)2 * m.n);
+	for (int w = 0; w < 2; w++) {
+		for (int j = 0; j < m.n; j++) {
+			m.dane[(size_t)w * m.n + j] = (((w + j) % 2 == 0) == parzyste) ? -1 : 0;
+		}
+	}
+	return m;
+}
+
+/**
+ * @brief Tworzy maskę pasma przekątnych.
+ *
+ * Szerokości są obcinane do [-size, size], więc i - dolne oraz i + gorne nie
+ * przepełniają się nawet dla pasmo(n, 0, INT_MAX).
+ *
+ * @param size Rozmiar maski.
+ * @param dolne Liczba przekątnych pod główną (może być ujemna).
+ * @param gorne Liczba przekątnych nad główną (może być ujemna).
+ * @return Maska.
+ */
+maska maska::pasmo(int size, int dolne, int gorne) {
+	maska m(size, pasmo_);
+	m.dolne = max(-size, min(dolne, size));
+	m.gorne = max(-size, min(gorne, size));
+	return m;
+}
+
+/**
+ * @brief Tworzy maskę trójkąta dolnego.
+ * @param size Rozmiar maski.
+ * @param z_przekatna Czy uwzględnić główną przekątną.
+ * @return Maska.
+ */
+maska maska::trojkat_dolny(int size, bool z_przekatna) {
+	return pasmo(size, size, z_przekatna ? 0 : -1);
+}
+
+/**
+ * @brief Tworzy maskę trójkąta górnego.
+ * @param size Rozmiar maski.
+ * @param z_przekatna Czy uwzględnić główną przekątną.
+ * @return Maska.
+ */
+maska maska::trojkat_gorny(int size, bool z_przekatna) {
+	return pasmo(size, z_przekatna ? 0 : -1, size);
+}
+
+/**
+ * @brief Tworzy maskę z predykatu na indeksach.
+ * @param size Rozmiar maski.
+ * @param p Predykat p(i, j).
+ * @return Maska.
+ */
+maska maska::z_predykatu(int size, const function<bool(int, int)>& p) {
+	maska m(size, ogolna);
+	m.dane.resize((size_t)m.n * m.n);
+	for (int i = 0; i < m.n; i++) {
+		for (int j = 0; j < m.n; j++) {
+			m.dane[(size_t)i * m.n + j] = p(i, j) ? -1 : 0;
+		}
+	}
+	return m;
+}
+
+/**
+ * @brief Tworzy maskę niezerowych elementów macierzy.
+ * @param mac Macierz.
+ * @return Maska.
+ */
+maska maska::z_macierzy(const matrix& mac) {
+	maska m(mac.n, ogolna);
+	m.dane.resize((size_t)m.n * m.n);
+	for (int i = 0; i < m.n; i++) {
+		for (int j = 0; j < m.n; j++) {
+			m.dane[(size_t)i * m.n + j] = -(int)(mac.data[i][j] != 0);
+		}
+	}
+	return m;
+}
+
+/**
+ * @brief Zwraca rozmiar maski.
+ * @return Rozmiar n.
+ */
+int maska::rozmiar() const {
+	return n;
+}
+
+/**
+ * @brief Sprawdza, czy element jest wybrany.
+ * @param i Indeks wiersza.
+ * @param j Indeks kolumny.
+ * @return True, jeśli element jest wybrany (false poza zakresem).
+ */
+bool maska::wybrany(int i, int j) const {
+	if (i < 0 || i >= n || j < 0 || j >= n) {
+		return false;
+	}
+	switch (r) {
+	case szachownica_:
+		return dane[(size_t)(i % 2) * n + j] != 0;
+	case pasmo_:
+		return j >= i - dolne && j <= i + gorne;
+	default:
+		return dane[(size_t)i * n + j] != 0;
+	}
+}
+
+/**
+ * @brief Zlicza wybrane elementy.
+ * @return Liczba wybranych elementów.
+ */
+long long maska::liczba() const {
+	vector<int> bufor(n);
+	long long wynik = 0;
+	for (int i = 0; i < n; i++) {
+		const int* w = wiersz(i, bufor.data());
+		for (int j = 0; j < n; j++) {
+			wynik -= w[j];
+		}
+	}
+	return wynik;
+}
+
+/**
+ * @brief Część wspólna masek.
+ * @param m Druga maska.
+ * @return Maska ogólna.
+ * @throws std::invalid_argument Jeśli maski mają różne rozmiary.
+ */
+maska maska::operator&(const maska& m) const {
+	if (m.n != n) {
+		throw invalid_argument("Mask dimensions mismatch");
+	}
+	maska wynik(n, ogolna);
+	wynik.dane.resize((size_t)n * n);
+	vector<int> b1(n), b2(n);
+	for (int i = 0; i < n; i++) {
+		const int* w1 = wiersz(i, b1.data());
+		const int* w2 = m.wiersz(i, b2.data());
+		for (int j = 0; j < n; j++) {
+			wynik.dane[(size_t)i * n + j] = w1[j] & w2[j];
+		}
+	}
+	return wynik;
+}
+
+/**
+ * @brief Suma masek.
+ * @param m Druga maska.
+ * @return Maska ogólna.
+ * @throws std::invalid_argument Jeśli maski mają różne rozmiary.
+ */
+maska maska::operator|(const maska& m) const {
+	if (m.n != n) {
+		throw invalid_argument("Mask dimensions mismatch");
+	}
+	maska wynik(n, ogolna);
+	wynik.dane.resize((size_t)n * n);
+	vector<int> b1(n), b2(n);
+	for (int i = 0; i < n; i++) {
+		const int* w1 = wiersz(i, b1.data());
+		const int* w2 = m.wiersz(i, b2.data());
+		for (int j = 0; j < n; j++) {
+			wynik.dane[(size_t)i * n + j] = w1[j] | w2[j];
+		}
+	}
+	return wynik;
+}
+
+/**
+ * @brief Dopełnienie maski.
+ *
+ * Dopełnienie szachownicy jest znowu szachownicą (z zamienionymi wzorcami),
+ * pozostałe maski są zapisywane jako ogólne.
+ *
+ * @return Maska.
+ */
+maska maska::operator~() const {
+	maska wynik(n, r == szachownica_ ? szachownica_ : ogolna);
+	if (r == szachownica_) {
+		wynik.dane.resize(dane.size());
+		for (size_t k = 0; k < dane.size(); k++) {
+			wynik.dane[k] = ~dane[k];
+		}
+		return wynik;
+	}
+	wynik.dane.resize((size_t)n * n);
+	vector<int> bufor(n);
+	for (int i = 0; i < n; i++) {
+		const int* w = wiersz(i, bufor.data());
+		for (int j = 0; j < n; j++) {
+			wynik.dane[(size_t)i * n + j] = ~w[j];
+		}
+	}
+	return wynik;
+}
+
+/**
+ * @brief Wybiera elementy z dwóch macierzy według maski.
+ * @param m Maska.
+ * @param a Macierz dla elementów wybranych.
+ * @param b Macierz dla elementów niewybranych.
+ * @return Nowa macierz.
+ * @throws std::invalid_argument Jeśli rozmiary się różnią.
+ */
+matrix maska::gdzie(const maska& m, const matrix& a, const matrix& b) {
+	if (a.n != b.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	matrix wynik(a.n);
+	m.dla_wierszy(a.n, [&](int i, const int* mw, int) {
+		const int* wa = a.data[i];
+		const int* wb = b.data[i];
+		int* ww = wynik.data[i];
+		for (int j = 0; j < a.n; j++) {
+			ww[j] = (wa[j] & mw[j]) | (wb[j] & ~mw[j]);
+		}
+	});
+	return wynik;
+}
+
+/**
+ * @brief Wybiera elementy macierzy według maski, a pozostałe zastępuje stałą.
+ *
+ * Wywołanie gdzie(szachownica(n), a, 0) daje macierz wypisywaną przez szachownica().
+ *
+ * @param m Maska.
+ * @param a Macierz dla elementów wybranych.
+ * @param b Wartość dla elementów niewybranych.
+ * @return Nowa macierz.
+ */
+matrix maska::gdzie(const maska& m, const matrix& a, int b) {
+	matrix wynik(a.n);
+	m.dla_wierszy(a.n, [&](int i, const int* mw, int) {
+		const int* wa = a.data[i];
+		int* ww = wynik.data[i];
+		for (int j = 0; j < a.n; j++) {
+			ww[j] = (wa[j] & mw[j]) | (b & ~mw[j]);
+		}
+	});
+	return wynik;
+}
+
+/**
+ * @brief Dodaje skalar do wybranych elementów.
+ * @param a Macierz modyfikowana w miejscu.
+ * @param m Maska.
+ * @param s Skalar.
+ */
+void maska::dodaj(matrix& a, const maska& m, int s) {
+	a.do_zapisu();
+	m.dla_wierszy(a.n, [&](int i, const int* mw, int) {
+		int* wa = a.data[i];
+		for (int j = 0; j < a.n; j++) {
+			wa[j] += s & mw[j];
+		}
+	});
+}
+
+/**
+ * @brief Dodaje do wybranych elementów odpowiadające elementy innej macierzy.
+ * @param a Macierz modyfikowana w miejscu.
+ * @param m Maska.
+ * @param b Macierz do dodania.
+ * @throws std::invalid_argument Jeśli rozmiary się różnią.
+ */
+void maska::dodaj(matrix& a, const maska& m, const matrix& b) {
+	if (a.n != b.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	a.do_zapisu();
+	m.dla_wierszy(a.n, [&](int i, const int* mw, int) {
+		int* wa = a.data[i];
+		const int* wb = b.data[i];
+		for (int j = 0; j < a.n; j++) {
+			wa[j] += wb[j] & mw[j];
+		}
+	});
+}
+
+/**
+ * @brief Mnoży wybrane elementy przez skalar.
+ *
+ * Iloczyn jest liczony bez znaku (modulo 2^32) dla wszystkich elementów, bo maska
+ * wybiera wynik dopiero po mnożeniu; niewybrane elementy nie mogą więc wywołać
+ * przepełnienia ze znakiem.
+ *
+ * @param a Macierz modyfikowana w miejscu.
+ * @param m Maska.
+ * @param s Skalar.
+ */
+void maska::skaluj(matrix& a, const maska& m, int s) {
+	a.do_zapisu();
+	m.dla_wierszy(a.n, [&](int i, const int* mw, int) {
+		int* wa = a.data[i];
+		for (int j = 0; j < a.n; j++) {
+			int iloczyn = (int)((unsigned int)wa[j] * (unsigned int)s);
+			wa[j] = (iloczyn & mw[j]) | (wa[j] & ~mw[j]);
+		}
+	});
+}
+
+/**
+ * @brief Suma wybranych elementów.
+ *
+ * Sumy częściowe wątków są łączone w stałej kolejności.
+ *
+ * @param a Macierz.
+ * @param m Maska.
+ * @return Suma (64 bity).
+ */
+long long maska::suma(const matrix& a, const maska& m) {
+	vector<long long> czesciowe(pula_watkow::globalna().liczba_watkow(), 0);
+	m.dla_wierszy(a.n, [&](int i, const int* mw, int watek) {
+		const int* wa = a.data[i];
+		long long s = 0;
+		for (int j = 0; j < a.n; j++) {
+			s += wa[j] & mw[j];
+		}
+		czesciowe[watek] += s;
+	});
+	long long wynik = 0;
+	for (size_t t = 0; t < czesciowe.size(); t++) {
+		wynik += czesciowe[t];
+	}
+	return wynik;
+}
+
+/**
+ * @brief Najmniejszy z wybranych elementów.
+ *
+ * Elementy niewybrane są zastępowane przez INT_MAX, więc pętla nie ma rozgałęzień.
+ *
+ * @param a Macierz.
+ * @param m Maska.
+ * @return Minimum (INT_MAX, jeśli nic nie wybrano).
+ */
+int maska::minimum(const matrix& a, const maska& m) {
+	vector<int> czesciowe(pula_watkow::globalna().liczba_watkow(), INT_MAX);
+	m.dla_wierszy(a.n, [&](int i, const int* mw, int watek) {
+		const int* wa = a.data[i];
+		int w = czesciowe[watek];
+		for (int j = 0; j < a.n; j++) {
+			int v = (wa[j] & mw[j]) | (INT_MAX & ~mw[j]);
+			w = v < w ? v : w;
+		}
+		czesciowe[watek] = w;
+	});
+	int wynik = INT_MAX;
+	for (size_t t = 0; t < czesciowe.size(); t++) {
+		wynik = czesciowe[t] < wynik ? czesciowe[t] : wynik;
+	}
+	return wynik;
+}
+
+/**
+ * @brief Największy z wybranych elementów.
+ *
+ * Elementy niewybrane są zastępowane przez INT_MIN, więc pętla nie ma rozgałęzień.
+ *
+ * @param a Macierz.
+ * @param m Maska.
+ * @return Maksimum (INT_MIN, jeśli nic nie wybrano).
+ */
+int maska::maksimum(const matrix& a, const maska& m) {
+	vector<int> czesciowe(pula_watkow::globalna().liczba_watkow(), INT_MIN);
+	m.dla_wierszy(a.n, [&](int i, const int* mw, int watek) {
+		const int* wa = a.data[i];
+		int w = czesciowe[watek];
+		for (int j = 0; j < a.n; j++) {
+			int v = (wa[j] & mw[j]) | (INT_MIN & ~mw[j]);
+			w = v > w ? v : w;
+		}
+		czesciowe[watek] = w;
+	});
+	int wynik = INT_MIN;
+	for (size_t t = 0; t < czesciowe.size(); t++) {
+		wynik = czesciowe[t] > wynik ? czesciowe[t] : wynik;
+	}
+	return wynik;
+}
@@ -0,0 +1,202 @@
+#pragma once
+#ifndef MASKA_H
+#define MASKA_H
+
+#include "matrix.h"
+#include <climits>
+#include <functional>
+#include <vector>
+using namespace std;
+
+/**
+ * @class maska
+ * @brief Maska logiczna n x n do wybierania elementów macierzy.
+ *
+ * Element maski ma wartość -1 (wszystkie bity ustawione, element wybrany) albo 0,
+ * dzięki czemu operacje maskowane są liczone bez rozgałęzień jako (a & m) | (b & ~m).
+ * Maski szachownicy i pasm (w tym trójkątów) nie są przechowywane element po elemencie:
+ * szachownica ma dwa gotowe wzorce wierszy, a wiersz pasma jest generowany w locie.
+ */
+class maska {
+private:
+    /**
+     * @brief Sposób przechowywania maski.
+     */
+    enum rodzaj { ogolna, szachownica_, pasmo_ };
+
+    int n; ///< Rozmiar maski (n x n)
+    rodzaj r; ///< Sposób przechowywania
+    vector<int> dane; ///< Elementy maski (ogolna) lub dwa wzorce wierszy (szachownica)
+    int dolne; ///< Liczba przekątnych pod główną należących do pasma
+    int gorne; ///< Liczba przekątnych nad główną należących do pasma
+
+    maska(int size, rodzaj rodz);
+
+    /**
+     * @brief Zwraca wiersz maski.
+     * @param i Indeks wiersza.
+     * @param bufor Bufor n elementów używany dla masek generowanych w locie.
+     * @return Wskaźnik na n elementów maski.
+     */
+    const int* wiersz(int i, int* bufor) const;
+
+    template <class F>
+    void dla_wierszy(int rozmiar, F f) const;
+
+public:
+    /**
+     * @brief Maska szachownicy.
+     * @param size Rozmiar maski.
+     * @param parzyste True - wybrane są pola o parzystej sumie indeksów (jak w szachownica()).
+     * @return Maska.
+     */
+    static maska szachownica(int size, bool parzyste = true);
+
+    /**
+     * @brief Maska pasma przekątnych od -dolne do +gorne.
+     * @param size Rozmiar maski.
+     * @param dolne Liczba przekątnych pod główną.
+     * @param gorne Liczba przekątnych nad główną.
+     * @return Maska.
+     */
+    static maska pasmo(int size, int dolne, int gorne);
+
+    /**
+     * @brief Maska trójkąta dolnego.
+     * @param size Rozmiar maski.
+     * @param z_przekatna Czy uwzględnić główną przekątną.
+     * @return Maska.
+     */
+    static maska trojkat_dolny(int size, bool z_przekatna = true);
+
+    /**
+     * @brief Maska trójkąta górnego.
+     * @param size Rozmiar maski.
+     * @param z_przekatna Czy uwzględnić główną przekątną.
+     * @return Maska.
+     */
+    static maska trojkat_gorny(int size, bool z_przekatna = true);
+
+    /**
+     * @brief Maska z predykatu na indeksach.
+     * @param size Rozmiar maski.
+     * @param p Predykat p(i, j).
+     * @return Maska.
+     */
+    static maska z_predykatu(int size, const function<bool(int, int)>& p);
+
+    /**
+     * @brief Maska niezerowych elementów macierzy.
+     * @param m Macierz.
+     * @return Maska.
+     */
+    static maska z_macierzy(const matrix& m);
+
+    /**
+     * @brief Zwraca rozmiar maski.
+     * @return Rozmiar n.
+     */
+    int rozmiar() const;
+
+    /**
+     * @brief Sprawdza, czy element jest wybrany.
+     * @param i Indeks wiersza.
+     * @param j Indeks kolumny.
+     * @return True, jeśli element jest wybrany.
+     */
+    bool wybrany(int i, int j) const;
+
+    /**
+     * @brief Zlicza wybrane elementy.
+     * @return Liczba wybranych elementów.
+     */
+    long long liczba() const;
+
+    /**
+     * @brief Część wspólna masek.
+     * @param m Druga maska.
+     * @return Maska.
+     */
+    maska operator&(const maska& m) const;
+
+    /**
+     * @brief Suma masek.
+     * @param m Druga maska.
+     * @return Maska.
+     */
+    maska operator|(const maska& m) const;
+
+    /**
+     * @brief Dopełnienie maski.
+     * @return Maska.
+     */
+    maska operator~() const;
+
+    /**
+     * @brief Wybiera elementy: wynik[i][j] = m ? a[i][j] : b[i][j].
+     * @param m Maska.
+     * @param a Macierz dla elementów wybranych.
+     * @param b Macierz dla elementów niewybranych.
+     * @return Nowa macierz.
+     */
+    static matrix gdzie(const maska& m, const matrix& a, const matrix& b);
+
+    /**
+     * @brief Wybiera elementy: wynik[i][j] = m ? a[i][j] : b.
+     * @param m Maska.
+     * @param a Macierz dla elementów wybranych.
+     * @param b Wartość dla elementów niewybranych.
+     * @return Nowa macierz.
+     */
+    static matrix gdzie(const maska& m, const matrix& a, int b);
+
+    /**
+     * @brief Dodaje skalar do wybranych elementów macierzy.
+     * @param a Macierz modyfikowana w miejscu.
+     * @param m Maska.
+     * @param s Skalar.
+     */
+    static void dodaj(matrix& a, const maska& m, int s);
+
+    /**
+     * @brief Dodaje do wybranych elementów odpowiadające elementy innej macierzy.
+     * @param a Macierz modyfikowana w miejscu.
+     * @param m Maska.
+     * @param b Macierz do dodania.
+     */
+    static void dodaj(matrix& a, const maska& m, const matrix& b);
+
+    /**
+     * @brief Mnoży wybrane elementy przez skalar.
+     * @param a Macierz modyfikowana w miejscu.
+     * @param m Maska.
+     * @param s Skalar.
+     */
+    static void skaluj(matrix& a, const maska& m, int s);
+
+    /**
+     * @brief Suma wybranych elementów.
+     * @param a Macierz.
+     * @param m Maska.
+     * @return Suma (64 bity).
+     */
+    static long long suma(const matrix& a, const maska& m);
+
+    /**
+     * @brief Najmniejszy z wybranych elementów.
+     * @param a Macierz.
+     * @param m Maska.
+     * @return Minimum (INT_MAX, jeśli nic nie wybrano).
+     */
+    static int minimum(const matrix& a, const maska& m);
+
+    /**
+     * @brief Największy z wybranych elementów.
+     * @param a Macierz.
+     * @param m Maska.
+     * @return Maksimum (INT_MIN, jeśli nic nie wybrano).
+     */
+    static int maksimum(const matrix& a, const maska& m);
+};
+
+#endif // !MASKA_H
@@ -1,192 +1,634 @@
 /**
  * @file matrix.cpp
- * @brief Implementacja konstruktorw i destruktora klasy matrix.
+ * @brief Implementacja konstruktorów i destruktora klasy matrix.
  */
 
 #include "matrix.h"
+#include "numa.h"
+#include "redukcja.h"
+#include "sledzenie.h"
+#include "strojenie.h"
+#include "watki.h"
 #include <iostream>
 #include <ctime>
 #include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
 
 using namespace std;
 
+/// Czy konstruktor kopiujący i przypisanie współdzielą bufor (kopiowanie przy zapisie).
+atomic<bool> matrix::wspoldzielenie_(true);
+
+/**
+ * @brief Najmniejsza liczba wierszy, od której bufor jest inicjalizowany, a operacje
+ * elementami wykonywane równolegle.
+ *
+ * Wartość dobiera strojenie (domyślnie 32, jak próg zrównoleglenia iloczynu).
+ *
+ * @return Próg w wierszach.
+ */
+static int prog_rownoleglosci() {
+	return strojenie::biezace().prog;
+}
+
+/**
+ * @brief Szacuje liczbę bajtów dotykanych przez operację na potrzeby śledzenia.
+ * @param n Rozmiar macierzy.
+ * @param ile Liczba odczytanych lub zapisanych macierzy n x n.
+ * @return Liczba bajtów.
+ */
+static long long bajty_macierzy(int n, int ile) {
+	return (long long)n * n * (long long)sizeof(int) * ile;
+}
+
+/**
+ * @brief Alokuje bufor na elementy macierzy.
+ *
+ * Elementy są przechowywane w jednym ciągłym bloku, a tablica wskaźników na wiersze
+ * pozwala nadal odwoływać się do nich jako `data[i][j]`. Licznik odwołań bufora
+ * jest ustawiany na 1.
+ *
+ * Dla dużych macierzy blok jest najpierw rozmieszczany zgodnie z zasadą NUMA
+ * (numa::rozmiesc), a następnie zerowany, kopiowany albo przynajmniej dotykany
+ * (jeden zapis na stronę) przez wątki puli - każdy wątek swoje wiersze. Przy zasadzie
+ * pierwszego dotyku strony trafiają więc do węzłów wątków, które później je przetwarzają.
+ *
+ * @param n Rozmiar macierzy (n x n).
+ * @param zeruj Czy wyzerować elementy.
+ * @param zrodlo Elementy do skopiowania (n*n, wierszami) lub nullptr.
+ * @return Nowy bufor lub nullptr dla n <= 0.
+ */
+matrix::bufor* matrix::nowy_bufor(int n, bool zeruj, const int* zrodlo) {
+	if (n <= 0) {
+		return nullptr;
+	}
+	bufor* b = new bufor;
+	b->licznik.store(1, memory_order_relaxed);
+	b->skrot.store(0, memory_order_relaxed);
+	b->elementy = new int[(size_t)n * n];
+	b->wiersze = new int* [n];
+	for (int i = 0; i < n; i++) {
+		b->wiersze[i] = b->elementy + (size_t)i * n;
+	}
+
+	int* e = b->elementy;
+	int prog = prog_rownoleglosci();
+	if (n < prog) {
+		if (zrodlo) {
+			copy(zrodlo, zrodlo + (size_t)n * n, e);
+		}
+		else if (zeruj) {
+			fill(e, e + (size_t)n * n, 0);
+		}
+		return b;
+	}
+
+	numa::rozmiesc(e, (size_t)n * n * sizeof(int));
+	pula_watkow::globalna().rownolegle(n, [=](int od, int do_, int) {
+		size_t poczatek = (size_t)od * n;
+		size_t koniec = (size_t)do_ * n;
+		if (zrodlo) {
+			copy(zrodlo + poczatek, zrodlo + koniec, e + poczatek);
+		}
+		else if (zeruj) {
+			fill(e + poczatek, e + koniec, 0);
+		}
+		else {
+			const size_t krok = 4096 / sizeof(int);
+			for (size_t i = poczatek; i < koniec; i += krok) {
+				e[i] = 0;
+			}
+		}
+	}, prog);
+	return b;
+}
+
+/**
+ * @brief Zwalnia jedno odwołanie do bufora.
+ *
+ * Bufor jest usuwany, gdy zwolnione zostanie ostatnie odwołanie.
+ *
+ * @param b Bufor (może być nullptr).
+ */
+void matrix::zwolnij(bufor* b) {
+	if (b && b->licznik.fetch_sub(1, memory_order_acq_rel) == 1) {
+		delete[] b->wiersze;
+		delete[] b->elementy;
+		delete b;
+	}
+}
+
 /**
- * @brief Konstruktor domylny.
+ * @brief Przygotowuje macierz do modyfikacji.
  *
- * Tworzy pust macierz o rozmiarze 0x0. Wskanik na dane macierzy jest ustawiony na nullptr.
+ * Jeśli bufor jest współdzielony z inną macierzą, elementy są kopiowane do nowego,
+ * prywatnego bufora. Zapamiętany skrót zawartości jest unieważniany. Wywoływana
+ * na początku każdej operacji modyfikującej macierz.
  */
-matrix::matrix() : n(0), data(nullptr) {}
+void matrix::do_zapisu() {
+	if (buf && buf->licznik.load(memory_order_acquire) > 1) {
+		bufor* nowy = nowy_bufor(n, false, buf->elementy);
+		zwolnij(buf);
+		buf = nowy;
+		data = nowy->wiersze;
+	}
+	if (buf) {
+		buf->skrot.store(0, memory_order_relaxed);
+	}
+}
+
+/**
+ * @brief Miesza 64-bitową wartość (krok końcowy MurmurHash3).
+ * @param h Wartość wejściowa.
+ * @return Wymieszana wartość.
+ */
+static unsigned long long wymieszaj(unsigned long long h) {
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+/**
+ * @brief Oblicza skrót zawartości macierzy.
+ *
+ * Elementy są przetwarzane w ośmiu niezależnych 32-bitowych torach rundą xxHash32
+ * (dodanie, mnożenie, obrót), co kompilator zamienia na instrukcje SIMD. Tory są
+ * na końcu łączone w jedną wartość 64-bitową razem z rozmiarem macierzy.
+ * Skrót jest zapamiętywany w buforze i unieważniany przez do_zapisu(), więc
+ * kolejne wywołania dla niezmienionej macierzy (i jej kopii) działają w czasie O(1).
+ *
+ * @return Skrót zawartości (nigdy 0).
+ */
+unsigned long long matrix::skrot() const {
+	sledzenie::zakres sledz("skrot", n, bajty_macierzy(n, 1));
+	if (!buf) {
+		return 1;
+	}
+	unsigned long long zapamietany = buf->skrot.load(memory_order_relaxed);
+	if (zapamietany) {
+		return zapamietany;
+	}
+
+	const unsigned int P1 = 2654435761U;
+	const unsigned int P2 = 2246822519U;
+	unsigned int tory[8];
+	for (int l = 0; l < 8; l++) {
+		tory[l] = P1 * (l + 1);
+	}
+	const unsigned int* e = (const unsigned int*)buf->elementy;
+	size_t dlugosc = (size_t)n * n;
+	size_t i = 0;
+	for (; i + 8 <= dlugosc; i += 8) {
+		for (int l = 0; l < 8; l++) {
+			unsigned int h = tory[l] + e[i + l] * P2;
+			tory[l] = ((h << 13) | (h >> 19)) * P1;
+		}
+	}
+	for (; i < dlugosc; i++) {
+		unsigned int h = tory[i % 8] + e[i] * P2;
+		tory[i % 8] = ((h << 13) | (h >> 19)) * P1;
+	}
+
+	unsigned long long wynik = wymieszaj((unsigned long long)n);
+	for (int l = 0; l < 8; l++) {
+		wynik = wymieszaj(wynik ^ (((unsigned long long)l << 32) | tory[l]));
+	}
+	if (wynik == 0) {
+		wynik = 1;
+	}
+	buf->skrot.store(wynik, memory_order_relaxed);
+	return wynik;
+}
+
+/**
+ * @brief Włącza lub wyłącza współdzielenie buforów przy kopiowaniu.
+ *
+ * Przy wyłączonym współdzieleniu każda kopia od razu kopiuje wszystkie elementy.
+ * Macierze, które już współdzielą bufor, rozdzielą się przy pierwszej modyfikacji.
+ *
+ * @param wlacz True - kopiowanie przy zapisie, false - kopiowanie głębokie.
+ */
+void matrix::wspoldzielenie(bool wlacz) {
+	wspoldzielenie_.store(wlacz);
+}
+
+/**
+ * @brief Sprawdza, czy bufor macierzy jest współdzielony z inną macierzą.
+ * @return True, jeśli bufor ma więcej niż jedno odwołanie.
+ */
+bool matrix::wspoldzielona() const {
+	return buf && buf->licznik.load(memory_order_acquire) > 1;
+}
+
+/**
+ * @brief Konstruktor domyślny.
+ *
+ * Tworzy pustą macierz o rozmiarze 0x0. Wskaźnik na dane macierzy jest ustawiony na nullptr.
+ */
+matrix::matrix() : n(0), data(nullptr), buf(nullptr) {}
 
 /**
  * @brief Konstruktor parametryczny.
  *
- * Tworzy macierz kwadratow o zadanym rozmiarze. Alokuje pami dla macierzy, ale jej elementy
- * nie s inicjalizowane.
+ * Tworzy macierz kwadratową o zadanym rozmiarze. Alokuje pamięć dla macierzy, ale jej elementy
+ * nie są inicjalizowane.
  *
  * @param size Rozmiar macierzy (n x n).
  */
 matrix::matrix(int size) : n(size) {
-	data = new int* [n];
-	for (int i = 0; i < n; i++) {
-		data[i] = new int[n];
-	}
+	buf = nowy_bufor(n, false);
+	data = buf ? buf->wiersze : nullptr;
 }
 
 /**
- * @brief Konstruktor kopiujcy.
+ * @brief Konstruktor kopiujący.
  *
- * Tworzy now macierz, ktra jest kopi podanej macierzy. Kopiowane s wszystkie elementy
- * macierzy rdowej.
+ * Tworzy nową macierz, która jest kopią podanej macierzy. Przy włączonym współdzieleniu
+ * (domyślnie) kopia jedynie zwiększa licznik odwołań bufora, więc działa w czasie O(1);
+ * elementy są kopiowane dopiero przy pierwszej modyfikacji jednej z macierzy.
  *
- * @param m Macierz, ktr naley skopiowa.
+ * @param m Macierz, którą należy skopiować.
  */
 matrix::matrix(const matrix& m) : n(m.n) {
-	data = new int* [n];
-	for (int i = 0; i < n; i++) {
-		data[i] = new int[n];
-		for (int j = 0; j < n; j++) {
-			data[i][j] = m.data[i][j];
-		}
+	if (m.buf && wspoldzielenie_.load(memory_order_relaxed)) {
+		m.buf->licznik.fetch_add(1, memory_order_relaxed);
+		buf = m.buf;
 	}
+	else {
+		buf = nowy_bufor(n, false, m.buf ? m.buf->elementy : nullptr);
+	}
+	data = buf ? buf->wiersze : nullptr;
 }
 
 /**
- * @brief Konstruktor inicjalizujcy macierz z tablicy jednowymiarowej.
+ * @brief Konstruktor inicjalizujący macierz z tablicy jednowymiarowej.
  *
- * Tworzy macierz kwadratow o zadanym rozmiarze i inicjalizuje j wartociami z tablicy.
- * Tablica `t` jest interpretowana jako elementy macierzy w kolejnoci wiersz po wierszu.
+ * Tworzy macierz kwadratową o zadanym rozmiarze i inicjalizuje ją wartościami z tablicy.
+ * Tablica `t` jest interpretowana jako elementy macierzy w kolejności wiersz po wierszu.
  *
  * @param size Rozmiar macierzy (n x n).
- * @param t Tablica jednowymiarowa przechowujca elementy macierzy.
+ * @param t Tablica jednowymiarowa przechowująca elementy macierzy.
  */
 matrix::matrix(int size, int* t) : n(size) {
-	data = new int* [n];
-	for (int i = 0; i < n; i++) {
-		data[i] = new int[n];
-		for (int j = 0; j < n; j++) {
-			data[i][j] = t[i * n + j];
-		}
-	}
+	buf = nowy_bufor(n, false, t);
+	data = buf ? buf->wiersze : nullptr;
 }
 
 /**
  * @brief Destruktor.
  *
- * Usuwa pami zaalokowan dla macierzy, zwalniajc wszystkie wiersze i tablic wskanikw.
+ * Zwalnia odwołanie do bufora; pamięć jest usuwana przez ostatnią macierz, która go używa.
  */
 matrix::~matrix() {
-	for (int i = 0; i < n; i++) {
-		delete[] data[i];
+	zwolnij(buf);
+}
+
+/**
+ * @brief Operator przypisania.
+ *
+ * Zachowuje się jak konstruktor kopiujący: przy włączonym współdzieleniu przejmuje
+ * odwołanie do bufora macierzy `m`, w przeciwnym razie kopiuje jej elementy.
+ *
+ * @param m Macierz przypisywana.
+ * @return Referencja do bieżącej macierzy.
+ */
+matrix& matrix::operator=(const matrix& m) {
+	if (this != &m) {
+		matrix kopia(m);
+		zamien(kopia);
 	}
-	delete[] data;
+	return *this;
 }
 
 
 /**
- * @brief Alokuje pami dla macierzy o zadanym rozmiarze.
+ * @brief Alokuje pamięć dla macierzy o zadanym rozmiarze.
  *
- * Jeli macierz ju ma zaalokowan pami, zostaje ona zwolniona, a nastpnie
- * alokowana jest nowa pami dla macierzy o podanym rozmiarze. Wszystkie elementy
- * s inicjalizowane na 0.
+ * Jeśli macierz już ma zaalokowaną pamięć, zostaje ona zwolniona, a następnie
+ * alokowana jest nowa pamięć dla macierzy o podanym rozmiarze. Wszystkie elementy
+ * są inicjalizowane na 0.
  *
  * @param size Rozmiar macierzy (n x n).
- * @return Referencja do biecej macierzy.
+ * @return Referencja do bieżącej macierzy.
  */
 matrix& matrix::alokuj(int size) {
-	if (data) {
-		for (int i = 0; i < n; i++) {
-			delete[] data[i];
-		}
-		delete[] data;
-	}
+	sledzenie::zakres sledz("alokuj", size, bajty_macierzy(size, 1));
+	zwolnij(buf);
 	n = size;
-	data = new int* [n];
-	for (int i = 0; i < n; i++) {
-		data[i] = new int[n]();
-	}
+	buf = nowy_bufor(n, true);
+	data = buf ? buf->wiersze : nullptr;
 	return *this;
 }
 
 /**
- * @brief Wstawia warto do okrelonej pozycji w macierzy.
+ * @brief Wstawia wartość do określonej pozycji w macierzy.
  *
- * Jeli podane indeksy mieszcz si w zakresie macierzy, warto zostaje wstawiona.
- * W przeciwnym wypadku funkcja nie wykonuje adnych dziaa.
+ * Jeśli podane indeksy mieszczą się w zakresie macierzy, wartość zostaje wstawiona.
+ * W przeciwnym wypadku funkcja nie wykonuje żadnych działań.
  *
  * @param x Indeks wiersza.
  * @param y Indeks kolumny.
- * @param wartosc Warto do wstawienia.
- * @return Referencja do biecej macierzy.
+ * @param wartosc Wartość do wstawienia.
+ * @return Referencja do bieżącej macierzy.
  */
 matrix& matrix::wstaw(int x, int y, int wartosc) {
 	if (x >= 0 && x < n && y >= 0 && y < n) {
+		do_zapisu();
 		data[x][y] = wartosc;
 	}
 	return *this;
 }
 
 /**
- * @brief Pobiera warto z okrelonej pozycji w macierzy.
+ * @brief Pobiera wartość z określonej pozycji w macierzy.
  *
- * Jeli podane indeksy mieszcz si w zakresie macierzy, zwraca warto w danej pozycji.
- * W przeciwnym wypadku moe zwrci nieokrelon warto (naley doda lepsz obsug bdw).
+ * Jeśli podane indeksy mieszczą się w zakresie macierzy, zwraca wartość w danej pozycji.
+ * W przeciwnym wypadku może zwrócić nieokreśloną wartość (należy dodać lepszą obsługę błędów).
  *
  * @param x Indeks wiersza.
  * @param y Indeks kolumny.
- * @return Warto w pozycji (x, y).
+ * @return Wartość w pozycji (x, y).
  */
 int matrix::pokaz(int x, int y) {
 	if (x >= 0 && x < n && y >= 0 && y < n) {
 		return data[x][y];
 	}
-	return 0; // Dodatkowa obsuga dla wartoci poza zakresem.
+	return 0; // Dodatkowa obsługa dla wartości poza zakresem.
 }
 
+/// Najmniejsza partia, od której rozrzuc() i zbierz() dzielą pracę między wątki puli.
+static const size_t PROG_PARTII = 1 << 16;
+
 /**
- * @brief Odwraca macierz wzgldem gwnej przektnej (transpozycja).
+ * @brief Pozycja partii ułożonej pasami wierszy.
+ */
+struct wpis_partii {
+	size_t przesuniecie; ///< Indeks elementu w ciągłym bloku (wiersz * n + kolumna)
+	size_t dane; ///< Wartość do wstawienia albo numer pozycji w partii
+};
+
+/**
+ * @brief Sprawdza, czy wszystkie współrzędne partii leżą w macierzy.
  *
- * Zmienia macierz w miejscu, zamieniajc elementy powyej i poniej przektnej gwnej.
+ * Ujemna współrzędna rzutowana na unsigned jest większa od n, więc wystarczy jedno
+ * maksimum bez rozgałęzień w pętli i jedno porównanie na całą partię.
  *
- * @return Referencja do biecej macierzy.
+ * @param pozycje Współrzędne.
+ * @param n Rozmiar macierzy.
+ * @return True, jeśli wszystkie współrzędne są poprawne.
  */
-matrix& matrix::odwroc() {
-	for (int i = 0; i < n; i++) {
-		for (int j = 0; j < i; j++) {
-			swap(data[i][j], data[j][i]);
+static bool w_zakresie(const vector<pair<int, int>>& pozycje, int n) {
+	unsigned int najwieksza = 0;
+	for (size_t i = 0; i < pozycje.size(); i++) {
+		najwieksza = max(najwieksza, max((unsigned int)pozycje[i].first, (unsigned int)pozycje[i].second));
+	}
+	return pozycje.empty() || najwieksza < (unsigned int)n;
+}
+
+/**
+ * @brief Liczba wierszy w pasie, tak aby pas zajmował około 256 KB.
+ * @param n Rozmiar macierzy.
+ * @return Liczba wierszy (co najmniej 1).
+ */
+static int wiersze_pasa(int n) {
+	return max(1, 65536 / max(n, 1));
+}
+
+/**
+ * @brief Układa partię pasami wierszy (sortowanie przez zliczanie, stabilne).
+ *
+ * Pozycje są przepisywane razem z danymi, więc późniejszy zapis czyta wpisy po kolei
+ * i trafia tylko do jednego pasa. Partia jest dzielona na fragmenty - po jednym na wątek
+ * puli - które zliczają i rozkładają swoje pozycje równolegle. Kolejność pozycji w tym
+ * samym pasie się nie zmienia.
+ *
+ * @param pozycje Współrzędne (poprawne).
+ * @param n Rozmiar macierzy.
+ * @param dane Zwraca daną wpisu dla numeru pozycji.
+ * @param wpisy Pozycje ułożone pasami.
+ * @param poczatki Początki pasów w wpisy (liczba pasów + 1 wartości).
+ */
+template <class F>
+static void uloz_pasami(const vector<pair<int, int>>& pozycje, int n, F dane, unique_ptr<wpis_partii[]>& wpisy, vector<size_t>& poczatki) {
+	size_t m = pozycje.size();
+	int wiersze = wiersze_pasa(n);
+	size_t pasy = (size_t)(n + wiersze - 1) / wiersze;
+	int fragmenty = m >= PROG_PARTII ? pula_watkow::globalna().liczba_watkow() : 1;
+	vector<size_t> liczniki((size_t)fragmenty * pasy, 0);
+
+	pula_watkow::globalna().rownolegle(fragmenty, [&](int od, int do_, int) {
+		for (int f = od; f < do_; f++) {
+			size_t* l = liczniki.data() + (size_t)f * pasy;
+			for (size_t i = m * f / fragmenty; i < m * (f + 1) / fragmenty; i++) {
+				l[pozycje[i].first / wiersze]++;
+			}
 		}
+	}, 1);
+
+	poczatki.assign(pasy + 1, 0);
+	size_t suma = 0;
+	for (size_t p = 0; p < pasy; p++) {
+		poczatki[p] = suma;
+		for (int f = 0; f < fragmenty; f++) {
+			size_t l = liczniki[(size_t)f * pasy + p];
+			liczniki[(size_t)f * pasy + p] = suma;
+			suma += l;
+		}
+	}
+	poczatki[pasy] = suma;
+
+	wpisy.reset(new wpis_partii[m]);
+	pula_watkow::globalna().rownolegle(fragmenty, [&](int od, int do_, int) {
+		for (int f = od; f < do_; f++) {
+			size_t* l = liczniki.data() + (size_t)f * pasy;
+			for (size_t i = m * f / fragmenty; i < m * (f + 1) / fragmenty; i++) {
+				wpis_partii& w = wpisy[l[pozycje[i].first / wiersze]++];
+				w.przesuniecie = (size_t)pozycje[i].first * n + pozycje[i].second;
+				w.dane = dane(i);
+			}
+		}
+	}, 1);
+}
+
+/**
+ * @brief Wstawia partię wartości.
+ *
+ * Po jednym sprawdzeniu zakresu wartości są zapisywane bezpośrednio do ciągłego bloku
+ * elementów. Bez układania małe partie (oraz każda partia przy puli z jednym wątkiem)
+ * są zapisywane jedną pętlą w kolejności partii. Duże partie przy kilku wątkach są zawsze
+ * układane pasami wierszy jednym stabilnym przebiegiem zliczania (uloz_pasami), a wątki
+ * dostają ciągłe fragmenty pasów - partia jest czytana stałą liczbę razy niezależnie
+ * od liczby wątków. Pozycje jednego wiersza są zapisywane w kolejności partii, więc przy
+ * powtórzeniach wygrywa ostatnia wartość.
+ *
+ * @param pozycje Współrzędne (wiersz, kolumna).
+ * @param wartosci Wartości.
+ * @param pasami Czy najpierw ułożyć partię pasami wierszy.
+ * @return Referencja do bieżącej macierzy.
+ * @throws std::invalid_argument Jeśli długości się różnią lub pozycja leży poza macierzą.
+ */
+matrix& matrix::rozrzuc(const vector<pair<int, int>>& pozycje, const vector<int>& wartosci, bool pasami) {
+	sledzenie::zakres sledz("rozrzuc", n, (long long)pozycje.size() * (sizeof(pair<int, int>) + 2 * sizeof(int)));
+	if (pozycje.size() != wartosci.size()) {
+		throw invalid_argument("Batch size mismatch");
+	}
+	if (!w_zakresie(pozycje, n)) {
+		throw invalid_argument("Index out of range");
+	}
+	if (pozycje.empty()) {
+		return *this;
 	}
+	do_zapisu();
+	int* e = buf->elementy;
+	size_t m = pozycje.size();
+	int prog = m >= PROG_PARTII ? 1 : INT_MAX;
+
+	if (!pasami && (m < PROG_PARTII || pula_watkow::globalna().liczba_watkow() == 1)) {
+		for (size_t i = 0; i < m; i++) {
+			e[(size_t)pozycje[i].first * n + pozycje[i].second] = wartosci[i];
+		}
+		return *this;
+	}
+
+	unique_ptr<wpis_partii[]> wpisy;
+	vector<size_t> poczatki;
+	uloz_pasami(pozycje, n, [&](size_t i) { return (size_t)(unsigned int)wartosci[i]; }, wpisy, poczatki);
+	pula_watkow::globalna().rownolegle((int)poczatki.size() - 1, [&](int od, int do_, int) {
+		for (size_t k = poczatki[od]; k < poczatki[do_]; k++) {
+			e[wpisy[k].przesuniecie] = (int)(unsigned int)wpisy[k].dane;
+		}
+	}, prog);
 	return *this;
 }
 
+/**
+ * @brief Odczytuje partię wartości.
+ *
+ * Bez układania duża partia jest dzielona na ciągłe fragmenty między wątki puli;
+ * po ułożeniu pasami wątki dostają ciągłe fragmenty pasów.
+ *
+ * @param pozycje Współrzędne (wiersz, kolumna).
+ * @param wynik Odczytane wartości.
+ * @param pasami Czy czytać pasami wierszy.
+ * @throws std::invalid_argument Jeśli pozycja leży poza macierzą.
+ */
+void matrix::zbierz(const vector<pair<int, int>>& pozycje, vector<int>& wynik, bool pasami) const {
+	sledzenie::zakres sledz("zbierz", n, (long long)pozycje.size() * (sizeof(pair<int, int>) + 2 * sizeof(int)));
+	if (!w_zakresie(pozycje, n)) {
+		throw invalid_argument("Index out of range");
+	}
+	size_t m = pozycje.size();
+	wynik.resize(m);
+	if (m == 0) {
+		return;
+	}
+	const int* e = buf->elementy;
+	int* w = wynik.data();
+	int prog = m >= PROG_PARTII ? 1 : INT_MAX;
+
+	if (!pasami) {
+		int fragmenty = (int)min(m, (size_t)pula_watkow::globalna().liczba_watkow());
+		pula_watkow::globalna().rownolegle(fragmenty, [&](int od, int do_, int) {
+			for (size_t i = m * od / fragmenty; i < m * do_ / fragmenty; i++) {
+				w[i] = e[(size_t)pozycje[i].first * n + pozycje[i].second];
+			}
+		}, prog);
+		return;
+	}
+
+	unique_ptr<wpis_partii[]> wpisy;
+	vector<size_t> poczatki;
+	uloz_pasami(pozycje, n, [](size_t i) { return i; }, wpisy, poczatki);
+	pula_watkow::globalna().rownolegle((int)poczatki.size() - 1, [&](int od, int do_, int) {
+		for (size_t k = poczatki[od]; k < poczatki[do_]; k++) {
+			w[wpisy[k].dane] = e[wpisy[k].przesuniecie];
+		}
+	}, prog);
+}
 
 /**
- * @brief Losowe wypenianie caej macierzy.
+ * @brief Odwraca macierz względem głównej przekątnej (transpozycja).
  *
- * Wypenia macierz losowymi liczbami z zakresu 0-9. Kady element macierzy zostaje nadpisany
- * now losow wartoci.
+ * Zmienia macierz w miejscu, zamieniając elementy powyżej i poniżej przekątnej głównej.
+ * Macierz jest dzielona na kafle (bok dobiera strojenie); kafel (I, J) pod przekątną
+ * jest zamieniany z kafelem (J, I), więc oba pozostają w pamięci podręcznej, zamiast
+ * przechodzić kolumną przez całą macierz. Pasy kafli są dzielone między wątki puli
+ * parami z przeciwnych końców (pas I ma I + 1 kafli), żeby wątki miały podobną pracę.
  *
- * @return Referencja do biecej macierzy.
+ * @return Referencja do bieżącej macierzy.
+ */
+matrix& matrix::odwroc() {
+	sledzenie::zakres sledz("odwroc", n, bajty_macierzy(n, 2));
+	do_zapisu();
+	strojenie::ustawienia u = strojenie::biezace();
+	int kafel = u.kafel;
+	int pasy = (n + kafel - 1) / kafel;
+	pula_watkow::globalna().rownolegle(pasy, [&](int od, int do_, int) {
+		for (int p = od; p < do_; p++) {
+			int bi = p % 2 == 0 ? p / 2 : pasy - 1 - p / 2;
+			int i0 = bi * kafel;
+			int i1 = min(i0 + kafel, n);
+			for (int j0 = 0; j0 <= i0; j0 += kafel) {
+				int j1 = min(j0 + kafel, n);
+				for (int i = i0; i < i1; i++) {
+					int koniec = j0 == i0 ? i : j1;
+					for (int j = j0; j < koniec; j++) {
+						swap(data[i][j], data[j][i]);
+					}
+				}
+			}
+		}
+	}, (u.prog + kafel - 1) / kafel);
+	return *this;
+}
+
+
+/**
+ * @brief Losowe wypełnianie całej macierzy.
+ *
+ * Wypełnia macierz losowymi liczbami z zakresu 0-9. Każdy element macierzy zostaje nadpisany
+ * nową losową wartością. Wiersze są wypełniane równolegle przez wątki puli; każdy wiersz
+ * ma własny generator, więc wynik nie zależy od liczby wątków.
+ *
+ * @return Referencja do bieżącej macierzy.
  */
 matrix& matrix::losuj() {
-	srand(time(NULL));
-	for (int i = 0; i < n; i++) {
-		for (int j = 0; j < n; j++) {
-			data[i][j] = rand() % 10;
+	sledzenie::zakres sledz("losuj", n, bajty_macierzy(n, 1));
+	do_zapisu();
+	unsigned int ziarno = (unsigned int)time(NULL);
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			minstd_rand generator(ziarno ^ ((unsigned int)i * 2654435761U));
+			for (int j = 0; j < n; j++) {
+				data[i][j] = (int)(generator() % 10);
+			}
 		}
-	}
+	}, prog_rownoleglosci());
 	return *this;
 }
 
 /**
- * @brief Losowe wypenianie wybranej liczby elementw w macierzy.
+ * @brief Losowe wypełnianie wybranej liczby elementów w macierzy.
  *
- * Wypenia losowo wskazan liczb elementw macierzy (`x`) liczbami z zakresu 0-9.
- * Pozycje elementw s losowo wybierane, mog si powtarza.
+ * Wypełnia losowo wskazaną liczbę elementów macierzy (`x`) liczbami z zakresu 0-9.
+ * Pozycje elementów są losowo wybierane, mogą się powtarzać.
  *
- * @param x Liczba elementw do wypenienia losowymi wartociami.
- * @return Referencja do biecej macierzy.
+ * @param x Liczba elementów do wypełnienia losowymi wartościami.
+ * @return Referencja do bieżącej macierzy.
  */
 matrix& matrix::losuj(int x) {
+	sledzenie::zakres sledz("losuj(x)", n, (long long)x * sizeof(int));
+	do_zapisu();
 	srand(time(NULL));
 	for (int i = 0; i < x; i++) {
 		int a = rand() % n;
@@ -197,15 +639,17 @@ matrix& matrix::losuj(int x) {
 }
 
 /**
- * @brief Wypenia gwn przektn macierzy wartociami z tablicy.
+ * @brief Wypełnia główną przekątną macierzy wartościami z tablicy.
  *
- * Wypenia przektn macierzy wartociami podanymi w tablicy `t`. Indeks `t[i]`
+ * Wypełnia przekątną macierzy wartościami podanymi w tablicy `t`. Indeks `t[i]`
  * zostaje przypisany do pozycji `(i, i)` w macierzy.
  *
- * @param t Tablica wartoci do wstawienia na gwn przektn macierzy.
- * @return Referencja do biecej macierzy.
+ * @param t Tablica wartości do wstawienia na główną przekątną macierzy.
+ * @return Referencja do bieżącej macierzy.
  */
 matrix& matrix::diagonalna(int* t) {
+	sledzenie::zakres sledz("diagonalna", n, 2LL * n * sizeof(int));
+	do_zapisu();
 	for (int i = 0; i < n; i++) {
 		data[i][i] = t[i];
 	}
@@ -214,16 +658,18 @@ matrix& matrix::diagonalna(int* t) {
 
 
 /**
- * @brief Wypenia przektn macierzy przesunit o zadan warto k.
+ * @brief Wypełnia przekątną macierzy przesuniętą o zadaną wartość k.
  *
- * Wypenia wartociami z tablicy `t` przektn przesunit o warto `k`.
- * Jeli przesunita pozycja przekracza rozmiar macierzy, wpisanie wartoci jest pomijane.
+ * Wypełnia wartościami z tablicy `t` przekątną przesuniętą o wartość `k`.
+ * Jeśli przesunięta pozycja przekracza rozmiar macierzy, wpisanie wartości jest pomijane.
  *
- * @param k Przesunicie wzgldem gwnej przektnej (moe by ujemne).
- * @param t Tablica wartoci do wypenienia przesunitej przektnej.
- * @return Referencja do biecej macierzy.
+ * @param k Przesunięcie względem głównej przekątnej (może być ujemne).
+ * @param t Tablica wartości do wypełnienia przesuniętej przekątnej.
+ * @return Referencja do bieżącej macierzy.
  */
 matrix& matrix::diagonalna_k(int k, int* t) {
+	sledzenie::zakres sledz("diagonalna_k", n, 2LL * n * sizeof(int));
+	do_zapisu();
 	for (int i = 0; i < n; i++) {
 		if (i + k >= 0 && i + k < n) {
 			data[i][i + k] = t[i];
@@ -233,16 +679,18 @@ matrix& matrix::diagonalna_k(int k, int* t) {
 }
 
 /**
- * @brief Wypenia okrelon kolumn macierzy wartociami z tablicy.
+ * @brief Wypełnia określoną kolumnę macierzy wartościami z tablicy.
  *
- * Wypenia kolumn o indeksie `x` wartociami z tablicy `t`.
- * Wartoci `t[i]` s przypisane do pozycji `(i, x)` w macierzy.
+ * Wypełnia kolumnę o indeksie `x` wartościami z tablicy `t`.
+ * Wartości `t[i]` są przypisane do pozycji `(i, x)` w macierzy.
  *
- * @param x Indeks kolumny do wypenienia.
- * @param t Tablica wartoci do wypenienia kolumny.
- * @return Referencja do biecej macierzy.
+ * @param x Indeks kolumny do wypełnienia.
+ * @param t Tablica wartości do wypełnienia kolumny.
+ * @return Referencja do bieżącej macierzy.
  */
 matrix& matrix::kolumna(int x, int* t) {
+	sledzenie::zakres sledz("kolumna", n, 2LL * n * sizeof(int));
+	do_zapisu();
 	for (int i = 0; i < n; i++) {
 		data[i][x] = t[i];
 	}
@@ -250,16 +698,18 @@ matrix& matrix::kolumna(int x, int* t) {
 }
 
 /**
- * @brief Wypenia okrelony wiersz macierzy wartociami z tablicy.
+ * @brief Wypełnia określony wiersz macierzy wartościami z tablicy.
  *
- * Wypenia wiersz o indeksie `y` wartociami z tablicy `t`.
- * Wartoci `t[i]` s przypisane do pozycji `(y, i)` w macierzy.
+ * Wypełnia wiersz o indeksie `y` wartościami z tablicy `t`.
+ * Wartości `t[i]` są przypisane do pozycji `(y, i)` w macierzy.
  *
- * @param y Indeks wiersza do wypenienia.
- * @param t Tablica wartoci do wypenienia wiersza.
- * @return Referencja do biecej macierzy.
+ * @param y Indeks wiersza do wypełnienia.
+ * @param t Tablica wartości do wypełnienia wiersza.
+ * @return Referencja do bieżącej macierzy.
  */
 matrix& matrix::wiersz(int y, int* t) {
+	sledzenie::zakres sledz("wiersz", n, 2LL * n * sizeof(int));
+	do_zapisu();
 	for (int i = 0; i < n; i++) {
 		data[y][i] = t[i];
 	}
@@ -267,14 +717,15 @@ matrix& matrix::wiersz(int y, int* t) {
 }
 
 /**
- * @brief Wywietla gwn przektn macierzy.
+ * @brief Wyświetla główną przekątną macierzy.
  *
- * Wypisuje na standardowe wyjcie wartoci znajdujce si na gwnej przektnej macierzy.
+ * Wypisuje na standardowe wyjście wartości znajdujące się na głównej przekątnej macierzy.
  * Nie modyfikuje macierzy.
  *
- * @return Referencja do biecej macierzy.
+ * @return Referencja do bieżącej macierzy.
  */
 matrix& matrix::przekatna() {
+	sledzenie::zakres sledz("przekatna", n, (long long)n * sizeof(int));
 	for (int i = 0; i < n; i++) {
 		cout << data[i][i] << " ";
 	}
@@ -283,14 +734,15 @@ matrix& matrix::przekatna() {
 }
 
 /**
- * @brief Wywietla elementy macierzy znajdujce si pod gwn przektn.
+ * @brief Wyświetla elementy macierzy znajdujące się pod główną przekątną.
  *
- * Elementy poniej gwnej przektnej s wypisywane na standardowe wyjcie w odpowiednich wierszach.
+ * Elementy poniżej głównej przekątnej są wypisywane na standardowe wyjście w odpowiednich wierszach.
  * Funkcja nie modyfikuje macierzy.
  *
- * @return Referencja do biecej macierzy.
+ * @return Referencja do bieżącej macierzy.
  */
 matrix& matrix::pod_przekatna() {
+	sledzenie::zakres sledz("pod_przekatna", n, bajty_macierzy(n, 1) / 2);
 	for (int i = 0; i < n; i++) {
 		for (int j = 0; j < i; j++) {
 			cout << data[i][j] << " ";
@@ -301,14 +753,15 @@ matrix& matrix::pod_przekatna() {
 }
 
 /**
- * @brief Wywietla elementy macierzy znajdujce si nad gwn przektn.
+ * @brief Wyświetla elementy macierzy znajdujące się nad główną przekątną.
  *
- * Elementy powyej gwnej przektnej s wypisywane na standardowe wyjcie w odpowiednich wierszach.
+ * Elementy powyżej głównej przekątnej są wypisywane na standardowe wyjście w odpowiednich wierszach.
  * Funkcja nie modyfikuje macierzy.
  *
- * @return Referencja do biecej macierzy.
+ * @return Referencja do bieżącej macierzy.
  */
 matrix& matrix::nad_przekatna() {
+	sledzenie::zakres sledz("nad_przekatna", n, bajty_macierzy(n, 1) / 2);
 	for (int i = 0; i < n; i++) {
 		for (int j = i + 1; j < n; j++) {
 			cout << data[i][j] << " ";
@@ -319,16 +772,17 @@ matrix& matrix::nad_przekatna() {
 }
 
 /**
- * @brief Wywietla macierz w formie szachownicy.
+ * @brief Wyświetla macierz w formie szachownicy.
  *
- * Elementy macierzy s wypisywane zgodnie z wzorem szachownicy:
- * - Elementy, ktrych suma indeksw `(i + j)` jest parzysta, s wypisywane.
- * - Elementy, ktrych suma indeksw `(i + j)` jest nieparzysta, s zastpowane `0`.
+ * Elementy macierzy są wypisywane zgodnie z wzorem szachownicy:
+ * - Elementy, których suma indeksów `(i + j)` jest parzysta, są wypisywane.
+ * - Elementy, których suma indeksów `(i + j)` jest nieparzysta, są zastępowane `0`.
  * Funkcja nie modyfikuje macierzy.
  *
- * @return Referencja do biecej macierzy.
+ * @return Referencja do bieżącej macierzy.
  */
 matrix& matrix::szachownica() {
+	sledzenie::zakres sledz("szachownica", n, bajty_macierzy(n, 1));
 	for (int i = 0; i < n; i++) {
 		for (int j = 0; j < n; j++) {
 			if ((i + j) % 2 == 0) {
@@ -344,16 +798,343 @@ matrix& matrix::szachownica() {
 }
 
 /**
- * @brief Dodawanie dwch macierzy.
+ * @brief Zamienia zawartość dwóch macierzy.
+ *
+ * Zamieniane są jedynie rozmiary i wskaźniki na dane, więc operacja nie kopiuje elementów.
+ *
+ * @param m Macierz, z którą następuje zamiana.
+ */
+void matrix::zamien(matrix& m) {
+	swap(n, m.n);
+	swap(data, m.data);
+	swap(buf, m.buf);
+}
+
+/**
+ * @brief Wyznacza szerokość paska kolumn dla jądra mnożenia.
+ *
+ * Pasek macierzy prawego czynnika o wymiarach n x szerokość zajmuje około `kb` KB
+ * (dobiera strojenie, domyślnie 512), dzięki czemu pozostaje w pamięci podręcznej
+ * podczas przechodzenia po wierszach.
+ *
+ * @param n Rozmiar macierzy.
+ * @param kb Rozmiar paska w KB.
+ * @return Szerokość paska (wielokrotność 16, nie większa niż n).
+ */
+static int szerokosc_paska(int n, int kb) {
+	int s = (int)((long long)kb * 1024 / sizeof(int) / (n > 0 ? n : 1));
+	s -= s % 16;
+	if (s < 16) {
+		s = 16;
+	}
+	return s < n ? s : n;
+}
+
+/**
+ * @brief Jądro iloczynu macierzy.
+ *
+ * Wiersze wyniku są dzielone między wątki puli. Każdy wątek przechodzi po paskach kolumn
+ * macierzy `b` w kolejności i-k-j, więc najgłębsza pętla czyta i zapisuje ciągłą pamięć.
+ * Bez modułu obliczenia są wykonywane na liczbach bez znaku (zawijanie modulo 2^32),
+ * a najgłębsza pętla może dodawać naraz 2 lub 4 wiersze `b` (rozwinięcie dobiera
+ * strojenie), co zmniejsza liczbę odczytów i zapisów wiersza wyniku.
+ * Z modułem iloczyny są sumowane w 64 bitach, a redukcja wykonywana jest dopiero wtedy,
+ * gdy kolejny składnik mógłby przepełnić akumulator. Elementy `a` i `b` muszą wtedy
+ * należeć do przedziału [0, mod).
+ *
+ * @param a Lewy czynnik.
+ * @param b Prawy czynnik.
+ * @param c Macierz wynikowa (różna od a i b).
+ * @param mod Moduł arytmetyki lub 0.
+ * @param bufor Bufor pomocniczy (n elementów na wątek), wymagany gdy mod > 0.
+ */
+void matrix::mnoz(const matrix& a, const matrix& b, matrix& c, int mod, unsigned long long* bufor) {
+	int n = a.n;
+	strojenie::ustawienia u = strojenie::biezace();
+	int pasek = szerokosc_paska(n, u.pasek_kb);
+	int rozwiniecie = u.rozwiniecie;
+	unsigned long long m = (unsigned long long)mod;
+	unsigned long long limit = 0;
+	if (mod > 1) {
+		limit = (ULLONG_MAX - m) / ((m - 1) * (m - 1));
+	}
+	else if (mod == 1) {
+		limit = ULLONG_MAX;
+	}
+
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int watek) {
+		unsigned long long* akumulator = bufor ? bufor + (size_t)watek * n : nullptr;
+		for (int jj = 0; jj < n; jj += pasek) {
+			int jk = jj + pasek < n ? jj + pasek : n;
+			for (int i = od; i < do_; i++) {
+				const int* wa = a.data[i];
+				if (mod > 0) {
+					for (int j = jj; j < jk; j++) {
+						akumulator[j] = 0;
+					}
+					unsigned long long skladniki = 0;
+					for (int k = 0; k < n; k++) {
+						unsigned long long aik = (unsigned int)wa[k];
+						if (aik == 0) {
+							continue;
+						}
+						const int* wb = b.data[k];
+						for (int j = jj; j < jk; j++) {
+							akumulator[j] += aik * (unsigned int)wb[j];
+						}
+						if (++skladniki == limit) {
+							for (int j = jj; j < jk; j++) {
+								akumulator[j] %= m;
+							}
+							skladniki = 0;
+						}
+					}
+					for (int j = jj; j < jk; j++) {
+						c.data[i][j] = (int)(akumulator[j] % m);
+					}
+				}
+				else {
+					unsigned int* wc = (unsigned int*)c.data[i];
+					for (int j = jj; j < jk; j++) {
+						wc[j] = 0;
+					}
+					int k = 0;
+					if (rozwiniecie == 4) {
+						for (; k + 4 <= n; k += 4) {
+							unsigned int a0 = (unsigned int)wa[k];
+							unsigned int a1 = (unsigned int)wa[k + 1];
+							unsigned int a2 = (unsigned int)wa[k + 2];
+							unsigned int a3 = (unsigned int)wa[k + 3];
+							if ((a0 | a1 | a2 | a3) == 0) {
+								continue;
+							}
+							const unsigned int* b0 = (const unsigned int*)b.data[k];
+							const unsigned int* b1 = (const unsigned int*)b.data[k + 1];
+							const unsigned int* b2 = (const unsigned int*)b.data[k + 2];
+							const unsigned int* b3 = (const unsigned int*)b.data[k + 3];
+							for (int j = jj; j < jk; j++) {
+								wc[j] += a0 * b0[j] + a1 * b1[j] + a2 * b2[j] + a3 * b3[j];
+							}
+						}
+					}
+					if (rozwiniecie >= 2) {
+						for (; k + 2 <= n; k += 2) {
+							unsigned int a0 = (unsigned int)wa[k];
+							unsigned int a1 = (unsigned int)wa[k + 1];
+							if ((a0 | a1) == 0) {
+								continue;
+							}
+							const unsigned int* b0 = (const unsigned int*)b.data[k];
+							const unsigned int* b1 = (const unsigned int*)b.data[k + 1];
+							for (int j = jj; j < jk; j++) {
+								wc[j] += a0 * b0[j] + a1 * b1[j];
+							}
+						}
+					}
+					for (; k < n; k++) {
+						unsigned int aik = (unsigned int)wa[k];
+						if (aik == 0) {
+							continue;
+						}
+						const unsigned int* wb = (const unsigned int*)b.data[k];
+						for (int j = jj; j < jk; j++) {
+							wc[j] += aik * wb[j];
+						}
+					}
+				}
+			}
+		}
+	}, 32);
+}
+
+/**
+ * @brief Iloczyn macierzy w sensie algebraicznym.
+ *
+ * W odróżnieniu od operatora `*`, który mnoży elementy parami, oblicza klasyczny
+ * iloczyn wiersz razy kolumna. Przepełnienia są zawijane modulo 2^32.
+ *
+ * @param m Prawy czynnik iloczynu.
+ * @return Nowa macierz będąca iloczynem.
+ * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+ */
+matrix matrix::iloczyn(const matrix& m) const {
+	sledzenie::zakres sledz("iloczyn", n, bajty_macierzy(n, 3));
+	if (n != m.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	matrix wynik(n);
+	mnoz(*this, m, wynik, 0, nullptr);
+	return wynik;
+}
+
+/**
+ * @brief Potęgowanie macierzy przez podnoszenie do kwadratu.
+ *
+ * Zastępuje macierz jej k-tą potęgą, wykonując O(log k) iloczynów. Wszystkie bufory
+ * pośrednie są alokowane raz, a kolejne kroki jedynie zamieniają je miejscami.
+ * Dla `mod > 0` wynik jest liczony modulo `mod` (elementy ujemne są najpierw
+ * sprowadzane do przedziału [0, mod)), co pozwala uniknąć przepełnienia przy dużych k,
+ * np. przy zliczaniu ścieżek w grafie. Dla `mod == 0` przepełnienia są zawijane.
+ *
+ * @param k Wykładnik (k >= 0). Dla k == 0 wynikiem jest macierz jednostkowa.
+ * @param mod Moduł arytmetyki; 0 oznacza obliczenia bez redukcji.
+ * @return Referencja do bieżącej macierzy.
+ * @throws std::invalid_argument Jeśli wykładnik lub moduł jest ujemny.
+ */
+matrix& matrix::potega(long long k, int mod) {
+	sledzenie::zakres sledz("potega", n, bajty_macierzy(n, 3));
+	if (k < 0 || mod < 0) {
+		throw invalid_argument("Negative exponent or modulus");
+	}
+	if (k == 0) {
+		do_zapisu();
+		for (int i = 0; i < n; i++) {
+			for (int j = 0; j < n; j++) {
+				data[i][j] = (i == j && mod != 1) ? 1 : 0;
+			}
+		}
+		return *this;
+	}
+
+	matrix baza(*this);
+	baza.do_zapisu();
+	if (mod > 0) {
+		for (int i = 0; i < n; i++) {
+			for (int j = 0; j < n; j++) {
+				baza.data[i][j] = (baza.data[i][j] % mod + mod) % mod;
+			}
+		}
+	}
+	matrix wynik(n);
+	matrix tmp(n);
+	vector<unsigned long long> bufor(mod > 0 ? (size_t)n * pula_watkow::globalna().liczba_watkow() : 0);
+	unsigned long long* b = bufor.empty() ? nullptr : bufor.data();
+
+	bool pierwszy = true;
+	for (;;) {
+		if (k & 1) {
+			if (pierwszy) {
+				for (int i = 0; i < n; i++) {
+					for (int j = 0; j < n; j++) {
+						wynik.data[i][j] = baza.data[i][j];
+					}
+				}
+				pierwszy = false;
+			}
+			else {
+				mnoz(wynik, baza, tmp, mod, b);
+				wynik.zamien(tmp);
+			}
+		}
+		k >>= 1;
+		if (k == 0) {
+			break;
+		}
+		mnoz(baza, baza, tmp, mod, b);
+		baza.zamien(tmp);
+	}
+	zamien(wynik);
+	return *this;
+}
+
+/**
+ * @brief Jeden krok eliminacji Bareissa: (aij * akk - aik * akj) / poprzedni.
  *
- * Tworzy now macierz, ktra jest wynikiem dodawania biecej macierzy i macierzy `m`.
- * Elementy odpowiadajcych sobie pozycji s sumowane.
+ * Iloczyny są liczone na 128 bitach, jeśli kompilator to umożliwia. Każdy z nich leży
+ * w [-2^126 + 2^63, 2^126], więc różnica mieści się w [-2^127 + 2^64, 2^127 - 2^63]
+ * i nie przepełnia __int128; sprawdzany jest tylko zakres ilorazu. W przeciwnym razie
+ * każdy iloczyn musi mieć moduł najwyżej 4 * 10^18, więc różnica mieści się w 64 bitach.
+ * Dzielenie jest zawsze dokładne.
  *
- * @param m Macierz, ktr naley doda do biecej macierzy.
- * @return Nowa macierz, bdca wynikiem operacji dodawania.
- * @throws std::bad_alloc Jeli alokacja pamici dla wyniku si nie powiedzie.
+ * @throws std::overflow_error Jeśli wynik pośredni nie mieści się w typie long long.
+ */
+static long long krok_bareissa(long long aij, long long akk, long long aik, long long akj, long long poprzedni) {
+#ifdef __SIZEOF_INT128__
+	__int128 w = ((__int128)aij * akk - (__int128)aik * akj) / poprzedni;
+	if (w > LLONG_MAX || w < LLONG_MIN) {
+		throw overflow_error("Determinant overflow");
+	}
+	return (long long)w;
+#else
+	const long double granica = 4.0e18L;
+	if (fabsl((long double)aij * akk) > granica || fabsl((long double)aik * akj) > granica) {
+		throw overflow_error("Determinant overflow");
+	}
+	return (aij * akk - aik * akj) / poprzedni;
+#endif
+}
+
+/**
+ * @brief Oblicza wyznacznik macierzy bez ułamków (algorytm Bareissa).
+ *
+ * Każdy element pośredni jest minorem macierzy wejściowej, więc wszystkie dzielenia są
+ * dokładne, a wynik jest liczbą całkowitą bez błędów zaokrągleń. Wymaga O(n^3) operacji
+ * i kopii macierzy na liczbach 64-bitowych. Dla macierzy zmiennoprzecinkowych
+ * oraz do rozwiązywania układów służy klasa rozklad_lu.
+ *
+ * Elementy pośrednie są minorami, więc z nierówności Hadamarda ich moduł nie przekracza
+ * n^(n/2) * max|a_ij|^n; wynik jest dokładny, dopóki każdy minor mieści się w long long.
+ * Dla elementów typu int oznacza to gwarancję tylko dla małych n lub małych wartości -
+ * przy większych zgłaszany jest wyjątek zamiast zawiniętego wyniku.
+ *
+ * @return Wyznacznik macierzy (1 dla macierzy pustej).
+ * @throws std::overflow_error Jeśli minor lub wynik ze znakiem permutacji nie mieści się
+ *         w typie long long.
+ */
+long long matrix::wyznacznik() const {
+	sledzenie::zakres sledz("wyznacznik", n, bajty_macierzy(n, 3));
+	vector<long long> a((size_t)n * n);
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			a[(size_t)i * n + j] = data[i][j];
+		}
+	}
+
+	int znak = 1;
+	long long poprzedni = 1;
+	for (int k = 0; k < n - 1; k++) {
+		long long* wk = &a[(size_t)k * n];
+		if (wk[k] == 0) {
+			int p = k + 1;
+			while (p < n && a[(size_t)p * n + k] == 0) {
+				p++;
+			}
+			if (p == n) {
+				return 0;
+			}
+			swap_ranges(wk, wk + n, &a[(size_t)p * n]);
+			znak = -znak;
+		}
+		for (int i = k + 1; i < n; i++) {
+			long long* wi = &a[(size_t)i * n];
+			for (int j = k + 1; j < n; j++) {
+				wi[j] = krok_bareissa(wi[j], wk[k], wi[k], wk[j], poprzedni);
+			}
+		}
+		poprzedni = wk[k];
+	}
+	if (n == 0) {
+		return 1;
+	}
+	long long wynik = a[(size_t)n * n - 1];
+	if (znak < 0 && wynik == LLONG_MIN) {
+		throw overflow_error("Determinant overflow");
+	}
+	return znak * wynik;
+}
+
+/**
+ * @brief Dodawanie dwóch macierzy.
+ *
+ * Tworzy nową macierz, która jest wynikiem dodawania bieżącej macierzy i macierzy `m`.
+ * Elementy odpowiadających sobie pozycji są sumowane.
+ *
+ * @param m Macierz, którą należy dodać do bieżącej macierzy.
+ * @return Nowa macierz, będąca wynikiem operacji dodawania.
+ * @throws std::bad_alloc Jeśli alokacja pamięci dla wyniku się nie powiedzie.
  */
 matrix& matrix::operator+(matrix& m) {
+	sledzenie::zakres sledz("operator+(matrix)", n, bajty_macierzy(n, 3));
 	matrix* wynik = new matrix(n);
 	for (int i = 0; i < n; i++) {
 		for (int j = 0; j < n; j++) {
@@ -364,17 +1145,18 @@ matrix& matrix::operator+(matrix& m) {
 }
 
 /**
- * @brief Mnoenie dwch macierzy element po elemencie.
+ * @brief Mnożenie dwóch macierzy element po elemencie.
  *
- * Tworzy now macierz, ktra jest wynikiem mnoenia elementw biecej macierzy i macierzy `m`.
- * Obie macierze musz mie taki sam rozmiar.
+ * Tworzy nową macierz, która jest wynikiem mnożenia elementów bieżącej macierzy i macierzy `m`.
+ * Obie macierze muszą mieć taki sam rozmiar.
  *
- * @param m Macierz, z ktr naley wykona mnoenie.
- * @return Nowa macierz, bdca wynikiem operacji mnoenia.
- * @throws std::invalid_argument Jeli macierze maj rne rozmiary.
- * @throws std::bad_alloc Jeli alokacja pamici dla wyniku si nie powiedzie.
+ * @param m Macierz, z którą należy wykonać mnożenie.
+ * @return Nowa macierz, będąca wynikiem operacji mnożenia.
+ * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+ * @throws std::bad_alloc Jeśli alokacja pamięci dla wyniku się nie powiedzie.
  */
 matrix& matrix::operator*(matrix& m) {
+	sledzenie::zakres sledz("operator*(matrix)", n, bajty_macierzy(n, 3));
 	if (n != m.n) {
 		cerr << "Matrix dimensions must match for multiplication!" << endl;
 		throw invalid_argument("Matrix dimensions mismatch");
@@ -393,16 +1175,17 @@ matrix& matrix::operator*(matrix& m) {
 
 
 /**
- * @brief Dodawanie liczby do wszystkich elementw macierzy.
+ * @brief Dodawanie liczby do wszystkich elementów macierzy.
  *
- * Tworzy now macierz, ktrej kady element jest sum odpowiadajcego elementu biecej macierzy
+ * Tworzy nową macierz, której każdy element jest sumą odpowiadającego elementu bieżącej macierzy
  * i liczby `a`.
  *
- * @param a Liczba do dodania do kadego elementu macierzy.
- * @return Nowa macierz, bdca wynikiem dodawania.
- * @throws std::bad_alloc Jeli alokacja pamici dla wyniku si nie powiedzie.
+ * @param a Liczba do dodania do każdego elementu macierzy.
+ * @return Nowa macierz, będąca wynikiem dodawania.
+ * @throws std::bad_alloc Jeśli alokacja pamięci dla wyniku się nie powiedzie.
  */
 matrix& matrix::operator+(int a) {
+	sledzenie::zakres sledz("operator+(int)", n, bajty_macierzy(n, 2));
 	matrix* wynik = new matrix(n);
 	for (int i = 0; i < n; i++) {
 		for (int j = 0; j < n; j++) {
@@ -413,16 +1196,17 @@ matrix& matrix::operator+(int a) {
 }
 
 /**
- * @brief Mnoenie wszystkich elementw macierzy przez liczb.
+ * @brief Mnożenie wszystkich elementów macierzy przez liczbę.
  *
- * Tworzy now macierz, ktrej kady element jest wynikiem pomnoenia odpowiadajcego elementu
- * biecej macierzy przez liczb `a`.
+ * Tworzy nową macierz, której każdy element jest wynikiem pomnożenia odpowiadającego elementu
+ * bieżącej macierzy przez liczbę `a`.
  *
- * @param a Liczba, przez ktr mnoymy kady element macierzy.
- * @return Nowa macierz, bdca wynikiem mnoenia.
- * @throws std::bad_alloc Jeli alokacja pamici dla wyniku si nie powiedzie.
+ * @param a Liczba, przez którą mnożymy każdy element macierzy.
+ * @return Nowa macierz, będąca wynikiem mnożenia.
+ * @throws std::bad_alloc Jeśli alokacja pamięci dla wyniku się nie powiedzie.
  */
 matrix& matrix::operator*(int a) {
+	sledzenie::zakres sledz("operator*(int)", n, bajty_macierzy(n, 2));
 	matrix* wynik = new matrix(n);
 	for (int i = 0; i < n; i++) {
 		for (int j = 0; j < n; j++) {
@@ -433,16 +1217,17 @@ matrix& matrix::operator*(int a) {
 }
 
 /**
- * @brief Odejmowanie liczby od wszystkich elementw macierzy.
+ * @brief Odejmowanie liczby od wszystkich elementów macierzy.
  *
- * Tworzy now macierz, ktrej kady element jest rnic odpowiadajcego elementu biecej macierzy
+ * Tworzy nową macierz, której każdy element jest różnicą odpowiadającego elementu bieżącej macierzy
  * i liczby `a`.
  *
- * @param a Liczba do odjcia od kadego elementu macierzy.
- * @return Nowa macierz, bdca wynikiem odejmowania.
- * @throws std::bad_alloc Jeli alokacja pamici dla wyniku si nie powiedzie.
+ * @param a Liczba do odjęcia od każdego elementu macierzy.
+ * @return Nowa macierz, będąca wynikiem odejmowania.
+ * @throws std::bad_alloc Jeśli alokacja pamięci dla wyniku się nie powiedzie.
  */
 matrix& matrix::operator-(int a) {
+	sledzenie::zakres sledz("operator-(int)", n, bajty_macierzy(n, 2));
 	matrix* wynik = new matrix(n);
 	for (int i = 0; i < n; i++) {
 		for (int j = 0; j < n; j++) {
@@ -453,17 +1238,18 @@ matrix& matrix::operator-(int a) {
 }
 
 /**
- * @brief Dodawanie liczby do wszystkich elementw macierzy (operator globalny).
+ * @brief Dodawanie liczby do wszystkich elementów macierzy (operator globalny).
  *
- * Tworzy now macierz, ktrej kady element jest sum liczby `a` i odpowiadajcego elementu
+ * Tworzy nową macierz, której każdy element jest sumą liczby `a` i odpowiadającego elementu
  * macierzy `m`.
  *
- * @param a Liczba do dodania do kadego elementu macierzy.
- * @param m Macierz, do ktrej elementw dodawana jest liczba `a`.
- * @return Nowa macierz, bdca wynikiem dodawania.
- * @throws std::bad_alloc Jeli alokacja pamici dla wyniku si nie powiedzie.
+ * @param a Liczba do dodania do każdego elementu macierzy.
+ * @param m Macierz, do której elementów dodawana jest liczba `a`.
+ * @return Nowa macierz, będąca wynikiem dodawania.
+ * @throws std::bad_alloc Jeśli alokacja pamięci dla wyniku się nie powiedzie.
  */
 matrix operator+(int a, matrix& m) {
+	sledzenie::zakres sledz("operator+(int, matrix)", m.n, bajty_macierzy(m.n, 2));
 	matrix* wynik = new matrix(m.n);
 	for (int i = 0; i < m.n; i++) {
 		for (int j = 0; j < m.n; j++) {
@@ -474,17 +1260,18 @@ matrix operator+(int a, matrix& m) {
 }
 
 /**
- * @brief Mnoenie wszystkich elementw macierzy przez liczb (operator globalny).
+ * @brief Mnożenie wszystkich elementów macierzy przez liczbę (operator globalny).
  *
- * Tworzy now macierz, ktrej kady element jest wynikiem pomnoenia liczby `a`
- * przez odpowiadajcy element macierzy `m`.
+ * Tworzy nową macierz, której każdy element jest wynikiem pomnożenia liczby `a`
+ * przez odpowiadający element macierzy `m`.
  *
- * @param a Liczba, przez ktr mnoymy kady element macierzy.
- * @param m Macierz, ktrej elementy s mnoone przez liczb `a`.
- * @return Nowa macierz, bdca wynikiem mnoenia.
- * @throws std::bad_alloc Jeli alokacja pamici dla wyniku si nie powiedzie.
+ * @param a Liczba, przez którą mnożymy każdy element macierzy.
+ * @param m Macierz, której elementy są mnożone przez liczbę `a`.
+ * @return Nowa macierz, będąca wynikiem mnożenia.
+ * @throws std::bad_alloc Jeśli alokacja pamięci dla wyniku się nie powiedzie.
  */
 matrix operator*(int a, matrix& m) {
+	sledzenie::zakres sledz("operator*(int, matrix)", m.n, bajty_macierzy(m.n, 2));
 	matrix* wynik = new matrix(m.n);
 	for (int i = 0; i < m.n; i++) {
 		for (int j = 0; j < m.n; j++) {
@@ -495,17 +1282,18 @@ matrix operator*(int a, matrix& m) {
 }
 
 /**
- * @brief Odejmowanie liczby od wszystkich elementw macierzy (operator globalny).
+ * @brief Odejmowanie liczby od wszystkich elementów macierzy (operator globalny).
  *
- * Tworzy now macierz, ktrej kady element jest rnic liczby `a` i odpowiadajcego elementu
+ * Tworzy nową macierz, której każdy element jest różnicą liczby `a` i odpowiadającego elementu
  * macierzy `m`.
  *
- * @param a Liczba, od ktrej odejmujemy kady element macierzy.
- * @param m Macierz, ktrej elementy s odejmowane od liczby `a`.
- * @return Nowa macierz, bdca wynikiem odejmowania.
- * @throws std::bad_alloc Jeli alokacja pamici dla wyniku si nie powiedzie.
+ * @param a Liczba, od której odejmujemy każdy element macierzy.
+ * @param m Macierz, której elementy są odejmowane od liczby `a`.
+ * @return Nowa macierz, będąca wynikiem odejmowania.
+ * @throws std::bad_alloc Jeśli alokacja pamięci dla wyniku się nie powiedzie.
  */
 matrix operator-(int a, matrix& m) {
+	sledzenie::zakres sledz("operator-(int, matrix)", m.n, bajty_macierzy(m.n, 2));
 	matrix* wynik = new matrix(m.n);
 	for (int i = 0; i < m.n; i++) {
 		for (int j = 0; j < m.n; j++) {
@@ -516,13 +1304,15 @@ matrix operator-(int a, matrix& m) {
 }
 
 /**
- * @brief Postinkrementacja elementw macierzy.
+ * @brief Postinkrementacja elementów macierzy.
  *
- * Zwiksza wszystkie elementy macierzy o 1. Operacja jest wykonywana w miejscu.
+ * Zwiększa wszystkie elementy macierzy o 1. Operacja jest wykonywana w miejscu.
  *
- * @return Referencja do biecej macierzy po inkrementacji.
+ * @return Referencja do bieżącej macierzy po inkrementacji.
  */
 matrix& matrix::operator++(int) {
+	sledzenie::zakres sledz("operator++", n, bajty_macierzy(n, 2));
+	do_zapisu();
 	for (int i = 0; i < n; i++) {
 		for (int j = 0; j < n; j++) {
 			data[i][j]++;
@@ -532,13 +1322,15 @@ matrix& matrix::operator++(int) {
 }
 
 /**
- * @brief Postdekrementacja elementw macierzy.
+ * @brief Postdekrementacja elementów macierzy.
  *
  * Zmniejsza wszystkie elementy macierzy o 1. Operacja jest wykonywana w miejscu.
  *
- * @return Referencja do biecej macierzy po dekrementacji.
+ * @return Referencja do bieżącej macierzy po dekrementacji.
  */
 matrix& matrix::operator--(int) {
+	sledzenie::zakres sledz("operator--", n, bajty_macierzy(n, 2));
+	do_zapisu();
 	for (int i = 0; i < n; i++) {
 		for (int j = 0; j < n; j++) {
 			data[i][j]--;
@@ -548,67 +1340,86 @@ matrix& matrix::operator--(int) {
 }
 
 /**
- * @brief Dodawanie liczby do wszystkich elementw macierzy (operator `+=`).
+ * @brief Dodawanie liczby do wszystkich elementów macierzy (operator `+=`).
  *
- * Zwiksza kady element macierzy o warto `a`. Operacja jest wykonywana w miejscu.
+ * Zwiększa każdy element macierzy o wartość `a`. Operacja jest wykonywana w miejscu.
+ * Wiersze są dzielone między wątki puli, gdy macierz ma co najmniej tyle wierszy,
+ * ile wynosi próg dobrany przez strojenie.
  *
- * @param a Liczba do dodania do kadego elementu macierzy.
- * @return Referencja do biecej macierzy po operacji.
+ * @param a Liczba do dodania do każdego elementu macierzy.
+ * @return Referencja do bieżącej macierzy po operacji.
  */
 matrix& matrix::operator+=(int a) {
-	for (int i = 0; i < n; i++) {
-		for (int j = 0; j < n; j++) {
-			data[i][j] += a;
+	sledzenie::zakres sledz("operator+=", n, bajty_macierzy(n, 2));
+	do_zapisu();
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			for (int j = 0; j < n; j++) {
+				data[i][j] += a;
+			}
 		}
-	}
+	}, prog_rownoleglosci());
 	return *this;
 }
 
 /**
- * @brief Odejmowanie liczby od wszystkich elementw macierzy (operator `-=`).
+ * @brief Odejmowanie liczby od wszystkich elementów macierzy (operator `-=`).
  *
- * Zmniejsza kady element macierzy o warto `a`. Operacja jest wykonywana w miejscu.
+ * Zmniejsza każdy element macierzy o wartość `a`. Operacja jest wykonywana w miejscu.
+ * Wiersze są dzielone między wątki puli, gdy macierz ma co najmniej tyle wierszy,
+ * ile wynosi próg dobrany przez strojenie.
  *
- * @param a Liczba do odjcia od kadego elementu macierzy.
- * @return Referencja do biecej macierzy po operacji.
+ * @param a Liczba do odjęcia od każdego elementu macierzy.
+ * @return Referencja do bieżącej macierzy po operacji.
  */
 matrix& matrix::operator-=(int a) {
-	for (int i = 0; i < n; i++) {
-		for (int j = 0; j < n; j++) {
-			data[i][j] -= a;
+	sledzenie::zakres sledz("operator-=", n, bajty_macierzy(n, 2));
+	do_zapisu();
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			for (int j = 0; j < n; j++) {
+				data[i][j] -= a;
+			}
 		}
-	}
+	}, prog_rownoleglosci());
 	return *this;
 }
 
 /**
- * @brief Mnoenie wszystkich elementw macierzy przez liczb (operator `*=`).
+ * @brief Mnożenie wszystkich elementów macierzy przez liczbę (operator `*=`).
  *
- * Mnoy kady element macierzy przez warto `a`. Operacja jest wykonywana w miejscu.
+ * Mnoży każdy element macierzy przez wartość `a`. Operacja jest wykonywana w miejscu.
+ * Wiersze są dzielone między wątki puli, gdy macierz ma co najmniej tyle wierszy,
+ * ile wynosi próg dobrany przez strojenie.
  *
- * @param a Liczba, przez ktr mnoymy kady element macierzy.
- * @return Referencja do biecej macierzy po operacji.
+ * @param a Liczba, przez którą mnożymy każdy element macierzy.
+ * @return Referencja do bieżącej macierzy po operacji.
  */
 matrix& matrix::operator*=(int a) {
-	for (int i = 0; i < n; i++) {
-		for (int j = 0; j < n; j++) {
-			data[i][j] *= a;
+	sledzenie::zakres sledz("operator*=", n, bajty_macierzy(n, 2));
+	do_zapisu();
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			for (int j = 0; j < n; j++) {
+				data[i][j] *= a;
+			}
 		}
-	}
+	}, prog_rownoleglosci());
 	return *this;
 }
 
 
 /**
- * @brief Porwnuje dwie macierze na rwno.
+ * @brief Porównuje dwie macierze na równość.
  *
- * Sprawdza, czy macierze maj ten sam rozmiar i odpowiadajce sobie elementy s rwne.
+ * Sprawdza, czy macierze mają ten sam rozmiar i odpowiadające sobie elementy są równe.
  *
- * @param m Macierz, z ktr bieca macierz jest porwnywana.
- * @return true Jeli macierze s rwne.
- * @return false Jeli macierze nie s rwne.
+ * @param m Macierz, z którą bieżąca macierz jest porównywana.
+ * @return true Jeśli macierze są równe.
+ * @return false Jeśli macierze nie są równe.
  */
 bool matrix::operator==(const matrix& m) const {
+	sledzenie::zakres sledz("operator==", n, bajty_macierzy(n, 2));
 	if (n != m.n) {
 		return false;
 	}
@@ -623,60 +1434,49 @@ bool matrix::operator==(const matrix& m) const {
 }
 
 /**
- * @brief Porwnuje sumy elementw dwch macierzy (operator `>`).
+ * @brief Porównuje sumy elementów dwóch macierzy (operator `>`).
  *
- * Oblicza sumy wszystkich elementw obu macierzy i sprawdza, czy suma elementw
- * biecej macierzy jest wiksza od sumy elementw macierzy `m`.
+ * Oblicza sumy wszystkich elementów obu macierzy (64-bitowe, bez przepełnienia,
+ * zob. redukcja::suma) i sprawdza, czy suma elementów bieżącej macierzy jest większa
+ * od sumy elementów macierzy `m`.
  *
- * @param m Macierz, z ktr porwnywana jest bieca macierz.
- * @return true Jeli suma elementw biecej macierzy jest wiksza.
+ * @param m Macierz, z którą porównywana jest bieżąca macierz.
+ * @return true Jeśli suma elementów bieżącej macierzy jest większa.
  * @return false W przeciwnym przypadku.
  */
 bool matrix::operator>(const matrix& m) const {
-	int suma1 = 0;
-	int suma2 = 0;
-	for (int i = 0; i < n; i++) {
-		for (int j = 0; j < n; j++) {
-			suma1 += data[i][j];
-			suma2 += m.data[i][j];
-		}
-	}
-	return suma1 > suma2;
+	sledzenie::zakres sledz("operator>", n, bajty_macierzy(n, 2));
+	return redukcja::suma(*this) > redukcja::suma(m);
 }
 
 /**
- * @brief Porwnuje sumy elementw dwch macierzy (operator `<`).
+ * @brief Porównuje sumy elementów dwóch macierzy (operator `<`).
  *
- * Oblicza sumy wszystkich elementw obu macierzy i sprawdza, czy suma elementw
- * biecej macierzy jest mniejsza od sumy elementw macierzy `m`.
+ * Oblicza sumy wszystkich elementów obu macierzy (64-bitowe, bez przepełnienia,
+ * zob. redukcja::suma) i sprawdza, czy suma elementów bieżącej macierzy jest mniejsza
+ * od sumy elementów macierzy `m`.
  *
- * @param m Macierz, z ktr porwnywana jest bieca macierz.
- * @return true Jeli suma elementw biecej macierzy jest mniejsza.
+ * @param m Macierz, z którą porównywana jest bieżąca macierz.
+ * @return true Jeśli suma elementów bieżącej macierzy jest mniejsza.
  * @return false W przeciwnym przypadku.
  */
 bool matrix::operator<(const matrix& m) const {
-	int suma1 = 0;
-	int suma2 = 0;
-	for (int i = 0; i < n; i++) {
-		for (int j = 0; j < n; j++) {
-			suma1 += data[i][j];
-			suma2 += m.data[i][j];
-		}
-	}
-	return suma1 < suma2;
+	sledzenie::zakres sledz("operator<", n, bajty_macierzy(n, 2));
+	return redukcja::suma(*this) < redukcja::suma(m);
 }
 
 /**
- * @brief Wypisuje macierz na standardowe wyjcie.
+ * @brief Wypisuje macierz na standardowe wyjście.
  *
- * Kady element macierzy jest wypisywany w odpowiedniej pozycji (wiersz po wierszu),
- * oddzielony spacjami. Wiersze s oddzielone znakami nowej linii.
+ * Każdy element macierzy jest wypisywany w odpowiedniej pozycji (wiersz po wierszu),
+ * oddzielony spacjami. Wiersze są oddzielone znakami nowej linii.
  *
- * @param o Strumie wyjciowy, do ktrego macierz zostanie wypisana.
+ * @param o Strumień wyjściowy, do którego macierz zostanie wypisana.
  * @param m Macierz do wypisania.
- * @return Referencja do strumienia wyjciowego.
+ * @return Referencja do strumienia wyjściowego.
  */
 ostream& operator<<(ostream& o, const matrix& m) {
+	sledzenie::zakres sledz("operator<<", m.n, bajty_macierzy(m.n, 1));
 	for (int i = 0; i < m.n; i++) {
 		for (int j = 0; j < m.n; j++) {
 			o << m.data[i][j] << " ";
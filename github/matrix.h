@@ -2,21 +2,74 @@
 #ifndef MATRIX_H
 #define MATRIX_H
 
+#include <atomic>
 #include <iostream>
+#include <utility>
+#include <vector>
 using namespace std;
 
 /**
  * @class matrix
- * @brief Klasa reprezentujca macierz kwadratow i wykonujca rne operacje na niej.
+ * @brief Klasa reprezentująca macierz kwadratową i wykonująca różne operacje na niej.
  */
 class matrix {
 private:
     int n; ///< Rozmiar macierzy (n x n)
-    int** data; ///< Wskanik na dane macierzy
+    int** data; ///< Wskaźnik na dane macierzy (wiersze bufora buf)
+
+    /**
+     * @brief Współdzielony bufor z elementami macierzy.
+     */
+    struct bufor {
+        atomic<int> licznik; ///< Liczba macierzy używających bufora
+        int* elementy; ///< Ciągły blok n*n elementów (wierszami)
+        int** wiersze; ///< Wskaźniki na początki wierszy w bloku elementy
+        atomic<unsigned long long> skrot; ///< Zapamiętany skrót zawartości (0 - nieznany)
+    };
+
+    bufor* buf; ///< Bufor macierzy (nullptr dla macierzy pustej)
+
+    static atomic<bool> wspoldzielenie_; ///< Czy kopie współdzielą bufor
+
+    /**
+     * @brief Alokuje bufor z licznikiem odwołań ustawionym na 1.
+     * @param n Rozmiar macierzy.
+     * @param zeruj Czy wyzerować elementy.
+     * @param zrodlo Elementy do skopiowania (n*n, wierszami) lub nullptr.
+     * @return Nowy bufor lub nullptr dla n <= 0.
+     */
+    static bufor* nowy_bufor(int n, bool zeruj, const int* zrodlo = nullptr);
+
+    /**
+     * @brief Zwalnia odwołanie do bufora i usuwa go, jeśli było ostatnie.
+     * @param b Bufor (może być nullptr).
+     */
+    static void zwolnij(bufor* b);
+
+    /**
+     * @brief Kopiuje współdzielony bufor przed pierwszą modyfikacją.
+     */
+    void do_zapisu();
+
+    /**
+     * @brief Zamienia zawartość dwóch macierzy bez kopiowania elementów.
+     * @param m Macierz, z którą następuje zamiana.
+     */
+    void zamien(matrix& m);
+
+    /**
+     * @brief Jądro iloczynu macierzy c = a * b (opcjonalnie modulo mod).
+     * @param a Lewy czynnik.
+     * @param b Prawy czynnik.
+     * @param c Macierz wynikowa (różna od a i b).
+     * @param mod Moduł arytmetyki lub 0.
+     * @param bufor Bufor pomocniczy (n elementów na wątek), wymagany gdy mod > 0.
+     */
+    static void mnoz(const matrix& a, const matrix& b, matrix& c, int mod, unsigned long long* bufor);
 
 public:
     /**
-     * @brief Konstruktor domylny.
+     * @brief Konstruktor domyślny.
      */
     matrix();
 
@@ -27,15 +80,15 @@ public:
     matrix(int size);
 
     /**
-     * @brief Konstruktor kopiujcy.
+     * @brief Konstruktor kopiujący.
      * @param m Macierz do skopiowania.
      */
     matrix(const matrix& m);
 
     /**
-     * @brief Konstruktor z tablic.
+     * @brief Konstruktor z tablicą.
      * @param size Rozmiar macierzy.
-     * @param t Wskanik na tablic.
+     * @param t Wskaźnik na tablicę.
      */
     matrix(int size, int* t);
 
@@ -45,29 +98,78 @@ public:
     ~matrix();
 
     /**
-     * @brief Alokuje pami dla macierzy.
+     * @brief Operator przypisania.
+     * @param m Macierz przypisywana.
+     * @return Referencja do macierzy.
+     */
+    matrix& operator=(const matrix& m);
+
+    /**
+     * @brief Włącza lub wyłącza współdzielenie buforów przy kopiowaniu (domyślnie włączone).
+     * @param wlacz True - kopiowanie przy zapisie, false - kopiowanie głębokie.
+     */
+    static void wspoldzielenie(bool wlacz);
+
+    /**
+     * @brief Sprawdza, czy bufor macierzy jest współdzielony z inną macierzą.
+     * @return True, jeśli bufor jest współdzielony.
+     */
+    bool wspoldzielona() const;
+
+    /**
+     * @brief Zwraca skrót zawartości macierzy (liczony raz do następnej modyfikacji).
+     * @return Skrót zawartości.
+     */
+    unsigned long long skrot() const;
+
+    /**
+     * @brief Alokuje pamięć dla macierzy.
      * @param size Rozmiar macierzy.
      * @return Referencja do macierzy.
      */
     matrix& alokuj(int size);
 
     /**
-     * @brief Wstawia warto do macierzy.
+     * @brief Wstawia wartość do macierzy.
      * @param x Indeks wiersza.
      * @param y Indeks kolumny.
-     * @param wartosc Warto do wstawienia.
+     * @param wartosc Wartość do wstawienia.
      * @return Referencja do macierzy.
      */
     matrix& wstaw(int x, int y, int wartosc);
 
     /**
-     * @brief Pobiera warto z macierzy.
+     * @brief Pobiera wartość z macierzy.
      * @param x Indeks wiersza.
      * @param y Indeks kolumny.
-     * @return Warto na okrelonej pozycji.
+     * @return Wartość na określonej pozycji.
      */
     int pokaz(int x, int y);
 
+    /**
+     * @brief Wstawia partię wartości (odpowiednik wstaw() w pętli).
+     *
+     * Zakres współrzędnych jest sprawdzany raz dla całej partii. Przy powtórzonej
+     * pozycji obowiązuje ostatnia wartość.
+     *
+     * @param pozycje Współrzędne (wiersz, kolumna).
+     * @param wartosci Wartości (tyle samo co pozycji).
+     * @param pasami Czy najpierw ułożyć partię pasami wierszy po około 256 KB (dla dużych macierzy i losowej kolejności).
+     *        Partie od 65536 pozycji przy puli z kilkoma wątkami są układane zawsze.
+     * @return Referencja do macierzy.
+     * @throws std::invalid_argument Jeśli długości się różnią lub pozycja leży poza macierzą (macierz się nie zmienia).
+     */
+    matrix& rozrzuc(const vector<pair<int, int>>& pozycje, const vector<int>& wartosci, bool pasami = false);
+
+    /**
+     * @brief Odczytuje partię wartości (odpowiednik pokaz() w pętli).
+     * @param pozycje Współrzędne (wiersz, kolumna).
+     * @param wynik Wektor, do którego trafią wartości (zmieniany jest jego rozmiar).
+     * @param pasami Czy czytać pasami wierszy.
+     * @throws std::invalid_argument Jeśli pozycja leży poza macierzą.
+     */
+    void zbierz(const vector<pair<int, int>>& pozycje, vector<int>& wynik, bool pasami = false) const;
+
     /**
      * @brief Transponuje macierz.
      * @return Referencja do macierzy.
@@ -75,73 +177,99 @@ public:
     matrix& odwroc();
 
     /**
-     * @brief Wypenia macierz losowymi wartociami.
+     * @brief Wypełnia macierz losowymi wartościami.
      * @return Referencja do macierzy.
      */
     matrix& losuj();
 
     /**
-     * @brief Wypenia okrelon liczb elementw w macierzy losowymi wartociami.
-     * @param x Liczba elementw do wypenienia.
+     * @brief Wypełnia określoną liczbę elementów w macierzy losowymi wartościami.
+     * @param x Liczba elementów do wypełnienia.
      * @return Referencja do macierzy.
      */
     matrix& losuj(int x);
 
     /**
-     * @brief Wypenia gwn przektn macierzy wartociami z tablicy.
-     * @param t Wskanik na tablic.
+     * @brief Wypełnia główną przekątną macierzy wartościami z tablicy.
+     * @param t Wskaźnik na tablicę.
      * @return Referencja do macierzy.
      */
     matrix& diagonalna(int* t);
 
     /**
-     * @brief Wypenia przektn przesunit o k wartociami z tablicy.
-     * @param k Przesunicie przektnej.
-     * @param t Wskanik na tablic.
+     * @brief Wypełnia przekątną przesuniętą o k wartościami z tablicy.
+     * @param k Przesunięcie przekątnej.
+     * @param t Wskaźnik na tablicę.
      * @return Referencja do macierzy.
      */
     matrix& diagonalna_k(int k, int* t);
 
     /**
-     * @brief Wypenia kolumn macierzy wartociami z tablicy.
+     * @brief Wypełnia kolumnę macierzy wartościami z tablicy.
      * @param x Indeks kolumny.
-     * @param t Wskanik na tablic.
+     * @param t Wskaźnik na tablicę.
      * @return Referencja do macierzy.
      */
     matrix& kolumna(int x, int* t);
 
     /**
-     * @brief Wypenia wiersz macierzy wartociami z tablicy.
+     * @brief Wypełnia wiersz macierzy wartościami z tablicy.
      * @param y Indeks wiersza.
-     * @param t Wskanik na tablic.
+     * @param t Wskaźnik na tablicę.
      * @return Referencja do macierzy.
      */
     matrix& wiersz(int y, int* t);
 
     /**
-     * @brief Wypisuje gwn przektn macierzy.
+     * @brief Wypisuje główną przekątną macierzy.
      * @return Referencja do macierzy.
      */
     matrix& przekatna();
 
     /**
-     * @brief Wypisuje elementy pod gwn przektn macierzy.
+     * @brief Wypisuje elementy pod główną przekątną macierzy.
      * @return Referencja do macierzy.
      */
     matrix& pod_przekatna();
 
     /**
-     * @brief Wypisuje elementy nad gwn przektn macierzy.
+     * @brief Wypisuje elementy nad główną przekątną macierzy.
      * @return Referencja do macierzy.
      */
     matrix& nad_przekatna();
 
     /**
-     * @brief Wypisuje macierz w ukadzie szachownicy.
+     * @brief Wypisuje macierz w układzie szachownicy.
      * @return Referencja do macierzy.
      */
     matrix& szachownica();
 
+    /**
+     * @brief Mnoży dwie macierze w sensie algebraicznym (wiersz razy kolumna).
+     * @param m Prawy czynnik iloczynu.
+     * @return Nowa macierz będąca iloczynem.
+     */
+    matrix iloczyn(const matrix& m) const;
+
+    /**
+     * @brief Podnosi macierz do potęgi metodą szybkiego potęgowania.
+     * @param k Wykładnik (k >= 0).
+     * @param mod Moduł arytmetyki; 0 oznacza obliczenia bez redukcji.
+     * @return Referencja do macierzy.
+     */
+    matrix& potega(long long k, int mod = 0);
+
+    /**
+     * @brief Oblicza dokładny wyznacznik macierzy (algorytm Bareissa).
+     *
+     * Wynik jest dokładny, dopóki każdy minor macierzy mieści się w long long
+     * (z nierówności Hadamarda: |minor rzędu k| <= k^(k/2) * max|a_ij|^k).
+     *
+     * @return Wyznacznik macierzy.
+     * @throws std::overflow_error Jeśli wynik pośredni nie mieści się w typie long long.
+     */
+    long long wyznacznik() const;
+
     /**
      * @brief Dodaje dwie macierze.
      * @param m Macierz do dodania.
@@ -150,8 +278,8 @@ public:
     matrix& operator+(matrix& m);
 
     /**
-     * @brief Mnoy dwie macierze.
-     * @param m Macierz do mnoenia.
+     * @brief Mnoży dwie macierze.
+     * @param m Macierz do mnożenia.
      * @return Referencja do wynikowej macierzy.
      */
     matrix& operator*(matrix& m);
@@ -164,15 +292,15 @@ public:
     matrix& operator+(int a);
 
     /**
-     * @brief Mnoy macierz przez skalar.
-     * @param a Skalar do mnoenia.
+     * @brief Mnoży macierz przez skalar.
+     * @param a Skalar do mnożenia.
      * @return Referencja do wynikowej macierzy.
      */
     matrix& operator*(int a);
 
     /**
      * @brief Odejmuje skalar od macierzy.
-     * @param a Skalar do odjcia.
+     * @param a Skalar do odjęcia.
      * @return Referencja do wynikowej macierzy.
      */
     matrix& operator-(int a);
@@ -186,17 +314,17 @@ public:
     friend matrix operator+(int a, matrix& m);
 
     /**
-     * @brief Mnoy macierz przez skalar.
-     * @param a Skalar do mnoenia.
-     * @param m Macierz do mnoenia.
+     * @brief Mnoży macierz przez skalar.
+     * @param a Skalar do mnożenia.
+     * @param m Macierz do mnożenia.
      * @return Wynikowa macierz.
      */
     friend matrix operator*(int a, matrix& m);
 
     /**
      * @brief Odejmuje skalar od macierzy.
-     * @param a Skalar do odjcia.
-     * @param m Macierz do odjcia.
+     * @param a Skalar do odjęcia.
+     * @param m Macierz do odjęcia.
      * @return Wynikowa macierz.
      */
     friend matrix operator-(int a, matrix& m);
@@ -222,46 +350,61 @@ public:
 
     /**
      * @brief Odejmuje skalar od macierzy.
-     * @param a Skalar do odjcia.
+     * @param a Skalar do odjęcia.
      * @return Referencja do macierzy.
      */
     matrix& operator-=(int a);
 
     /**
-     * @brief Mnoy macierz przez skalar.
-     * @param a Skalar do mnoenia.
+     * @brief Mnoży macierz przez skalar.
+     * @param a Skalar do mnożenia.
      * @return Referencja do macierzy.
      */
     matrix& operator*=(int a);
 
     /**
-     * @brief Porwnuje dwie macierze pod ktem rwnoci.
-     * @param m Macierz do porwnania.
-     * @return True, jeli macierze s rwne, w przeciwnym razie false.
+     * @brief Porównuje dwie macierze pod kątem równości.
+     * @param m Macierz do porównania.
+     * @return True, jeśli macierze są równe, w przeciwnym razie false.
      */
     bool operator==(const matrix& m) const;
 
     /**
-     * @brief Porwnuje, czy ta macierz jest wiksza od innej macierzy.
-     * @param m Macierz do porwnania.
-     * @return True, jeli ta macierz jest wiksza, w przeciwnym razie false.
+     * @brief Porównuje, czy ta macierz jest większa od innej macierzy.
+     * @param m Macierz do porównania.
+     * @return True, jeśli ta macierz jest większa, w przeciwnym razie false.
      */
     bool operator>(const matrix& m) const;
 
     /**
-     * @brief Porwnuje, czy ta macierz jest mniejsza od innej macierzy.
-     * @param m Macierz do porwnania.
-     * @return True, jeli ta macierz jest mniejsza, w przeciwnym razie false.
+     * @brief Porównuje, czy ta macierz jest mniejsza od innej macierzy.
+     * @param m Macierz do porównania.
+     * @return True, jeśli ta macierz jest mniejsza, w przeciwnym razie false.
      */
     bool operator<(const matrix& m) const;
 
     /**
-     * @brief Wypisuje macierz do strumienia wyjciowego.
-     * @param o Strumie wyjciowy.
+     * @brief Wypisuje macierz do strumienia wyjściowego.
+     * @param o Strumień wyjściowy.
      * @param m Macierz do wypisania.
-     * @return Strumie wyjciowy.
+     * @return Strumień wyjściowy.
      */
     friend ostream& operator<<(ostream& o, const matrix& m);
+
+    friend class rozklad_lu;
+    friend class graf_zadan;
+    friend class blas;
+    friend class pamiec_wynikow;
+    friend class maska;
+    template <class U> friend class macierz_ulozona;
+    friend class numa;
+    friend class macierz_rozproszona;
+    friend class strumien;
+    friend class macierz_bitowa;
+    friend class macierz_skompresowana;
+    friend class macierz_wspolbiezna;
+    friend class redukcja;
+    friend class arytmetyka;
 };
 
 #endif // !MATRIX_H
@@ -0,0 +1,281 @@
+/**
+ * @file numa.cpp
+ * @brief Implementacja rozmieszczania pamięci i wątków na węzłach NUMA.
+ */
+
+#include "numa.h"
+#include "matrix.h"
+#include "watki.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/// Bieżąca zasada rozmieszczania.
+static atomic<int> polityka_(numa::pierwszy_dotyk);
+/// Węzeł dla zasady wiazanie.
+static atomic<int> wezel_(0);
+
+#if defined(__linux__)
+/**
+ * @brief Odczytuje listę procesorów węzła z /sys (np. "0-3,8-11").
+ * @param wezel Numer węzła.
+ * @param procesory Wynikowa lista numerów procesorów.
+ * @return True, jeśli węzeł istnieje.
+ */
+static bool procesory_wezla(int wezel, vector<int>& procesory) {
+	char sciezka[64];
+	snprintf(sciezka, sizeof(sciezka), "/sys/devices/system/node/node%d/cpulist", wezel);
+	FILE* f = fopen(sciezka, "r");
+	if (!f) {
+		return false;
+	}
+	procesory.clear();
+	int od, do_;
+	while (fscanf(f, "%d", &od) == 1) {
+		do_ = od;
+		int c = fgetc(f);
+		if (c == '-') {
+			if (fscanf(f, "%d", &do_) != 1) {
+				break;
+			}
+			c = fgetc(f);
+		}
+		for (int p = od; p <= do_; p++) {
+			procesory.push_back(p);
+		}
+		if (c != ',') {
+			break;
+		}
+	}
+	fclose(f);
+	return true;
+}
+#endif
+
+/**
+ * @brief Zwraca liczbę węzłów NUMA.
+ *
+ * Wynik jest ustalany przy pierwszym wywołaniu.
+ *
+ * @return Liczba węzłów (co najmniej 1).
+ */
+int numa::liczba_wezlow() {
+	static const int wezly = [] {
+		int w = 1;
+#if defined(_WIN32)
+		ULONG najwyzszy = 0;
+		if (GetNumaHighestNodeNumber(&najwyzszy)) {
+			w = (int)najwyzszy + 1;
+		}
+#elif defined(__linux__)
+		vector<int> procesory;
+		w = 0;
+		while (w < 64 && procesory_wezla(w, procesory)) {
+			w++;
+		}
+		if (w == 0) {
+			w = 1;
+		}
+#endif
+		return w;
+	}();
+	return wezly;
+}
+
+/**
+ * @brief Ustawia zasadę rozmieszczania.
+ * @param p Zasada rozmieszczania.
+ * @param wezel Węzeł dla zasady wiazanie.
+ * @throws std::invalid_argument Jeśli węzeł nie istnieje.
+ */
+void numa::ustaw_polityke(polityka p, int wezel) {
+	if (p == wiazanie && (wezel < 0 || wezel >= liczba_wezlow())) {
+		throw invalid_argument("NUMA node out of range");
+	}
+	wezel_.store(wezel);
+	polityka_.store(p);
+}
+
+/**
+ * @brief Zwraca bieżącą zasadę rozmieszczania.
+ * @return Zasada rozmieszczania.
+ */
+numa::polityka numa::biezaca_polityka() {
+	return (polityka)polityka_.load();
+}
+
+/**
+ * @brief Stosuje bieżącą zasadę do obszaru pamięci.
+ *
+ * Brzegi obszaru są zaokrąglane do pełnych stron w głąb; niepełne strony na brzegach
+ * podlegają zasadzie pierwszego dotyku. Błędy wywołania systemowego są pomijane
+ * (rozmieszczenie jest tylko wskazówką).
+ *
+ * @param p Początek obszaru.
+ * @param bajty Długość obszaru.
+ */
+void numa::rozmiesc(void* p, size_t bajty) {
+	polityka pol = biezaca_polityka();
+	if (pol == pierwszy_dotyk || liczba_wezlow() < 2) {
+		return;
+	}
+#if defined(__linux__) && defined(SYS_mbind)
+	const int MPOL_BIND_ = 2;
+	const int MPOL_INTERLEAVE_ = 3;
+	size_t strona = (size_t)sysconf(_SC_PAGESIZE);
+	size_t poczatek = ((size_t)p + strona - 1) / strona * strona;
+	size_t koniec = ((size_t)p + bajty) / strona * strona;
+	if (koniec <= poczatek) {
+		return;
+	}
+	unsigned long maska = 0;
+	if (pol == przeplot) {
+		for (int w = 0; w < liczba_wezlow() && w < 64; w++) {
+			maska |= 1UL << w;
+		}
+	}
+	else {
+		maska = 1UL << wezel_.load();
+	}
+	syscall(SYS_mbind, (void*)poczatek, koniec - poczatek, pol == przeplot ? MPOL_INTERLEAVE_ : MPOL_BIND_,
+		&maska, sizeof(maska) * 8, 0);
+#else
+	(void)p;
+	(void)bajty;
+#endif
+}
+
+/**
+ * @brief Wyznacza węzeł dla wątku puli.
+ * @param watek Numer wątku.
+ * @param watki Liczba wątków.
+ * @return Numer węzła.
+ */
+int numa::wezel_watku(int watek, int watki) {
+	if (watki < 1) {
+		return 0;
+	}
+	return (int)((long long)watek * liczba_wezlow() / watki);
+}
+
+/**
+ * @brief Przypina bieżący wątek do procesorów węzła.
+ * @param wezel Numer węzła.
+ * @return True, jeśli przypięcie się powiodło.
+ */
+bool numa::przypnij_watek(int wezel) {
+	if (wezel < 0 || wezel >= liczba_wezlow()) {
+		return false;
+	}
+#if defined(_WIN32)
+	GROUP_AFFINITY powinowactwo = {};
+	if (!GetNumaNodeProcessorMaskEx((USHORT)wezel, &powinowactwo)) {
+		return false;
+	}
+	return SetThreadGroupAffinity(GetCurrentThread(), &powinowactwo, nullptr) != 0;
+#elif defined(__linux__)
+	vector<int> procesory;
+	if (!procesory_wezla(wezel, procesory) || procesory.empty()) {
+		return false;
+	}
+	cpu_set_t zbior;
+	CPU_ZERO(&zbior);
+	for (size_t i = 0; i < procesory.size(); i++) {
+		if (procesory[i] < CPU_SETSIZE) {
+			CPU_SET(procesory[i], &zbior);
+		}
+	}
+	return pthread_setaffinity_np(pthread_self(), sizeof(zbior), &zbior) == 0;
+#else
+	return false;
+#endif
+}
+
+/**
+ * @brief Przypina wątki globalnej puli do węzłów.
+ *
+ * Każdy wątek wykonuje dokładnie jeden element zakresu [0, liczba_watkow) i przypina
+ * sam siebie. Wątek wywołujący (numer 0) trafia na węzeł 0.
+ *
+ * @return Liczba przypiętych wątków.
+ */
+int numa::przypnij_pule() {
+	if (liczba_wezlow() < 2) {
+		return 0;
+	}
+	pula_watkow& pula = pula_watkow::globalna();
+	int t = pula.liczba_watkow();
+	atomic<int> przypiete(0);
+	pula.rownolegle(t, [&](int od, int do_, int) {
+		for (int w = od; w < do_; w++) {
+			if (przypnij_watek(wezel_watku(w, t))) {
+				przypiete++;
+			}
+		}
+	}, 1);
+	return przypiete.load();
+}
+
+/**
+ * @brief Mierzy przepustowość równoległego odczytu.
+ *
+ * Wiersze są dzielone równo między `watki` pierwszych wątków puli. Przy wszystkich
+ * wątkach podział pokrywa się z podziałem użytym przy inicjalizacji, więc przy pierwszym
+ * dotyku każdy wątek czyta strony ze swojego węzła; porównanie wyników dla rosnącej
+ * liczby wątków pokazuje skalowanie przepustowości między gniazdami.
+ *
+ * @param n Rozmiar macierzy.
+ * @param watki Liczba pracujących wątków (0 - wszystkie).
+ * @param powtorzenia Liczba przebiegów.
+ * @return Przepustowość w GB/s (najlepszy przebieg).
+ */
+double numa::przepustowosc(int n, int watki, int powtorzenia) {
+	pula_watkow& pula = pula_watkow::globalna();
+	int t = pula.liczba_watkow();
+	if (watki <= 0 || watki > t) {
+		watki = t;
+	}
+	matrix m;
+	m.alokuj(n);
+	if (n <= 0) {
+		return 0.0;
+	}
+	vector<long long> sumy(t, 0);
+	double najlepszy = 0.0;
+	for (int p = 0; p < powtorzenia; p++) {
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		pula.rownolegle(t, [&](int od, int do_, int) {
+			for (int w = od; w < do_ && w < watki; w++) {
+				long long wiersz_od = (long long)n * w / watki;
+				long long wiersz_do = (long long)n * (w + 1) / watki;
+				const int* e = m.buf->elementy;
+				long long s = 0;
+				for (size_t i = (size_t)wiersz_od * n; i < (size_t)wiersz_do * n; i++) {
+					s += e[i];
+				}
+				sumy[w] += s;
+			}
+		}, 1);
+		double sekundy = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		if (sekundy > 0) {
+			double gb = (double)n * n * sizeof(int) / 1e9 / sekundy;
+			if (gb > najlepszy) {
+				najlepszy = gb;
+			}
+		}
+	}
+	return najlepszy;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <cstddef>
+using namespace std;
+
+/**
+ * @class numa
+ * @brief Rozmieszczenie pamięci macierzy i wątków puli na węzłach NUMA.
+ *
+ * Domyślnie obowiązuje zasada pierwszego dotyku: bufory macierzy są inicjalizowane
+ * równolegle przez wątki puli z takim samym podziałem wierszy, jakiego używają
+ * operacje, więc strona trafia do węzła wątku, który będzie ją później przetwarzał.
+ * Można też wybrać przeplot stron między wszystkie węzły albo wiązanie z jednym węzłem.
+ * Na systemie z jednym węzłem (lub bez obsługi NUMA) wszystkie funkcje działają,
+ * ale nie zmieniają rozmieszczenia.
+ */
+class numa {
+public:
+    /**
+     * @brief Zasada rozmieszczania nowych buforów.
+     */
+    enum polityka {
+        pierwszy_dotyk, ///< Strona trafia do węzła wątku, który pierwszy jej dotknie
+        przeplot, ///< Strony rozkładane kolejno na wszystkie węzły
+        wiazanie ///< Wszystkie strony na wybranym węźle
+    };
+
+    /**
+     * @brief Zwraca liczbę węzłów NUMA (co najmniej 1).
+     * @return Liczba węzłów.
+     */
+    static int liczba_wezlow();
+
+    /**
+     * @brief Ustawia zasadę rozmieszczania dla kolejno alokowanych buforów.
+     * @param p Zasada rozmieszczania.
+     * @param wezel Węzeł dla zasady wiazanie.
+     * @throws std::invalid_argument Jeśli węzeł nie istnieje.
+     */
+    static void ustaw_polityke(polityka p, int wezel = 0);
+
+    /**
+     * @brief Zwraca bieżącą zasadę rozmieszczania.
+     * @return Zasada rozmieszczania.
+     */
+    static polityka biezaca_polityka();
+
+    /**
+     * @brief Stosuje bieżącą zasadę do świeżo zaalokowanego, niedotkniętego obszaru.
+     *
+     * Na Linuksie używa mbind dla pełnych stron obszaru. Na Windows istniejącego
+     * obszaru nie da się przenieść, więc o rozmieszczeniu decyduje pierwszy dotyk
+     * (przez wątki przypięte funkcją przypnij_pule).
+     *
+     * @param p Początek obszaru.
+     * @param bajty Długość obszaru.
+     */
+    static void rozmiesc(void* p, size_t bajty);
+
+    /**
+     * @brief Wyznacza węzeł dla wątku puli.
+     *
+     * Kolejne wątki (a więc i kolejne fragmenty wierszy) przypadają na kolejne węzły.
+     *
+     * @param watek Numer wątku.
+     * @param watki Liczba wątków.
+     * @return Numer węzła.
+     */
+    static int wezel_watku(int watek, int watki);
+
+    /**
+     * @brief Przypina bieżący wątek do procesorów danego węzła.
+     * @param wezel Numer węzła.
+     * @return True, jeśli przypięcie się powiodło.
+     */
+    static bool przypnij_watek(int wezel);
+
+    /**
+     * @brief Przypina wszystkie wątki globalnej puli (łącznie z wywołującym) do węzłów.
+     * @return Liczba przypiętych wątków (0 na systemie z jednym węzłem).
+     */
+    static int przypnij_pule();
+
+    /**
+     * @brief Mierzy przepustowość równoległego odczytu macierzy.
+     *
+     * Alokuje macierz n x n zgodnie z bieżącą zasadą i sumuje jej wiersze,
+     * używając pierwszych `watki` wątków puli (każdy czyta swój fragment wierszy).
+     *
+     * @param n Rozmiar macierzy.
+     * @param watki Liczba pracujących wątków (0 - wszystkie).
+     * @param powtorzenia Liczba przebiegów.
+     * @return Przepustowość w GB/s.
+     */
+    static double przepustowosc(int n, int watki = 0, int powtorzenia = 5);
+};
+
+#endif // !NUMA_H
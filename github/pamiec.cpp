@@ -0,0 +1,301 @@
+/**
+ * @file pamiec.cpp
+ * @brief Implementacja pamięci podręcznej wyników operacji na macierzach.
+ */
+
+#include "pamiec.h"
+#include "watki.h"
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Porównuje klucze.
+ * @param k Klucz do porównania.
+ * @return True, jeśli klucze są równe.
+ */
+bool pamiec_wynikow::klucz::operator==(const klucz& k) const {
+	return skrot_a == k.skrot_a && skrot_b == k.skrot_b && n == k.n && parametr == k.parametr && operacja == k.operacja;
+}
+
+/**
+ * @brief Łączy pola klucza w jedną wartość skrótu.
+ * @param k Klucz.
+ * @return Skrót klucza.
+ */
+size_t pamiec_wynikow::skrot_klucza::operator()(const klucz& k) const {
+	unsigned long long h = k.skrot_a;
+	h = h * 0x9E3779B97F4A7C15ULL ^ k.skrot_b;
+	h = h * 0x9E3779B97F4A7C15ULL ^ (unsigned long long)k.parametr;
+	h = h * 0x9E3779B97F4A7C15ULL ^ (unsigned long long)k.n;
+	return (size_t)(h ^ hash<string>()(k.operacja));
+}
+
+/**
+ * @brief Konstruktor.
+ * @param budzet Maksymalna liczba bajtów zajmowanych przez zapamiętane wyniki.
+ */
+pamiec_wynikow::pamiec_wynikow(size_t budzet) {
+	s.trafienia = 0;
+	s.chybienia = 0;
+	s.usuniete = 0;
+	s.wpisy = 0;
+	s.bajty = 0;
+	s.budzet = budzet;
+}
+
+/**
+ * @brief Sprawdza, czy argument ma tę samą zawartość co kopia we wpisie.
+ *
+ * Wspólny bufor oznacza równość bez porównywania elementów.
+ *
+ * @param x Argument zapytania.
+ * @param y Kopia argumentu we wpisie.
+ * @return True, jeśli macierze są równe.
+ */
+bool pamiec_wynikow::takie_same(const matrix& x, const matrix& y) {
+	return x.buf == y.buf || x == y;
+}
+
+/**
+ * @brief Szacuje pamięć zajmowaną przez macierz (elementy i tablica wierszy).
+ * @param m Macierz.
+ * @return Liczba bajtów.
+ */
+size_t pamiec_wynikow::rozmiar_macierzy(const matrix& m) {
+	return (size_t)m.n * m.n * sizeof(int) + (size_t)m.n * sizeof(int*) + sizeof(matrix);
+}
+
+/**
+ * @brief Szacuje pamięć zajmowaną przez wpis.
+ *
+ * Kopie argumentów są liczone w całości, bo po zmianie argumentu tylko wpis
+ * utrzymuje ich poprzedni bufor.
+ *
+ * @param w Wpis.
+ * @return Liczba bajtów.
+ */
+size_t pamiec_wynikow::rozmiar_wpisu(const wpis& w) {
+	return rozmiar_macierzy(w.wynik) + rozmiar_macierzy(w.a) + rozmiar_macierzy(w.b);
+}
+
+/**
+ * @brief Usuwa najdawniej używane wpisy, aż zużycie zmieści się w budżecie.
+ *
+ * Wywoływana z założoną blokadą `mtx`.
+ */
+void pamiec_wynikow::przytnij() {
+	while (s.bajty > s.budzet && !lru.empty()) {
+		s.bajty -= rozmiar_wpisu(lru.back());
+		indeks.erase(lru.back().k);
+		lru.pop_back();
+		s.usuniete++;
+	}
+	s.wpisy = lru.size();
+}
+
+/**
+ * @brief Zwraca wynik operacji z pamięci lub oblicza go i zapamiętuje.
+ *
+ * Skróty argumentów są liczone poza blokadą (przy niezmienionej macierzy są już
+ * zapamiętane w jej buforze). Trafienie wymaga też równości argumentów z kopiami
+ * zapamiętanymi we wpisie; wpis z tym samym kluczem, ale innymi argumentami (kolizja
+ * skrótów), jest traktowany jak chybienie i zastępowany nowym wynikiem. Obliczenie
+ * przy chybieniu odbywa się poza blokadą. Wynik większy niż cały budżet nie jest
+ * zapamiętywany.
+ *
+ * @param operacja Nazwa operacji (część klucza).
+ * @param a Pierwszy argument.
+ * @param b Drugi argument lub nullptr.
+ * @param parametr Parametr skalarny operacji.
+ * @param oblicz Funkcja obliczająca wynik przy chybieniu.
+ * @return Wynik operacji.
+ */
+matrix pamiec_wynikow::pobierz(const string& operacja, const matrix& a, const matrix* b, long long parametr, const function<matrix()>& oblicz) {
+	klucz k;
+	k.operacja = operacja;
+	k.skrot_a = a.skrot();
+	k.skrot_b = b ? b->skrot() : 0;
+	k.n = a.n;
+	k.parametr = parametr;
+
+	{
+		lock_guard<mutex> blokada(mtx);
+		unordered_map<klucz, lista::iterator, skrot_klucza>::iterator it = indeks.find(k);
+		if (it != indeks.end() && takie_same(a, it->second->a) && (!b || takie_same(*b, it->second->b))) {
+			lru.splice(lru.begin(), lru, it->second);
+			s.trafienia++;
+			return it->second->wynik;
+		}
+		s.chybienia++;
+	}
+
+	wpis w;
+	w.k = k;
+	w.a = a;
+	if (b) {
+		w.b = *b;
+	}
+	w.wynik = oblicz();
+	size_t bajty = rozmiar_wpisu(w);
+
+	lock_guard<mutex> blokada(mtx);
+	if (bajty <= s.budzet) {
+		unordered_map<klucz, lista::iterator, skrot_klucza>::iterator it = indeks.find(k);
+		if (it != indeks.end()) {
+			s.bajty -= rozmiar_wpisu(*it->second);
+			lru.erase(it->second);
+			indeks.erase(it);
+		}
+		lru.push_front(w);
+		indeks[k] = lru.begin();
+		s.bajty += bajty;
+		przytnij();
+	}
+	return w.wynik;
+}
+
+/**
+ * @brief Tworzy nową macierz, której element (i, j) jest równy f(a[i][j], i, j).
+ *
+ * Wiersze są dzielone między wątki puli.
+ *
+ * @param a Macierz wejściowa.
+ * @param f Funkcja elementu.
+ * @return Nowa macierz.
+ */
+template <class F>
+matrix pamiec_wynikow::elementami(const matrix& a, F f) {
+	matrix wynik(a.n);
+	pula_watkow::globalna().rownolegle(a.n, [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			for (int j = 0; j < a.n; j++) {
+				wynik.data[i][j] = f(a.data[i][j], i, j);
+			}
+		}
+	});
+	return wynik;
+}
+
+/**
+ * @brief Suma dwóch macierzy z pamięci podręcznej.
+ * @param a Pierwszy składnik.
+ * @param b Drugi składnik.
+ * @return Suma macierzy.
+ * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+ */
+matrix pamiec_wynikow::suma(const matrix& a, const matrix& b) {
+	if (a.n != b.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	const matrix* pb = &b;
+	return pobierz("+", a, &b, 0, [&a, pb] {
+		return elementami(a, [pb](int x, int i, int j) { return x + pb->data[i][j]; });
+	});
+}
+
+/**
+ * @brief Iloczyn element po elemencie z pamięci podręcznej.
+ * @param a Pierwszy czynnik.
+ * @param b Drugi czynnik.
+ * @return Iloczyn macierzy.
+ * @throws std::invalid_argument Jeśli macierze mają różne rozmiary.
+ */
+matrix pamiec_wynikow::iloczyn_elementow(const matrix& a, const matrix& b) {
+	if (a.n != b.n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	const matrix* pb = &b;
+	return pobierz("*", a, &b, 0, [&a, pb] {
+		return elementami(a, [pb](int x, int i, int j) { return x * pb->data[i][j]; });
+	});
+}
+
+/**
+ * @brief Iloczyn algebraiczny z pamięci podręcznej.
+ * @param a Lewy czynnik.
+ * @param b Prawy czynnik.
+ * @return Iloczyn macierzy.
+ */
+matrix pamiec_wynikow::iloczyn(const matrix& a, const matrix& b) {
+	return pobierz("iloczyn", a, &b, 0, [&a, &b] { return a.iloczyn(b); });
+}
+
+/**
+ * @brief Transpozycja z pamięci podręcznej.
+ * @param a Macierz wejściowa.
+ * @return Macierz transponowana.
+ */
+matrix pamiec_wynikow::transpozycja(const matrix& a) {
+	return pobierz("odwroc", a, nullptr, 0, [&a] {
+		matrix wynik(a);
+		wynik.odwroc();
+		return wynik;
+	});
+}
+
+/**
+ * @brief Dodanie skalara z pamięci podręcznej.
+ * @param a Macierz wejściowa.
+ * @param s Skalar.
+ * @return Wynikowa macierz.
+ */
+matrix pamiec_wynikow::dodaj(const matrix& a, int s) {
+	return pobierz("+s", a, nullptr, s, [&a, s] {
+		return elementami(a, [s](int x, int, int) { return x + s; });
+	});
+}
+
+/**
+ * @brief Odjęcie skalara z pamięci podręcznej.
+ * @param a Macierz wejściowa.
+ * @param s Skalar.
+ * @return Wynikowa macierz.
+ */
+matrix pamiec_wynikow::odejmij(const matrix& a, int s) {
+	return pobierz("-s", a, nullptr, s, [&a, s] {
+		return elementami(a, [s](int x, int, int) { return x - s; });
+	});
+}
+
+/**
+ * @brief Mnożenie przez skalar z pamięci podręcznej.
+ * @param a Macierz wejściowa.
+ * @param s Skalar.
+ * @return Wynikowa macierz.
+ */
+matrix pamiec_wynikow::mnoz(const matrix& a, int s) {
+	return pobierz("*s", a, nullptr, s, [&a, s] {
+		return elementami(a, [s](int x, int, int) { return x * s; });
+	});
+}
+
+/**
+ * @brief Zwraca statystyki pamięci podręcznej.
+ * @return Kopia statystyk.
+ */
+pamiec_wynikow::statystyki pamiec_wynikow::stat() const {
+	lock_guard<mutex> blokada(mtx);
+	return s;
+}
+
+/**
+ * @brief Zmienia budżet pamięci.
+ * @param bajty Nowy budżet w bajtach.
+ */
+void pamiec_wynikow::ustaw_budzet(size_t bajty) {
+	lock_guard<mutex> blokada(mtx);
+	s.budzet = bajty;
+	przytnij();
+}
+
+/**
+ * @brief Usuwa wszystkie wpisy.
+ */
+void pamiec_wynikow::wyczysc() {
+	lock_guard<mutex> blokada(mtx);
+	indeks.clear();
+	lru.clear();
+	s.bajty = 0;
+	s.wpisy = 0;
+}
@@ -0,0 +1,179 @@
+#pragma once
+#ifndef PAMIEC_H
+#define PAMIEC_H
+
+#include "matrix.h"
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+using namespace std;
+
+/**
+ * @class pamiec_wynikow
+ * @brief Pamięć podręczna wyników operacji na macierzach, adresowana zawartością argumentów.
+ *
+ * Kluczem wpisu jest nazwa operacji, skróty zawartości argumentów (matrix::skrot),
+ * ich rozmiar oraz parametr skalarny. Modyfikacja argumentu (wstaw, wiersz, operatory
+ * złożone itd.) unieważnia jego skrót, więc kolejne zapytanie trafia pod nowy klucz,
+ * a nieaktualne wpisy są stopniowo usuwane zgodnie z zasadą LRU. Zwracane macierze
+ * współdzielą bufor z wpisem, więc trafienie nie kopiuje elementów.
+ *
+ * Wpis przechowuje też kopie argumentów (współdzielące bufor, dopóki argument się nie
+ * zmieni). Przy trafieniu argumenty są porównywane z kopiami, więc kolizja skrótów
+ * nie zwróci wyniku innej operacji; porównanie jest pomijane, gdy argument nadal
+ * współdzieli bufor z kopią.
+ */
+class pamiec_wynikow {
+public:
+    /**
+     * @brief Statystyki pamięci podręcznej.
+     */
+    struct statystyki {
+        unsigned long long trafienia; ///< Liczba zapytań obsłużonych z pamięci
+        unsigned long long chybienia; ///< Liczba zapytań wymagających obliczeń
+        unsigned long long usuniete; ///< Liczba wpisów usuniętych z braku miejsca
+        size_t wpisy; ///< Bieżąca liczba wpisów
+        size_t bajty; ///< Bieżące zużycie pamięci przez wpisy
+        size_t budzet; ///< Maksymalne zużycie pamięci
+    };
+
+    /**
+     * @brief Konstruktor.
+     * @param budzet Maksymalna liczba bajtów zajmowanych przez zapamiętane wyniki.
+     */
+    explicit pamiec_wynikow(size_t budzet);
+
+    /**
+     * @brief Zwraca wynik dowolnej operacji, obliczając go tylko przy pierwszym zapytaniu.
+     * @param operacja Nazwa operacji (część klucza).
+     * @param a Pierwszy argument.
+     * @param b Drugi argument lub nullptr.
+     * @param parametr Parametr skalarny operacji.
+     * @param oblicz Funkcja obliczająca wynik przy chybieniu.
+     * @return Wynik operacji.
+     */
+    matrix pobierz(const string& operacja, const matrix& a, const matrix* b, long long parametr, const function<matrix()>& oblicz);
+
+    /**
+     * @brief Suma dwóch macierzy (operator+).
+     * @param a Pierwszy składnik.
+     * @param b Drugi składnik.
+     * @return Suma macierzy.
+     */
+    matrix suma(const matrix& a, const matrix& b);
+
+    /**
+     * @brief Iloczyn element po elemencie (operator*).
+     * @param a Pierwszy czynnik.
+     * @param b Drugi czynnik.
+     * @return Iloczyn macierzy.
+     */
+    matrix iloczyn_elementow(const matrix& a, const matrix& b);
+
+    /**
+     * @brief Iloczyn macierzy w sensie algebraicznym (iloczyn).
+     * @param a Lewy czynnik.
+     * @param b Prawy czynnik.
+     * @return Iloczyn macierzy.
+     */
+    matrix iloczyn(const matrix& a, const matrix& b);
+
+    /**
+     * @brief Macierz transponowana (odwroc).
+     * @param a Macierz wejściowa.
+     * @return Macierz transponowana.
+     */
+    matrix transpozycja(const matrix& a);
+
+    /**
+     * @brief Dodanie skalara do każdego elementu (operator+).
+     * @param a Macierz wejściowa.
+     * @param s Skalar.
+     * @return Wynikowa macierz.
+     */
+    matrix dodaj(const matrix& a, int s);
+
+    /**
+     * @brief Odjęcie skalara od każdego elementu (operator-).
+     * @param a Macierz wejściowa.
+     * @param s Skalar.
+     * @return Wynikowa macierz.
+     */
+    matrix odejmij(const matrix& a, int s);
+
+    /**
+     * @brief Pomnożenie każdego elementu przez skalar (operator*).
+     * @param a Macierz wejściowa.
+     * @param s Skalar.
+     * @return Wynikowa macierz.
+     */
+    matrix mnoz(const matrix& a, int s);
+
+    /**
+     * @brief Zwraca statystyki pamięci podręcznej.
+     * @return Kopia statystyk.
+     */
+    statystyki stat() const;
+
+    /**
+     * @brief Zmienia budżet pamięci, usuwając w razie potrzeby najdawniej używane wpisy.
+     * @param bajty Nowy budżet w bajtach.
+     */
+    void ustaw_budzet(size_t bajty);
+
+    /**
+     * @brief Usuwa wszystkie wpisy (statystyki trafień pozostają).
+     */
+    void wyczysc();
+
+private:
+    /**
+     * @brief Klucz wpisu.
+     */
+    struct klucz {
+        string operacja; ///< Nazwa operacji
+        unsigned long long skrot_a; ///< Skrót pierwszego argumentu
+        unsigned long long skrot_b; ///< Skrót drugiego argumentu (0 - brak)
+        int n; ///< Rozmiar pierwszego argumentu
+        long long parametr; ///< Parametr skalarny
+
+        bool operator==(const klucz& k) const;
+    };
+
+    /**
+     * @brief Funkcja skrótu klucza dla unordered_map.
+     */
+    struct skrot_klucza {
+        size_t operator()(const klucz& k) const;
+    };
+
+    /**
+     * @brief Zapamiętany wynik wraz z argumentami.
+     */
+    struct wpis {
+        klucz k; ///< Klucz
+        matrix a; ///< Kopia pierwszego argumentu
+        matrix b; ///< Kopia drugiego argumentu (pusta - brak)
+        matrix wynik; ///< Wynik operacji
+    };
+
+    typedef list<wpis> lista; ///< Wpisy od najświeższego do najstarszego
+
+    template <class F>
+    static matrix elementami(const matrix& a, F f);
+
+    static bool takie_same(const matrix& x, const matrix& y);
+    static size_t rozmiar_macierzy(const matrix& m);
+    static size_t rozmiar_wpisu(const wpis& w);
+    void przytnij();
+
+    lista lru; ///< Wpisy w kolejności użycia
+    unordered_map<klucz, lista::iterator, skrot_klucza> indeks; ///< Klucz -> wpis
+    statystyki s; ///< Statystyki
+    mutable mutex mtx; ///< Chroni wszystkie pola
+};
+
+#endif // !PAMIEC_H
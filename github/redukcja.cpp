@@ -0,0 +1,471 @@
+/**
+ * @file redukcja.cpp
+ * @brief Implementacja redukcji macierzy z 64-bitowymi akumulatorami.
+ */
+
+#include "redukcja.h"
+#include "sledzenie.h"
+#include "strojenie.h"
+#include "watki.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Wynik częściowy jednego wiersza dla redukcja::wszystkie.
+ */
+struct czesc_wiersza {
+	long long suma; ///< Suma elementów
+	unsigned long long l1; ///< Suma modułów
+	double l2; ///< Suma kwadratów
+	unsigned int maks_modul; ///< Największy moduł
+	int minimum; ///< Najmniejszy element
+	int kolumna_minimum; ///< Pierwsza kolumna z minimum
+	int maksimum; ///< Największy element
+	int kolumna_maksimum; ///< Pierwsza kolumna z maksimum
+};
+
+/**
+ * @brief Liczba bajtów macierzy n x n (do śledzenia).
+ * @param n Rozmiar.
+ * @return Liczba bajtów.
+ */
+static long long bajty(int n) {
+	return (long long)n * n * (long long)sizeof(int);
+}
+
+/**
+ * @brief Oblicza wynik częściowy każdego wiersza w wątkach puli.
+ *
+ * Każdy wiersz ma własne miejsce na wynik, więc łączenie wyników kolejno wierszami
+ * daje ten sam wynik niezależnie od podziału między wątki.
+ *
+ * @param n Liczba wierszy.
+ * @param wyniki Wektor wyników (zmieniany na n elementów).
+ * @param f Funkcja f(i) zwracająca wynik wiersza i.
+ */
+template <class T, class F>
+static void dla_wierszy(int n, vector<T>& wyniki, F f) {
+	wyniki.resize(n);
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			wyniki[i] = f(i);
+		}
+	}, strojenie::biezace().prog);
+}
+
+/**
+ * @brief Suma wiersza z czterema niezależnymi akumulatorami.
+ * @param w Wiersz.
+ * @param n Długość wiersza.
+ * @return Suma (64 bity).
+ */
+static long long suma_wiersza(const int* w, int n) {
+	long long s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	int j = 0;
+	for (; j + 4 <= n; j += 4) {
+		s0 += w[j];
+		s1 += w[j + 1];
+		s2 += w[j + 2];
+		s3 += w[j + 3];
+	}
+	for (; j < n; j++) {
+		s0 += w[j];
+	}
+	return s0 + s1 + s2 + s3;
+}
+
+/**
+ * @brief Wartość skrajna wiersza i pierwsza kolumna, w której występuje.
+ *
+ * Najpierw cztery akumulatory wyznaczają samą wartość (pętla bez rozgałęzień),
+ * a potem wiersz, już w pamięci podręcznej, jest przeszukiwany do pierwszego wystąpienia.
+ *
+ * @param w Wiersz.
+ * @param n Długość wiersza (n > 0).
+ * @param lepszy Porównanie lepszy(a, b): czy a jest bardziej skrajne niż b.
+ * @return Wartość i kolumna (wiersz nieustawiony).
+ */
+template <class L>
+static pozycja_wartosci skrajny_w_wierszu(const int* w, int n, L lepszy) {
+	int a0 = w[0], a1 = w[0], a2 = w[0], a3 = w[0];
+	int j = 0;
+	for (; j + 4 <= n; j += 4) {
+		a0 = lepszy(w[j], a0) ? w[j] : a0;
+		a1 = lepszy(w[j + 1], a1) ? w[j + 1] : a1;
+		a2 = lepszy(w[j + 2], a2) ? w[j + 2] : a2;
+		a3 = lepszy(w[j + 3], a3) ? w[j + 3] : a3;
+	}
+	for (; j < n; j++) {
+		a0 = lepszy(w[j], a0) ? w[j] : a0;
+	}
+	a0 = lepszy(a1, a0) ? a1 : a0;
+	a2 = lepszy(a3, a2) ? a3 : a2;
+	a0 = lepszy(a2, a0) ? a2 : a0;
+	int k = 0;
+	while (w[k] != a0) {
+		k++;
+	}
+	return pozycja_wartosci{ a0, 0, k };
+}
+
+/**
+ * @brief Wartość skrajna macierzy i jej pierwsze położenie wierszami.
+ * @param data Wiersze macierzy.
+ * @param n Rozmiar (n > 0).
+ * @param lepszy Porównanie ostre lepszy(a, b).
+ * @return Wartość i położenie.
+ */
+template <class L>
+static pozycja_wartosci skrajny(int** data, int n, L lepszy) {
+	vector<pozycja_wartosci> wiersze;
+	dla_wierszy(n, wiersze, [&](int i) { return skrajny_w_wierszu(data[i], n, lepszy); });
+	pozycja_wartosci wynik = wiersze[0];
+	for (int i = 1; i < n; i++) {
+		if (lepszy(wiersze[i].wartosc, wynik.wartosc)) {
+			wynik = wiersze[i];
+			wynik.wiersz = i;
+		}
+	}
+	return wynik;
+}
+
+/**
+ * @brief Sprawdza, czy macierz nie jest pusta.
+ * @param n Rozmiar macierzy.
+ * @throws std::invalid_argument Jeśli n <= 0.
+ */
+static void sprawdz_niepusta(int n) {
+	if (n <= 0) {
+		throw invalid_argument("Empty matrix");
+	}
+}
+
+/**
+ * @brief Moduł liczby jako liczba bez znaku (poprawny także dla INT_MIN).
+ * @param a Liczba.
+ * @return |a|.
+ */
+static unsigned int modul(int a) {
+	return a < 0 ? 0u - (unsigned int)a : (unsigned int)a;
+}
+
+/**
+ * @brief Liczy elementy wiersza spełniające porównanie.
+ * @param w Wiersz.
+ * @param n Długość wiersza.
+ * @param c Porównanie c(a) zwracające bool.
+ * @return Liczba elementów.
+ */
+template <class C>
+static long long policz_w_wierszu(const int* w, int n, C c) {
+	int s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	int j = 0;
+	for (; j + 4 <= n; j += 4) {
+		s0 += c(w[j]);
+		s1 += c(w[j + 1]);
+		s2 += c(w[j + 2]);
+		s3 += c(w[j + 3]);
+	}
+	for (; j < n; j++) {
+		s0 += c(w[j]);
+	}
+	return (long long)s0 + s1 + s2 + s3;
+}
+
+/**
+ * @brief Liczy elementy macierzy spełniające porównanie.
+ * @param data Wiersze macierzy.
+ * @param n Rozmiar.
+ * @param c Porównanie c(a).
+ * @return Liczba elementów.
+ */
+template <class C>
+static long long policz_w_macierzy(int** data, int n, C c) {
+	vector<long long> wiersze;
+	dla_wierszy(n, wiersze, [&](int i) { return policz_w_wierszu(data[i], n, c); });
+	long long wynik = 0;
+	for (int i = 0; i < n; i++) {
+		wynik += wiersze[i];
+	}
+	return wynik;
+}
+
+/**
+ * @brief Oblicza sumę wszystkich elementów.
+ * @param m Macierz.
+ * @return Suma.
+ */
+long long redukcja::suma(const matrix& m) {
+	sledzenie::zakres sledz("redukcja::suma", m.n, bajty(m.n));
+	vector<long long> wiersze;
+	dla_wierszy(m.n, wiersze, [&](int i) { return suma_wiersza(m.data[i], m.n); });
+	long long wynik = 0;
+	for (int i = 0; i < m.n; i++) {
+		wynik += wiersze[i];
+	}
+	return wynik;
+}
+
+/**
+ * @brief Wyznacza najmniejszy element i jego położenie.
+ * @param m Macierz.
+ * @return Wartość i położenie.
+ * @throws std::invalid_argument Jeśli macierz jest pusta.
+ */
+pozycja_wartosci redukcja::minimum(const matrix& m) {
+	sledzenie::zakres sledz("redukcja::minimum", m.n, bajty(m.n));
+	sprawdz_niepusta(m.n);
+	return skrajny(m.data, m.n, [](int a, int b) { return a < b; });
+}
+
+/**
+ * @brief Wyznacza największy element i jego położenie.
+ * @param m Macierz.
+ * @return Wartość i położenie.
+ * @throws std::invalid_argument Jeśli macierz jest pusta.
+ */
+pozycja_wartosci redukcja::maksimum(const matrix& m) {
+	sledzenie::zakres sledz("redukcja::maksimum", m.n, bajty(m.n));
+	sprawdz_niepusta(m.n);
+	return skrajny(m.data, m.n, [](int a, int b) { return a > b; });
+}
+
+/**
+ * @brief Oblicza ślad macierzy.
+ * @param m Macierz.
+ * @return Ślad.
+ */
+long long redukcja::slad(const matrix& m) {
+	sledzenie::zakres sledz("redukcja::slad", m.n, (long long)m.n * (long long)sizeof(int));
+	long long wynik = 0;
+	for (int i = 0; i < m.n; i++) {
+		wynik += m.data[i][i];
+	}
+	return wynik;
+}
+
+/**
+ * @brief Oblicza sumy wierszy.
+ * @param m Macierz.
+ * @return Wektor sum.
+ */
+vector<long long> redukcja::sumy_wierszy(const matrix& m) {
+	sledzenie::zakres sledz("redukcja::sumy_wierszy", m.n, bajty(m.n));
+	vector<long long> wynik;
+	dla_wierszy(m.n, wynik, [&](int i) { return suma_wiersza(m.data[i], m.n); });
+	return wynik;
+}
+
+/**
+ * @brief Oblicza sumy kolumn.
+ *
+ * Wątki dzielą między siebie kolumny i przechodzą macierz wierszami, dodając
+ * swój fragment wiersza do 64-bitowych sum (pętla wektoryzowana wzdłuż wiersza).
+ *
+ * @param m Macierz.
+ * @return Wektor sum.
+ */
+vector<long long> redukcja::sumy_kolumn(const matrix& m) {
+	sledzenie::zakres sledz("redukcja::sumy_kolumn", m.n, bajty(m.n));
+	int n = m.n;
+	vector<long long> wynik(n, 0);
+	long long* s = wynik.data();
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+		for (int i = 0; i < n; i++) {
+			const int* w = m.data[i];
+			for (int j = od; j < do_; j++) {
+				s[j] += w[j];
+			}
+		}
+	}, strojenie::biezace().prog);
+	return wynik;
+}
+
+/**
+ * @brief Oblicza normę L1.
+ * @param m Macierz.
+ * @return Suma modułów.
+ */
+unsigned long long redukcja::norma_l1(const matrix& m) {
+	sledzenie::zakres sledz("redukcja::norma_l1", m.n, bajty(m.n));
+	vector<unsigned long long> wiersze;
+	dla_wierszy(m.n, wiersze, [&](int i) {
+		const int* w = m.data[i];
+		unsigned long long s0 = 0, s1 = 0;
+		int j = 0;
+		for (; j + 2 <= m.n; j += 2) {
+			s0 += modul(w[j]);
+			s1 += modul(w[j + 1]);
+		}
+		for (; j < m.n; j++) {
+			s0 += modul(w[j]);
+		}
+		return s0 + s1;
+	});
+	unsigned long long wynik = 0;
+	for (int i = 0; i < m.n; i++) {
+		wynik += wiersze[i];
+	}
+	return wynik;
+}
+
+/**
+ * @brief Oblicza normę L2 (Frobeniusa).
+ *
+ * Kwadraty są liczone dokładnie na 64 bitach i sumowane w typie double
+ * w ustalonej kolejności.
+ *
+ * @param m Macierz.
+ * @return Pierwiastek sumy kwadratów.
+ */
+double redukcja::norma_l2(const matrix& m) {
+	sledzenie::zakres sledz("redukcja::norma_l2", m.n, bajty(m.n));
+	vector<double> wiersze;
+	dla_wierszy(m.n, wiersze, [&](int i) {
+		const int* w = m.data[i];
+		double s0 = 0, s1 = 0;
+		int j = 0;
+		for (; j + 2 <= m.n; j += 2) {
+			s0 += (double)((long long)w[j] * w[j]);
+			s1 += (double)((long long)w[j + 1] * w[j + 1]);
+		}
+		for (; j < m.n; j++) {
+			s0 += (double)((long long)w[j] * w[j]);
+		}
+		return s0 + s1;
+	});
+	double wynik = 0;
+	for (int i = 0; i < m.n; i++) {
+		wynik += wiersze[i];
+	}
+	return sqrt(wynik);
+}
+
+/**
+ * @brief Oblicza normę maksimum.
+ * @param m Macierz.
+ * @return Największy moduł (0 dla macierzy pustej).
+ */
+unsigned int redukcja::norma_max(const matrix& m) {
+	sledzenie::zakres sledz("redukcja::norma_max", m.n, bajty(m.n));
+	vector<unsigned int> wiersze;
+	dla_wierszy(m.n, wiersze, [&](int i) {
+		const int* w = m.data[i];
+		unsigned int a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+		int j = 0;
+		for (; j + 4 <= m.n; j += 4) {
+			a0 = max(a0, modul(w[j]));
+			a1 = max(a1, modul(w[j + 1]));
+			a2 = max(a2, modul(w[j + 2]));
+			a3 = max(a3, modul(w[j + 3]));
+		}
+		for (; j < m.n; j++) {
+			a0 = max(a0, modul(w[j]));
+		}
+		return max(max(a0, a1), max(a2, a3));
+	});
+	unsigned int wynik = 0;
+	for (int i = 0; i < m.n; i++) {
+		wynik = max(wynik, wiersze[i]);
+	}
+	return wynik;
+}
+
+/**
+ * @brief Liczy elementy spełniające porównanie z wartością.
+ * @param m Macierz.
+ * @param w Rodzaj porównania.
+ * @param wartosc Wartość porównywana.
+ * @return Liczba elementów.
+ */
+long long redukcja::policz(const matrix& m, warunek w, int wartosc) {
+	sledzenie::zakres sledz("redukcja::policz", m.n, bajty(m.n));
+	switch (w) {
+	case rowne:
+		return policz_w_macierzy(m.data, m.n, [wartosc](int a) { return (int)(a == wartosc); });
+	case rozne:
+		return policz_w_macierzy(m.data, m.n, [wartosc](int a) { return (int)(a != wartosc); });
+	case mniejsze:
+		return policz_w_macierzy(m.data, m.n, [wartosc](int a) { return (int)(a < wartosc); });
+	case mniejsze_rowne:
+		return policz_w_macierzy(m.data, m.n, [wartosc](int a) { return (int)(a <= wartosc); });
+	case wieksze:
+		return policz_w_macierzy(m.data, m.n, [wartosc](int a) { return (int)(a > wartosc); });
+	case wieksze_rowne:
+		return policz_w_macierzy(m.data, m.n, [wartosc](int a) { return (int)(a >= wartosc); });
+	}
+	throw invalid_argument("Unknown condition");
+}
+
+/**
+ * @brief Liczy elementy spełniające predykat.
+ * @param m Macierz.
+ * @param p Predykat.
+ * @return Liczba elementów.
+ */
+long long redukcja::policz(const matrix& m, const function<bool(int)>& p) {
+	sledzenie::zakres sledz("redukcja::policz", m.n, bajty(m.n));
+	return policz_w_macierzy(m.data, m.n, [&p](int a) { return (int)p(a); });
+}
+
+/**
+ * @brief Liczy wszystkie redukcje w jednym przebiegu.
+ *
+ * Każdy wiersz jest czytany z pamięci raz: jedna pętla aktualizuje jednocześnie sumę,
+ * sumę modułów, sumę kwadratów, największy moduł oraz minimum i maksimum (niezależne
+ * łańcuchy zależności), a położenia skrajnych wartości są szukane w wierszu będącym już
+ * w pamięci podręcznej.
+ *
+ * @param m Macierz.
+ * @return Wyniki.
+ * @throws std::invalid_argument Jeśli macierz jest pusta.
+ */
+statystyki redukcja::wszystkie(const matrix& m) {
+	sledzenie::zakres sledz("redukcja::wszystkie", m.n, bajty(m.n));
+	sprawdz_niepusta(m.n);
+	int n = m.n;
+	vector<czesc_wiersza> wiersze;
+	dla_wierszy(n, wiersze, [&](int i) {
+		const int* w = m.data[i];
+		czesc_wiersza c{ 0, 0, 0.0, 0, w[0], 0, w[0], 0 };
+		for (int j = 0; j < n; j++) {
+			int a = w[j];
+			unsigned int b = modul(a);
+			c.suma += a;
+			c.l1 += b;
+			c.l2 += (double)((long long)a * a);
+			c.maks_modul = max(c.maks_modul, b);
+			c.minimum = min(c.minimum, a);
+			c.maksimum = max(c.maksimum, a);
+		}
+		while (w[c.kolumna_minimum] != c.minimum) {
+			c.kolumna_minimum++;
+		}
+		while (w[c.kolumna_maksimum] != c.maksimum) {
+			c.kolumna_maksimum++;
+		}
+		return c;
+	});
+
+	statystyki s{ 0, 0, { wiersze[0].minimum, 0, wiersze[0].kolumna_minimum },
+		{ wiersze[0].maksimum, 0, wiersze[0].kolumna_maksimum }, 0, 0.0, 0 };
+	for (int i = 0; i < n; i++) {
+		const czesc_wiersza& c = wiersze[i];
+		s.suma += c.suma;
+		s.slad += m.data[i][i];
+		s.norma_l1 += c.l1;
+		s.norma_l2 += c.l2;
+		s.norma_max = max(s.norma_max, c.maks_modul);
+		if (c.minimum < s.minimum.wartosc) {
+			s.minimum = pozycja_wartosci{ c.minimum, i, c.kolumna_minimum };
+		}
+		if (c.maksimum > s.maksimum.wartosc) {
+			s.maksimum = pozycja_wartosci{ c.maksimum, i, c.kolumna_maksimum };
+		}
+	}
+	s.norma_l2 = sqrt(s.norma_l2);
+	return s;
+}
@@ -0,0 +1,153 @@
+#pragma once
+#ifndef REDUKCJA_H
+#define REDUKCJA_H
+
+#include "matrix.h"
+#include <functional>
+#include <vector>
+using namespace std;
+
+/**
+ * @struct pozycja_wartosci
+ * @brief Wartość skrajna wraz z jej położeniem w macierzy.
+ */
+struct pozycja_wartosci {
+    int wartosc; ///< Wartość elementu
+    int wiersz; ///< Indeks wiersza
+    int kolumna; ///< Indeks kolumny
+};
+
+/**
+ * @struct statystyki
+ * @brief Wyniki wszystkich redukcji macierzy liczone w jednym przebiegu.
+ */
+struct statystyki {
+    long long suma; ///< Suma elementów
+    long long slad; ///< Suma elementów głównej przekątnej
+    pozycja_wartosci minimum; ///< Najmniejszy element (pierwszy wierszami)
+    pozycja_wartosci maksimum; ///< Największy element (pierwszy wierszami)
+    unsigned long long norma_l1; ///< Suma modułów
+    double norma_l2; ///< Pierwiastek sumy kwadratów (norma Frobeniusa)
+    unsigned int norma_max; ///< Największy moduł
+};
+
+/**
+ * @class redukcja
+ * @brief Redukcje macierzy: sumy, skrajne wartości z położeniem, ślad, normy i zliczanie.
+ *
+ * Sumy są akumulowane na 64 bitach (bez przepełnienia dla macierzy do 2^32 elementów),
+ * a pętle wierszy używają kilku niezależnych akumulatorów, co pozwala kompilatorowi
+ * na wektoryzację. Wiersze są dzielone między wątki puli; każdy wiersz daje wynik
+ * częściowy, a wyniki są łączone kolejno wierszami, więc wynik (również
+ * zmiennoprzecinkowy) nie zależy od liczby wątków.
+ */
+class redukcja {
+public:
+    /**
+     * @brief Warunek zliczania elementów.
+     */
+    enum warunek {
+        rowne, ///< a == wartosc
+        rozne, ///< a != wartosc
+        mniejsze, ///< a < wartosc
+        mniejsze_rowne, ///< a <= wartosc
+        wieksze, ///< a > wartosc
+        wieksze_rowne ///< a >= wartosc
+    };
+
+    /**
+     * @brief Suma wszystkich elementów.
+     * @param m Macierz.
+     * @return Suma (0 dla macierzy pustej).
+     */
+    static long long suma(const matrix& m);
+
+    /**
+     * @brief Najmniejszy element i jego położenie (pierwsze wystąpienie wierszami).
+     * @param m Macierz.
+     * @return Wartość i położenie.
+     * @throws std::invalid_argument Jeśli macierz jest pusta.
+     */
+    static pozycja_wartosci minimum(const matrix& m);
+
+    /**
+     * @brief Największy element i jego położenie (pierwsze wystąpienie wierszami).
+     * @param m Macierz.
+     * @return Wartość i położenie.
+     * @throws std::invalid_argument Jeśli macierz jest pusta.
+     */
+    static pozycja_wartosci maksimum(const matrix& m);
+
+    /**
+     * @brief Ślad macierzy (suma głównej przekątnej).
+     * @param m Macierz.
+     * @return Ślad.
+     */
+    static long long slad(const matrix& m);
+
+    /**
+     * @brief Sumy kolejnych wierszy.
+     * @param m Macierz.
+     * @return Wektor n sum.
+     */
+    static vector<long long> sumy_wierszy(const matrix& m);
+
+    /**
+     * @brief Sumy kolejnych kolumn.
+     * @param m Macierz.
+     * @return Wektor n sum.
+     */
+    static vector<long long> sumy_kolumn(const matrix& m);
+
+    /**
+     * @brief Norma L1 (suma modułów elementów).
+     * @param m Macierz.
+     * @return Norma.
+     */
+    static unsigned long long norma_l1(const matrix& m);
+
+    /**
+     * @brief Norma L2 elementów, czyli norma Frobeniusa.
+     * @param m Macierz.
+     * @return Norma.
+     */
+    static double norma_l2(const matrix& m);
+
+    /**
+     * @brief Norma maksimum (największy moduł elementu).
+     * @param m Macierz.
+     * @return Norma (bez znaku, bo |INT_MIN| nie mieści się w int).
+     */
+    static unsigned int norma_max(const matrix& m);
+
+    /**
+     * @brief Liczy elementy spełniające porównanie z wartością.
+     * @param m Macierz.
+     * @param w Rodzaj porównania.
+     * @param wartosc Wartość porównywana.
+     * @return Liczba elementów.
+     */
+    static long long policz(const matrix& m, warunek w, int wartosc);
+
+    /**
+     * @brief Liczy elementy spełniające dowolny predykat.
+     *
+     * Predykat jest wywoływany dla każdego elementu, więc pętla nie jest wektoryzowana;
+     * dla prostych porównań szybsza jest wersja z warunkiem.
+     *
+     * @param m Macierz.
+     * @param p Predykat p(a); musi być bezpieczny przy wywołaniach z wielu wątków.
+     * @return Liczba elementów.
+     */
+    static long long policz(const matrix& m, const function<bool(int)>& p);
+
+    /**
+     * @brief Liczy wszystkie redukcje w jednym przebiegu po pamięci.
+     * @param m Macierz.
+     * @return Wyniki.
+     * @throws std::invalid_argument Jeśli macierz jest pusta.
+     */
+    static statystyki wszystkie(const matrix& m);
+};
+
+#endif // !REDUKCJA_H
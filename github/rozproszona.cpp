@@ -0,0 +1,499 @@
+/**
+ * @file rozproszona.cpp
+ * @brief Implementacja macierzy rozproszonej między uczestników transportu.
+ */
+
+#include "rozproszona.h"
+#include "watki.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Wyznacza k-ty z `czesci` ciągłych fragmentów zakresu [0, n).
+ * @param n Długość zakresu.
+ * @param czesci Liczba fragmentów.
+ * @param k Numer fragmentu.
+ * @param od Początek fragmentu.
+ * @param do_ Koniec fragmentu (wyłącznie).
+ */
+void macierz_rozproszona::granice(int n, int czesci, int k, int& od, int& do_) {
+	od = (int)((long long)n * k / czesci);
+	do_ = (int)((long long)n * (k + 1) / czesci);
+}
+
+/**
+ * @brief Wyznacza fragment zawierający indeks i.
+ * @param n Długość zakresu.
+ * @param czesci Liczba fragmentów.
+ * @param i Indeks.
+ * @return Numer fragmentu.
+ */
+int macierz_rozproszona::wlasciciel_fragmentu(int n, int czesci, int i) {
+	int k = (int)((long long)i * czesci / n);
+	int od, do_;
+	granice(n, czesci, k, od, do_);
+	while (i >= do_) {
+		granice(n, czesci, ++k, od, do_);
+	}
+	while (i < od) {
+		granice(n, czesci, --k, od, do_);
+	}
+	return k;
+}
+
+/**
+ * @brief Tworzy macierz wypełnioną zerami.
+ *
+ * Domyślna siatka ma tyle wierszy, ile wynosi największy dzielnik liczby
+ * uczestników nie większy od jej pierwiastka.
+ *
+ * @param t Transport bieżącego uczestnika.
+ * @param n Rozmiar macierzy.
+ * @param wiersze_siatki Liczba wierszy siatki (0 - siatka możliwie kwadratowa).
+ * @throws std::invalid_argument Jeśli wiersze_siatki nie dzieli liczby uczestników.
+ */
+macierz_rozproszona::macierz_rozproszona(transport& t, int n, int wiersze_siatki) : t(&t), n(n > 0 ? n : 0) {
+	int p = t.rozmiar();
+	if (wiersze_siatki == 0) {
+		wiersze_siatki = 1;
+		for (int d = 1; (long long)d * d <= p; d++) {
+			if (p % d == 0) {
+				wiersze_siatki = d;
+			}
+		}
+	}
+	if (wiersze_siatki < 1 || p % wiersze_siatki != 0) {
+		throw invalid_argument("Grid does not match number of participants");
+	}
+	pr = wiersze_siatki;
+	pc = p / pr;
+	wi = t.ranga() / pc;
+	kj = t.ranga() % pc;
+	granice(this->n, pr, wi, w_od, w_do);
+	granice(this->n, pc, kj, k_od, k_do);
+	blok.assign((size_t)(w_do - w_od) * (k_do - k_od), 0);
+}
+
+/**
+ * @brief Rozsyła macierz z uczestnika korzen.
+ *
+ * Korzeń wysyła wszystkie bloki bez czekania na odbiorców, po czym kopiuje swój blok.
+ *
+ * @param t Transport bieżącego uczestnika.
+ * @param m Macierz (istotna tylko u korzenia).
+ * @param n Rozmiar macierzy.
+ * @param korzen Ranga uczestnika posiadającego macierz.
+ * @param wiersze_siatki Liczba wierszy siatki.
+ * @return Macierz rozproszona.
+ * @throws std::invalid_argument Jeśli rozmiar macierzy u korzenia jest różny od n.
+ */
+macierz_rozproszona macierz_rozproszona::rozprosz(transport& t, const matrix& m, int n, int korzen, int wiersze_siatki) {
+	macierz_rozproszona w(t, n, wiersze_siatki);
+	if (t.ranga() == korzen) {
+		if (m.n != w.n) {
+			throw invalid_argument("Matrix dimensions mismatch");
+		}
+		for (int q = 0; q < t.rozmiar(); q++) {
+			int r_od, r_do, c_od, c_do;
+			granice(w.n, w.pr, q / w.pc, r_od, r_do);
+			granice(w.n, w.pc, q % w.pc, c_od, c_do);
+			vector<int> dane;
+			dane.reserve((size_t)(r_do - r_od) * (c_do - c_od));
+			for (int i = r_od; i < r_do; i++) {
+				dane.insert(dane.end(), m.data[i] + c_od, m.data[i] + c_do);
+			}
+			if (q == korzen) {
+				w.blok.swap(dane);
+			}
+			else {
+				t.wyslij(q, z_rozprosz, dane);
+			}
+		}
+	}
+	else {
+		w.blok = t.odbierz(korzen, z_rozprosz);
+	}
+	return w;
+}
+
+/**
+ * @brief Zbiera bloki u uczestnika korzen.
+ * @param korzen Ranga uczestnika składającego macierz.
+ * @return Cała macierz u korzenia, pusta macierz u pozostałych.
+ */
+matrix macierz_rozproszona::zbierz(int korzen) const {
+	if (t->ranga() != korzen) {
+		t->wyslij(korzen, z_zbierz, blok);
+		return matrix();
+	}
+	matrix m;
+	m.alokuj(n);
+	for (int q = 0; q < t->rozmiar(); q++) {
+		int r_od, r_do, c_od, c_do;
+		granice(n, pr, q / pc, r_od, r_do);
+		granice(n, pc, q % pc, c_od, c_do);
+		vector<int> dane = q == korzen ? blok : t->odbierz(q, z_zbierz);
+		int szer = c_do - c_od;
+		for (int i = r_od; i < r_do; i++) {
+			copy(dane.begin() + (size_t)(i - r_od) * szer, dane.begin() + (size_t)(i - r_od + 1) * szer, m.data[i] + c_od);
+		}
+	}
+	return m;
+}
+
+int macierz_rozproszona::rozmiar() const {
+	return n;
+}
+
+int macierz_rozproszona::wiersze_siatki() const {
+	return pr;
+}
+
+int macierz_rozproszona::kolumny_siatki() const {
+	return pc;
+}
+
+/**
+ * @brief Zwraca zakres bloku lokalnego.
+ * @param w_od Pierwszy wiersz.
+ * @param w_do Koniec zakresu wierszy (wyłącznie).
+ * @param k_od Pierwsza kolumna.
+ * @param k_do Koniec zakresu kolumn (wyłącznie).
+ */
+void macierz_rozproszona::zakres(int& w_od, int& w_do, int& k_od, int& k_do) const {
+	w_od = this->w_od;
+	w_do = this->w_do;
+	k_od = this->k_od;
+	k_do = this->k_do;
+}
+
+const vector<int>& macierz_rozproszona::blok_lokalny() const {
+	return blok;
+}
+
+/**
+ * @brief Sprawdza, czy macierz ma ten sam podział.
+ * @param m Macierz do sprawdzenia.
+ * @return True, jeśli rozmiar i siatka są takie same.
+ */
+bool macierz_rozproszona::zgodna(const macierz_rozproszona& m) const {
+	return n == m.n && pr == m.pr && pc == m.pc && t->ranga() == m.t->ranga();
+}
+
+/**
+ * @brief Sumuje wartość u wszystkich uczestników (redukcja z rozesłaniem wyniku).
+ *
+ * Uczestnik 0 zbiera wartości, sumuje je i odsyła wynik pozostałym.
+ *
+ * @param x Wartość bieżącego uczestnika.
+ * @return Suma wartości wszystkich uczestników.
+ */
+long long macierz_rozproszona::zsumuj(long long x) const {
+	int p = t->rozmiar();
+	if (p == 1) {
+		return x;
+	}
+	if (t->ranga() != 0) {
+		vector<int> dane(2);
+		dane[0] = (int)(unsigned int)((unsigned long long)x & 0xffffffffULL);
+		dane[1] = (int)(unsigned int)((unsigned long long)x >> 32);
+		t->wyslij(0, z_redukcja, dane);
+		vector<int> wynik = t->odbierz(0, z_wynik);
+		return (long long)(((unsigned long long)(unsigned int)wynik[1] << 32) | (unsigned int)wynik[0]);
+	}
+	unsigned long long suma = (unsigned long long)x;
+	for (int q = 1; q < p; q++) {
+		vector<int> dane = t->odbierz(q, z_redukcja);
+		suma += ((unsigned long long)(unsigned int)dane[1] << 32) | (unsigned int)dane[0];
+	}
+	vector<int> wynik(2);
+	wynik[0] = (int)(unsigned int)(suma & 0xffffffffULL);
+	wynik[1] = (int)(unsigned int)(suma >> 32);
+	for (int q = 1; q < p; q++) {
+		t->wyslij(q, z_wynik, wynik);
+	}
+	return (long long)suma;
+}
+
+/**
+ * @brief Dodaje macierz element po elemencie.
+ * @param m Macierz o tym samym podziale.
+ * @return Referencja do macierzy.
+ * @throws std::invalid_argument Jeśli podziały się różnią.
+ */
+macierz_rozproszona& macierz_rozproszona::operator+=(const macierz_rozproszona& m) {
+	if (!zgodna(m)) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	int* a = blok.data();
+	const int* b = m.blok.data();
+	pula_watkow::globalna().rownolegle((int)blok.size(), [=](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			a[i] = (int)((unsigned int)a[i] + (unsigned int)b[i]);
+		}
+	}, 1 << 16);
+	return *this;
+}
+
+/**
+ * @brief Mnoży macierz element po elemencie.
+ * @param m Macierz o tym samym podziale.
+ * @return Referencja do macierzy.
+ * @throws std::invalid_argument Jeśli podziały się różnią.
+ */
+macierz_rozproszona& macierz_rozproszona::operator*=(const macierz_rozproszona& m) {
+	if (!zgodna(m)) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	int* a = blok.data();
+	const int* b = m.blok.data();
+	pula_watkow::globalna().rownolegle((int)blok.size(), [=](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			a[i] = (int)((unsigned int)a[i] * (unsigned int)b[i]);
+		}
+	}, 1 << 16);
+	return *this;
+}
+
+/**
+ * @brief Dodaje skalar do każdego elementu.
+ * @param a Skalar.
+ * @return Referencja do macierzy.
+ */
+macierz_rozproszona& macierz_rozproszona::operator+=(int a) {
+	for (size_t i = 0; i < blok.size(); i++) {
+		blok[i] = (int)((unsigned int)blok[i] + (unsigned int)a);
+	}
+	return *this;
+}
+
+/**
+ * @brief Odejmuje skalar od każdego elementu.
+ * @param a Skalar.
+ * @return Referencja do macierzy.
+ */
+macierz_rozproszona& macierz_rozproszona::operator-=(int a) {
+	for (size_t i = 0; i < blok.size(); i++) {
+		blok[i] = (int)((unsigned int)blok[i] - (unsigned int)a);
+	}
+	return *this;
+}
+
+/**
+ * @brief Mnoży każdy element przez skalar.
+ * @param a Skalar.
+ * @return Referencja do macierzy.
+ */
+macierz_rozproszona& macierz_rozproszona::operator*=(int a) {
+	for (size_t i = 0; i < blok.size(); i++) {
+		blok[i] = (int)((unsigned int)blok[i] * (unsigned int)a);
+	}
+	return *this;
+}
+
+/**
+ * @brief Transpozycja.
+ *
+ * Element (i, j) trafia do właściciela pozycji (j, i). Każdy uczestnik wysyła każdemu
+ * (także sobie) część swojego bloku leżącą w transponowanym bloku odbiorcy - już
+ * w kolejności wierszy odbiorcy - a następnie odbiera części od wszystkich.
+ * Puste części nie są wysyłane; odbiorca wyznacza je tak samo jak nadawca.
+ *
+ * @return Nowa macierz o tym samym podziale.
+ */
+macierz_rozproszona macierz_rozproszona::transpozycja() const {
+	macierz_rozproszona w(*t, n, pr);
+	int p = t->rozmiar();
+	int szer = k_do - k_od;
+	for (int q = 0; q < p; q++) {
+		int r_od, r_do, c_od, c_do;
+		granice(n, pr, q / pc, r_od, r_do);
+		granice(n, pc, q % pc, c_od, c_do);
+		int i_od = max(w_od, c_od), i_do = min(w_do, c_do);
+		int j_od = max(k_od, r_od), j_do = min(k_do, r_do);
+		if (i_od >= i_do || j_od >= j_do) {
+			continue;
+		}
+		vector<int> dane;
+		dane.reserve((size_t)(i_do - i_od) * (j_do - j_od));
+		for (int j = j_od; j < j_do; j++) {
+			for (int i = i_od; i < i_do; i++) {
+				dane.push_back(blok[(size_t)(i - w_od) * szer + (j - k_od)]);
+			}
+		}
+		t->wyslij(q, z_transpozycja, dane);
+	}
+
+	int w_szer = w.k_do - w.k_od;
+	for (int q = 0; q < p; q++) {
+		int r_od, r_do, c_od, c_do;
+		granice(n, pr, q / pc, r_od, r_do);
+		granice(n, pc, q % pc, c_od, c_do);
+		int j_od = max(w.w_od, c_od), j_do = min(w.w_do, c_do);
+		int i_od = max(w.k_od, r_od), i_do = min(w.k_do, r_do);
+		if (i_od >= i_do || j_od >= j_do) {
+			continue;
+		}
+		vector<int> dane = t->odbierz(q, z_transpozycja);
+		size_t k = 0;
+		for (int j = j_od; j < j_do; j++) {
+			for (int i = i_od; i < i_do; i++) {
+				w.blok[(size_t)(j - w.w_od) * w_szer + (i - w.k_od)] = dane[k++];
+			}
+		}
+	}
+	return w;
+}
+
+/**
+ * @brief Iloczyn algebraiczny algorytmem SUMMA.
+ *
+ * Wymiar sumowania jest dzielony na panele wyznaczone przez granice kolumn bloków
+ * lewego czynnika i wierszy bloków prawego. Dla panelu [k0, k1) właściciele kolumn
+ * A[:, k0:k1] rozsyłają je wzdłuż wierszy siatki, a właściciele wierszy B[k0:k1, :]
+ * wzdłuż kolumn siatki; każdy uczestnik dodaje iloczyn otrzymanych paneli do swojego
+ * bloku wyniku. Panel s + 1 jest wysyłany przed liczeniem panelu s, więc przesyłanie
+ * następnego panelu odbywa się w trakcie obliczeń. Przepełnienia są zawijane modulo 2^32,
+ * jak w matrix::iloczyn.
+ *
+ * @param m Prawy czynnik o tym samym podziale.
+ * @return Nowa macierz o tym samym podziale.
+ * @throws std::invalid_argument Jeśli podziały się różnią.
+ */
+macierz_rozproszona macierz_rozproszona::iloczyn(const macierz_rozproszona& m) const {
+	if (!zgodna(m)) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	macierz_rozproszona w(*t, n, pr);
+
+	vector<int> krawedzie;
+	for (int c = 0; c <= pc; c++) {
+		krawedzie.push_back((int)((long long)n * c / pc));
+	}
+	for (int r = 0; r <= pr; r++) {
+		krawedzie.push_back((int)((long long)n * r / pr));
+	}
+	sort(krawedzie.begin(), krawedzie.end());
+	krawedzie.erase(unique(krawedzie.begin(), krawedzie.end()), krawedzie.end());
+	int panele = (int)krawedzie.size() - 1;
+
+	int szer_a = k_do - k_od;
+	int wys = w_do - w_od;
+	int szer = w.k_do - w.k_od;
+
+	// Wysyła panel s; własne części paneli trafiają do wlasny_a i wlasny_b.
+	vector<int> wlasny_a, wlasny_b;
+	auto wyslij_panel = [&](int s) {
+		int k0 = krawedzie[s], k1 = krawedzie[s + 1];
+		if (wlasciciel_fragmentu(n, pc, k0) == kj) {
+			vector<int> dane;
+			dane.reserve((size_t)wys * (k1 - k0));
+			for (int i = 0; i < wys; i++) {
+				const int* wiersz = blok.data() + (size_t)i * szer_a + (k0 - k_od);
+				dane.insert(dane.end(), wiersz, wiersz + (k1 - k0));
+			}
+			for (int b = 0; b < pc; b++) {
+				if (b != kj) {
+					t->wyslij(wi * pc + b, z_panel_a, dane);
+				}
+			}
+			wlasny_a.swap(dane);
+		}
+		if (wlasciciel_fragmentu(n, pr, k0) == wi) {
+			vector<int> dane(m.blok.begin() + (size_t)(k0 - m.w_od) * szer, m.blok.begin() + (size_t)(k1 - m.w_od) * szer);
+			for (int a = 0; a < pr; a++) {
+				if (a != wi) {
+					t->wyslij(a * pc + kj, z_panel_b, dane);
+				}
+			}
+			wlasny_b.swap(dane);
+		}
+	};
+
+	if (panele > 0) {
+		wyslij_panel(0);
+	}
+	for (int s = 0; s < panele; s++) {
+		int k0 = krawedzie[s], k1 = krawedzie[s + 1];
+		int wlasciciel_a = wlasciciel_fragmentu(n, pc, k0);
+		int wlasciciel_b = wlasciciel_fragmentu(n, pr, k0);
+		vector<int> panel_a = wlasciciel_a == kj ? move(wlasny_a) : t->odbierz(wi * pc + wlasciciel_a, z_panel_a);
+		vector<int> panel_b = wlasciciel_b == wi ? move(wlasny_b) : t->odbierz(wlasciciel_b * pc + kj, z_panel_b);
+		if (s + 1 < panele) {
+			wyslij_panel(s + 1);
+		}
+
+		int kw = k1 - k0;
+		const unsigned int* pa = (const unsigned int*)panel_a.data();
+		const unsigned int* pb = (const unsigned int*)panel_b.data();
+		unsigned int* c = (unsigned int*)w.blok.data();
+		pula_watkow::globalna().rownolegle(wys, [=](int od, int do_, int) {
+			for (int i = od; i < do_; i++) {
+				unsigned int* ci = c + (size_t)i * szer;
+				for (int k = 0; k < kw; k++) {
+					unsigned int aik = pa[(size_t)i * kw + k];
+					const unsigned int* bk = pb + (size_t)k * szer;
+					for (int j = 0; j < szer; j++) {
+						ci[j] += aik * bk[j];
+					}
+				}
+			}
+		}, 16);
+	}
+	return w;
+}
+
+/**
+ * @brief Suma wszystkich elementów.
+ * @return Suma (64 bity), taka sama u wszystkich uczestników.
+ */
+long long macierz_rozproszona::suma() const {
+	long long s = 0;
+	for (size_t i = 0; i < blok.size(); i++) {
+		s += blok[i];
+	}
+	return zsumuj(s);
+}
+
+/**
+ * @brief Porównuje macierze element po elemencie.
+ *
+ * Każdy uczestnik liczy różniące się elementy swojego bloku, a liczby są sumowane.
+ *
+ * @param m Macierz o tym samym podziale.
+ * @return True u wszystkich uczestników, jeśli macierze są równe.
+ */
+bool macierz_rozproszona::operator==(const macierz_rozproszona& m) const {
+	if (!zgodna(m)) {
+		return false;
+	}
+	long long rozne = 0;
+	for (size_t i = 0; i < blok.size(); i++) {
+		rozne += blok[i] != m.blok[i];
+	}
+	return zsumuj(rozne) == 0;
+}
+
+/**
+ * @brief Porównuje sumy elementów.
+ * @param m Macierz do porównania.
+ * @return True, jeśli suma bieżącej macierzy jest większa.
+ */
+bool macierz_rozproszona::operator>(const macierz_rozproszona& m) const {
+	long long a = suma();
+	long long b = m.suma();
+	return a > b;
+}
+
+/**
+ * @brief Porównuje sumy elementów.
+ * @param m Macierz do porównania.
+ * @return True, jeśli suma bieżącej macierzy jest mniejsza.
+ */
+bool macierz_rozproszona::operator<(const macierz_rozproszona& m) const {
+	long long a = suma();
+	long long b = m.suma();
+	return a < b;
+}
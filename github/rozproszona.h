@@ -0,0 +1,188 @@
+#pragma once
+#ifndef ROZPROSZONA_H
+#define ROZPROSZONA_H
+
+#include "matrix.h"
+#include "transport.h"
+#include <vector>
+using namespace std;
+
+/**
+ * @class macierz_rozproszona
+ * @brief Macierz n x n podzielona na bloki należące do osobnych uczestników.
+ *
+ * Uczestnicy (procesy robocze połączone transportem) tworzą siatkę pr x pc.
+ * Uczestnik o randze r = wi * pc + kj przechowuje blok z wierszami z fragmentu wi
+ * i kolumnami z fragmentu kj (fragmenty jak w pula_watkow::podzial). Podział
+ * wierszami to siatka p x 1.
+ *
+ * Wszystkie metody poza dostępem do bloku lokalnego są zbiorowe: każdy uczestnik
+ * musi je wywołać w tej samej kolejności.
+ */
+class macierz_rozproszona {
+public:
+    /**
+     * @brief Tworzy macierz wypełnioną zerami.
+     * @param t Transport bieżącego uczestnika.
+     * @param n Rozmiar macierzy.
+     * @param wiersze_siatki Liczba wierszy siatki (dzielnik liczby uczestników, 0 - siatka
+     *        możliwie kwadratowa).
+     * @throws std::invalid_argument Jeśli wiersze_siatki nie dzieli liczby uczestników.
+     */
+    macierz_rozproszona(transport& t, int n, int wiersze_siatki = 0);
+
+    /**
+     * @brief Rozsyła macierz z uczestnika korzen do wszystkich uczestników.
+     * @param t Transport bieżącego uczestnika.
+     * @param m Macierz (istotna tylko u korzenia).
+     * @param n Rozmiar macierzy (musi być znany wszystkim uczestnikom).
+     * @param korzen Ranga uczestnika posiadającego macierz.
+     * @param wiersze_siatki Liczba wierszy siatki (0 - siatka możliwie kwadratowa).
+     * @return Macierz rozproszona.
+     */
+    static macierz_rozproszona rozprosz(transport& t, const matrix& m, int n, int korzen = 0, int wiersze_siatki = 0);
+
+    /**
+     * @brief Zbiera bloki u uczestnika korzen.
+     * @param korzen Ranga uczestnika składającego macierz.
+     * @return Cała macierz u korzenia, pusta macierz u pozostałych.
+     */
+    matrix zbierz(int korzen = 0) const;
+
+    /**
+     * @brief Zwraca rozmiar macierzy.
+     * @return Rozmiar n.
+     */
+    int rozmiar() const;
+
+    /**
+     * @brief Zwraca liczbę wierszy siatki uczestników.
+     * @return Liczba wierszy siatki.
+     */
+    int wiersze_siatki() const;
+
+    /**
+     * @brief Zwraca liczbę kolumn siatki uczestników.
+     * @return Liczba kolumn siatki.
+     */
+    int kolumny_siatki() const;
+
+    /**
+     * @brief Zwraca zakres bloku lokalnego.
+     * @param w_od Pierwszy wiersz.
+     * @param w_do Koniec zakresu wierszy (wyłącznie).
+     * @param k_od Pierwsza kolumna.
+     * @param k_do Koniec zakresu kolumn (wyłącznie).
+     */
+    void zakres(int& w_od, int& w_do, int& k_od, int& k_do) const;
+
+    /**
+     * @brief Zwraca blok lokalny (wierszami).
+     * @return Elementy bloku.
+     */
+    const vector<int>& blok_lokalny() const;
+
+    /**
+     * @brief Dodaje macierz element po elemencie (bez komunikacji).
+     * @param m Macierz o tym samym podziale.
+     * @return Referencja do macierzy.
+     * @throws std::invalid_argument Jeśli podziały się różnią.
+     */
+    macierz_rozproszona& operator+=(const macierz_rozproszona& m);
+
+    /**
+     * @brief Mnoży macierz element po elemencie (bez komunikacji).
+     * @param m Macierz o tym samym podziale.
+     * @return Referencja do macierzy.
+     * @throws std::invalid_argument Jeśli podziały się różnią.
+     */
+    macierz_rozproszona& operator*=(const macierz_rozproszona& m);
+
+    /**
+     * @brief Dodaje skalar do każdego elementu.
+     * @param a Skalar.
+     * @return Referencja do macierzy.
+     */
+    macierz_rozproszona& operator+=(int a);
+
+    /**
+     * @brief Odejmuje skalar od każdego elementu.
+     * @param a Skalar.
+     * @return Referencja do macierzy.
+     */
+    macierz_rozproszona& operator-=(int a);
+
+    /**
+     * @brief Mnoży każdy element przez skalar.
+     * @param a Skalar.
+     * @return Referencja do macierzy.
+     */
+    macierz_rozproszona& operator*=(int a);
+
+    /**
+     * @brief Transpozycja (wymiana bloków każdy z każdym).
+     * @return Nowa macierz o tym samym podziale.
+     */
+    macierz_rozproszona transpozycja() const;
+
+    /**
+     * @brief Iloczyn algebraiczny algorytmem SUMMA.
+     * @param m Prawy czynnik o tym samym podziale.
+     * @return Nowa macierz o tym samym podziale.
+     * @throws std::invalid_argument Jeśli podziały się różnią.
+     */
+    macierz_rozproszona iloczyn(const macierz_rozproszona& m) const;
+
+    /**
+     * @brief Suma wszystkich elementów (znana wszystkim uczestnikom).
+     * @return Suma (64 bity).
+     */
+    long long suma() const;
+
+    /**
+     * @brief Porównuje macierze element po elemencie.
+     * @param m Macierz o tym samym podziale.
+     * @return True u wszystkich uczestników, jeśli macierze są równe.
+     */
+    bool operator==(const macierz_rozproszona& m) const;
+
+    /**
+     * @brief Porównuje sumy elementów (jak matrix::operator>).
+     * @param m Macierz do porównania.
+     * @return True, jeśli suma bieżącej macierzy jest większa.
+     */
+    bool operator>(const macierz_rozproszona& m) const;
+
+    /**
+     * @brief Porównuje sumy elementów (jak matrix::operator<).
+     * @param m Macierz do porównania.
+     * @return True, jeśli suma bieżącej macierzy jest mniejsza.
+     */
+    bool operator<(const macierz_rozproszona& m) const;
+
+private:
+    /**
+     * @brief Znaczniki komunikatów poszczególnych operacji.
+     */
+    enum znacznik { z_rozprosz = 100, z_zbierz, z_transpozycja, z_panel_a, z_panel_b, z_redukcja, z_wynik };
+
+    static void granice(int n, int czesci, int k, int& od, int& do_);
+    static int wlasciciel_fragmentu(int n, int czesci, int i);
+
+    bool zgodna(const macierz_rozproszona& m) const;
+    long long zsumuj(long long x) const;
+
+    transport* t; ///< Transport bieżącego uczestnika
+    int n; ///< Rozmiar macierzy
+    int pr; ///< Liczba wierszy siatki
+    int pc; ///< Liczba kolumn siatki
+    int wi; ///< Wiersz siatki bieżącego uczestnika
+    int kj; ///< Kolumna siatki bieżącego uczestnika
+    int w_od; ///< Pierwszy wiersz bloku
+    int w_do; ///< Koniec wierszy bloku (wyłącznie)
+    int k_od; ///< Pierwsza kolumna bloku
+    int k_do; ///< Koniec kolumn bloku (wyłącznie)
+    vector<int> blok; ///< Elementy bloku (wierszami)
+};
+
+#endif // !ROZPROSZONA_H
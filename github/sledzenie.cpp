@@ -0,0 +1,283 @@
+/**
+ * @file sledzenie.cpp
+ * @brief Implementacja zapisu przebiegu operacji w formacie Chrome Trace Event.
+ */
+
+#include "sledzenie.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+atomic<bool> sledzenie::aktywne_(false);
+
+/**
+ * @brief Zapisane zdarzenie.
+ */
+struct zdarzenie_sledzenia {
+	const char* nazwa; ///< Nazwa operacji
+	long long poczatek; ///< Czas początku (ns)
+	long long koniec; ///< Czas końca (ns)
+	long long n; ///< Rozmiar
+	long long bajty; ///< Dotknięte bajty
+};
+
+/**
+ * @brief Bufor cykliczny zdarzeń jednego wątku.
+ *
+ * Zapisuje tylko wątek właściciel; licznik jest publikowany z semantyką release,
+ * więc eksport widzi kompletne zdarzenia. Licznik zdarzeń w toku też zmienia tylko
+ * właściciel, więc zapis zdarzenia nie dotyka linii pamięci innych wątków.
+ */
+struct bufor_sledzenia {
+	int watek; ///< Numer wątku w pliku
+	atomic<size_t> zapisane{ 0 }; ///< Liczba zdarzeń zapisanych od wyczyszczenia
+	atomic<int> w_toku{ 0 }; ///< Liczba rozpoczętych, niezapisanych zdarzeń wątku
+	bool wolny = false; ///< Czy wątek właściciel się zakończył (chronione mtx_buforow)
+	vector<zdarzenie_sledzenia> zdarzenia; ///< POJEMNOSC zdarzeń
+};
+
+/// Chroni listę buforów (rejestracja i zakończenie wątku, czyszczenie i eksport).
+static mutex mtx_buforow;
+/// Bufory wątków, które zapisały zdarzenie, także zakończonych (do eksportu i ponownego użycia).
+static vector<shared_ptr<bufor_sledzenia>> bufory;
+/// Numer następnego nowego bufora w pliku.
+static int nastepny_watek = 0;
+
+/**
+ * @brief Bufor bieżącego wątku; przy zakończeniu wątku oddaje go do ponownego użycia.
+ */
+struct wlasciciel_bufora {
+	shared_ptr<bufor_sledzenia> b; ///< Bufor lub nullptr przed pierwszym zdarzeniem
+
+	~wlasciciel_bufora() {
+		if (b) {
+			lock_guard<mutex> blokada(mtx_buforow);
+			b->wolny = true;
+		}
+	}
+};
+
+/// Bufor bieżącego wątku.
+static thread_local wlasciciel_bufora bufor_watku;
+
+/**
+ * @brief Zwraca czas od pierwszego wywołania w nanosekundach.
+ * @return Czas (ns).
+ */
+static long long teraz() {
+	static const chrono::steady_clock::time_point poczatek = chrono::steady_clock::now();
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - poczatek).count();
+}
+
+/**
+ * @brief Wypisuje czas w mikrosekundach z dokładnością do nanosekundy.
+ * @param o Strumień wyjściowy.
+ * @param ns Czas (ns, nieujemny).
+ */
+static void mikrosekundy(ostream& o, long long ns) {
+	char t[32];
+	snprintf(t, sizeof(t), "%lld.%03lld", ns / 1000, ns % 1000);
+	o << t;
+}
+
+/**
+ * @brief Zwraca bufor bieżącego wątku, przy pierwszym zdarzeniu przejmując bufor
+ *        zakończonego wątku albo rejestrując nowy.
+ * @return Bufor wątku.
+ */
+static bufor_sledzenia& moj_bufor() {
+	if (!bufor_watku.b) {
+		{
+			lock_guard<mutex> blokada(mtx_buforow);
+			for (size_t i = 0; i < bufory.size(); i++) {
+				if (bufory[i]->wolny) {
+					bufory[i]->wolny = false;
+					bufor_watku.b = bufory[i];
+					return *bufor_watku.b;
+				}
+			}
+		}
+		shared_ptr<bufor_sledzenia> b = make_shared<bufor_sledzenia>();
+		b->zdarzenia.resize(sledzenie::POJEMNOSC);
+		lock_guard<mutex> blokada(mtx_buforow);
+		b->watek = nastepny_watek++;
+		bufory.push_back(b);
+		bufor_watku.b = b;
+	}
+	return *bufor_watku.b;
+}
+
+/**
+ * @brief Zapamiętuje dane i czas początku zdarzenia.
+ *
+ * Zdarzenie jest liczone w liczniku w_toku bufora wątku przed ponownym sprawdzeniem
+ * flagi; eksport najpierw wyłącza flagę, a potem czyta liczniki wszystkich buforów.
+ * Przy porządku sekwencyjnym albo eksport widzi zdarzenie i czeka na nie, albo zdarzenie
+ * widzi wyłączoną flagę i nie jest zapisywane.
+ *
+ * @param nazwa Nazwa operacji.
+ * @param n Rozmiar.
+ * @param bajty Dotknięte bajty.
+ */
+void sledzenie::zakres::rozpocznij(const char* nazwa, long long n, long long bajty) {
+	bufor_sledzenia& b = moj_bufor();
+	b.w_toku.fetch_add(1);
+	if (!aktywne_.load()) {
+		b.w_toku.fetch_sub(1);
+		aktywny = false;
+		return;
+	}
+	this->nazwa = nazwa;
+	this->n = n;
+	this->bajty = bajty;
+	poczatek = teraz();
+}
+
+/**
+ * @brief Zapisuje zakończone zdarzenie w buforze wątku.
+ */
+void sledzenie::zakres::zakoncz() {
+	bufor_sledzenia& b = *bufor_watku.b;
+	size_t i = b.zapisane.load(memory_order_relaxed);
+	zdarzenie_sledzenia& z = b.zdarzenia[i % POJEMNOSC];
+	z.nazwa = nazwa;
+	z.poczatek = poczatek;
+	z.koniec = teraz();
+	z.n = n;
+	z.bajty = bajty;
+	b.zapisane.store(i + 1, memory_order_release);
+	b.w_toku.fetch_sub(1, memory_order_release);
+}
+
+/**
+ * @brief Włącza lub wyłącza zapisywanie zdarzeń.
+ * @param wlacz Czy zapisywać.
+ */
+void sledzenie::wlacz(bool wlacz) {
+	teraz();
+	aktywne_.store(wlacz);
+}
+
+/**
+ * @brief Sprawdza, że śledzenie jest wyłączone, i czeka na zapis rozpoczętych zdarzeń.
+ *
+ * Wywoływana pod mtx_buforow: wątek kończący zdarzenie nie potrzebuje tej blokady,
+ * a nowy wątek zarejestruje bufor dopiero po eksporcie i zobaczy wyłączoną flagę.
+ *
+ * @throws std::logic_error Jeśli śledzenie jest włączone.
+ */
+void sledzenie::czekaj_na_zapis() {
+	if (aktywne_.load()) {
+		throw logic_error("Tracing must be disabled before export or clear");
+	}
+	for (size_t i = 0; i < bufory.size(); i++) {
+		while (bufory[i]->w_toku.load() != 0) {
+			this_thread::yield();
+		}
+	}
+}
+
+/**
+ * @brief Usuwa zapisane zdarzenia wszystkich wątków i zwalnia bufory zakończonych wątków.
+ * @throws std::logic_error Jeśli śledzenie jest włączone.
+ */
+void sledzenie::wyczysc() {
+	lock_guard<mutex> blokada(mtx_buforow);
+	czekaj_na_zapis();
+	bufory.erase(remove_if(bufory.begin(), bufory.end(),
+		[](const shared_ptr<bufor_sledzenia>& b) { return b->wolny; }), bufory.end());
+	for (size_t i = 0; i < bufory.size(); i++) {
+		bufory[i]->zapisane.store(0);
+	}
+}
+
+/**
+ * @brief Zwraca liczbę zdarzeń w buforach.
+ * @return Liczba zdarzeń.
+ */
+size_t sledzenie::liczba_zdarzen() {
+	lock_guard<mutex> blokada(mtx_buforow);
+	size_t suma = 0;
+	for (size_t i = 0; i < bufory.size(); i++) {
+		suma += min(bufory[i]->zapisane.load(memory_order_acquire), (size_t)POJEMNOSC);
+	}
+	return suma;
+}
+
+/**
+ * @brief Zwraca liczbę przydzielonych buforów wątków.
+ * @return Liczba buforów.
+ */
+size_t sledzenie::liczba_buforow() {
+	lock_guard<mutex> blokada(mtx_buforow);
+	return bufory.size();
+}
+
+/**
+ * @brief Zapisuje zdarzenia w formacie JSON Chrome Trace Event.
+ *
+ * Każda operacja to zdarzenie pełne ("ph":"X") z czasem w mikrosekundach; nazwy
+ * wątków są dodawane zdarzeniami metadanych.
+ *
+ * @param o Strumień wyjściowy.
+ * @throws std::logic_error Jeśli śledzenie jest włączone.
+ */
+void sledzenie::zapisz(ostream& o) {
+	lock_guard<mutex> blokada(mtx_buforow);
+	czekaj_na_zapis();
+	o << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool pierwsze = true;
+	auto przecinek = [&]() {
+		if (!pierwsze) {
+			o << ",";
+		}
+		pierwsze = false;
+		o << "\n";
+	};
+	for (size_t b = 0; b < bufory.size(); b++) {
+		const bufor_sledzenia& bufor = *bufory[b];
+		przecinek();
+		o << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << bufor.watek
+			<< ",\"args\":{\"name\":\"watek " << bufor.watek << "\"}}";
+		size_t koniec = bufor.zapisane.load(memory_order_acquire);
+		size_t poczatek = koniec > (size_t)POJEMNOSC ? koniec - POJEMNOSC : 0;
+		for (size_t i = poczatek; i < koniec; i++) {
+			const zdarzenie_sledzenia& z = bufor.zdarzenia[i % POJEMNOSC];
+			przecinek();
+			o << "{\"name\":\"" << z.nazwa << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << bufor.watek << ",\"ts\":";
+			mikrosekundy(o, z.poczatek);
+			o << ",\"dur\":";
+			mikrosekundy(o, z.koniec - z.poczatek);
+			o << ",\"args\":{\"n\":" << z.n << ",\"bajty\":" << z.bajty << "}}";
+		}
+	}
+	o << "\n]}\n";
+}
+
+/**
+ * @brief Zapisuje zdarzenia do pliku.
+ * @param plik Ścieżka pliku.
+ * @throws std::logic_error Jeśli śledzenie jest włączone.
+ * @throws std::runtime_error Jeśli nie można zapisać pliku.
+ */
+void sledzenie::zapisz(const string& plik) {
+	if (wlaczone()) {
+		throw logic_error("Tracing must be disabled before export or clear");
+	}
+	ofstream f(plik);
+	if (!f) {
+		throw runtime_error("Cannot write trace file");
+	}
+	zapisz(f);
+	if (!f) {
+		throw runtime_error("Cannot write trace file");
+	}
+}
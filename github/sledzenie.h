@@ -0,0 +1,131 @@
+#pragma once
+#ifndef SLEDZENIE_H
+#define SLEDZENIE_H
+
+#include <atomic>
+#include <iostream>
+#include <string>
+using namespace std;
+
+/**
+ * @class sledzenie
+ * @brief Opcjonalny zapis przebiegu operacji macierzy w formacie Chrome/Perfetto.
+ *
+ * Po włączeniu każda operacja publiczna klasy matrix oraz każdy fragment zadania puli
+ * wątków zapisuje zdarzenie: nazwę, wątek, czas początku i trwania, rozmiar macierzy
+ * i przybliżoną liczbę dotkniętych bajtów. Zdarzenia trafiają do bufora cyklicznego
+ * wątku (bez blokad; po zapełnieniu najstarsze są nadpisywane). Plik z zapisz() można
+ * otworzyć w chrome://tracing lub ui.perfetto.dev.
+ *
+ * Bufor zakończonego wątku zostaje ze swoimi zdarzeniami do eksportu, a następny nowy
+ * wątek przejmuje go zamiast przydzielać własny, więc buforów jest najwyżej tyle, ile
+ * wątków śledziło jednocześnie. wyczysc() zwalnia bufory zakończonych wątków.
+ *
+ * Wyłączone śledzenie kosztuje jedno sprawdzenie flagi na początku i końcu operacji.
+ * Eksport i czyszczenie buforów są dozwolone tylko po wlacz(false); czekają wtedy na
+ * zakończenie zdarzeń rozpoczętych przed wyłączeniem, więc nie ścigają się z zapisem.
+ */
+class sledzenie {
+public:
+    static const int POJEMNOSC = 1 << 16; ///< Liczba zdarzeń w buforze wątku
+
+    /**
+     * @class zakres
+     * @brief Zdarzenie obejmujące czas życia obiektu.
+     */
+    class zakres {
+    public:
+        /**
+         * @brief Rozpoczyna zdarzenie, jeśli śledzenie jest włączone.
+         * @param nazwa Nazwa operacji (napis stały).
+         * @param n Rozmiar macierzy lub zakresu.
+         * @param bajty Przybliżona liczba odczytanych i zapisanych bajtów.
+         */
+        zakres(const char* nazwa, long long n = 0, long long bajty = 0) : aktywny(wlaczone()) {
+            if (aktywny) {
+                rozpocznij(nazwa, n, bajty);
+            }
+        }
+
+        /**
+         * @brief Kończy zdarzenie i zapisuje je w buforze wątku.
+         */
+        ~zakres() {
+            if (aktywny) {
+                zakoncz();
+            }
+        }
+
+        zakres(const zakres&) = delete;
+        zakres& operator=(const zakres&) = delete;
+
+    private:
+        void rozpocznij(const char* nazwa, long long n, long long bajty);
+        void zakoncz();
+
+        bool aktywny; ///< Czy zdarzenie jest zapisywane
+        const char* nazwa; ///< Nazwa operacji
+        long long n; ///< Rozmiar
+        long long bajty; ///< Dotknięte bajty
+        long long poczatek; ///< Czas początku (ns)
+    };
+
+    /**
+     * @brief Sprawdza, czy śledzenie jest włączone.
+     * @return True, jeśli zdarzenia są zapisywane.
+     */
+    static bool wlaczone() { return aktywne_.load(memory_order_relaxed); }
+
+    /**
+     * @brief Włącza lub wyłącza zapisywanie zdarzeń.
+     * @param wlacz Czy zapisywać.
+     */
+    static void wlacz(bool wlacz = true);
+
+    /**
+     * @brief Usuwa zapisane zdarzenia wszystkich wątków.
+     *
+     * Czeka na zakończenie zdarzeń rozpoczętych przed wyłączeniem śledzenia i zwalnia
+     * bufory zakończonych wątków.
+     *
+     * @throws std::logic_error Jeśli śledzenie jest włączone.
+     */
+    static void wyczysc();
+
+    /**
+     * @brief Zwraca liczbę zdarzeń w buforach (bez nadpisanych).
+     * @return Liczba zdarzeń.
+     */
+    static size_t liczba_zdarzen();
+
+    /**
+     * @brief Zwraca liczbę przydzielonych buforów wątków (żywych i do ponownego użycia).
+     * @return Liczba buforów.
+     */
+    static size_t liczba_buforow();
+
+    /**
+     * @brief Zapisuje zdarzenia w formacie JSON Chrome Trace Event.
+     *
+     * Czeka na zakończenie zdarzeń rozpoczętych przed wyłączeniem śledzenia.
+     *
+     * @param o Strumień wyjściowy.
+     * @throws std::logic_error Jeśli śledzenie jest włączone.
+     */
+    static void zapisz(ostream& o);
+
+    /**
+     * @brief Zapisuje zdarzenia do pliku.
+     * @param plik Ścieżka pliku.
+     * @throws std::logic_error Jeśli śledzenie jest włączone.
+     * @throws std::runtime_error Jeśli nie można zapisać pliku.
+     */
+    static void zapisz(const string& plik);
+
+private:
+    static void czekaj_na_zapis();
+
+    static atomic<bool> aktywne_; ///< Czy śledzenie jest włączone
+};
+
+#endif // !SLEDZENIE_H
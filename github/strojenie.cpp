@@ -0,0 +1,319 @@
+/**
+ * @file strojenie.cpp
+ * @brief Implementacja doboru parametrów jąder macierzy pomiarem.
+ */
+
+#include "strojenie.h"
+#include "matrix.h"
+#include "watki.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#pragma comment(lib, "advapi32.lib")
+#endif
+
+using namespace std;
+
+/// Bok kafla transpozycji.
+static atomic<int> kafel_(32);
+/// Rozmiar paska iloczynu (KB).
+static atomic<int> pasek_kb_(512);
+/// Rozwinięcie pętli iloczynu.
+static atomic<int> rozwiniecie_(1);
+/// Próg zrównoleglenia operacji elementami.
+static atomic<int> prog_(32);
+/// Pochodzenie bieżących parametrów.
+static atomic<int> zrodlo_(strojenie::domyslne);
+
+/**
+ * @brief Sprawdza poprawność parametrów.
+ * @param u Parametry.
+ * @return True, jeśli parametry są poprawne.
+ */
+static bool poprawne(const strojenie::ustawienia& u) {
+	return u.kafel >= 1 && u.pasek_kb >= 1 && (u.rozwiniecie == 1 || u.rozwiniecie == 2 || u.rozwiniecie == 4) && u.prog >= 1;
+}
+
+/**
+ * @brief Ustawia parametry bez zmiany pochodzenia.
+ * @param u Parametry (poprawne).
+ */
+static void zastosuj(const strojenie::ustawienia& u) {
+	kafel_.store(u.kafel);
+	pasek_kb_.store(u.pasek_kb);
+	rozwiniecie_.store(u.rozwiniecie);
+	prog_.store(u.prog);
+}
+
+/**
+ * @brief Mierzy najkrótszy z kilku czasów wykonania.
+ * @param f Mierzona operacja.
+ * @param powtorzenia Liczba pomiarów.
+ * @return Najkrótszy czas w mikrosekundach.
+ */
+template <class F>
+static long long najkrotszy(F f, int powtorzenia) {
+	long long najlepszy = LLONG_MAX;
+	for (int p = 0; p < powtorzenia; p++) {
+		auto start = chrono::steady_clock::now();
+		f();
+		long long t = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+		if (t < najlepszy) {
+			najlepszy = t;
+		}
+	}
+	return najlepszy;
+}
+
+/**
+ * @brief Wybiera najszybszą wartość jednego parametru.
+ * @param u Parametry; pole jest ustawiane na najlepszego kandydata.
+ * @param pole Dobierany parametr.
+ * @param kandydaci Sprawdzane wartości.
+ * @param pomiar Zwraca czas operacji przy bieżących parametrach.
+ */
+template <class F>
+static void wybierz(strojenie::ustawienia& u, int strojenie::ustawienia::* pole, const vector<int>& kandydaci, F pomiar) {
+	long long najlepszy = LLONG_MAX;
+	int wybrany = u.*pole;
+	for (int k : kandydaci) {
+		strojenie::ustawienia proba = u;
+		proba.*pole = k;
+		zastosuj(proba);
+		long long czas = pomiar();
+		if (czas < najlepszy) {
+			najlepszy = czas;
+			wybrany = k;
+		}
+	}
+	u.*pole = wybrany;
+}
+
+/**
+ * @brief Zwraca wartości wbudowane.
+ * @return Parametry domyślne.
+ */
+strojenie::ustawienia strojenie::domyslne_ustawienia() {
+	ustawienia u;
+	u.kafel = 32;
+	u.pasek_kb = 512;
+	u.rozwiniecie = 1;
+	u.prog = 32;
+	return u;
+}
+
+/**
+ * @brief Zwraca bieżące parametry.
+ * @return Parametry.
+ */
+strojenie::ustawienia strojenie::biezace() {
+	ustawienia u;
+	u.kafel = kafel_.load(memory_order_relaxed);
+	u.pasek_kb = pasek_kb_.load(memory_order_relaxed);
+	u.rozwiniecie = rozwiniecie_.load(memory_order_relaxed);
+	u.prog = prog_.load(memory_order_relaxed);
+	return u;
+}
+
+/**
+ * @brief Zwraca pochodzenie bieżących parametrów.
+ * @return Pochodzenie.
+ */
+strojenie::zrodlo strojenie::pochodzenie() {
+	return (zrodlo)zrodlo_.load();
+}
+
+/**
+ * @brief Zastępuje bieżące parametry.
+ * @param u Nowe parametry.
+ * @throws std::invalid_argument Jeśli parametry są niepoprawne.
+ */
+void strojenie::ustaw(const ustawienia& u) {
+	if (!poprawne(u)) {
+		throw invalid_argument("Invalid tuning parameters");
+	}
+	zastosuj(u);
+	zrodlo_.store(reczne);
+}
+
+/**
+ * @brief Zwraca klucz maszyny.
+ *
+ * Model procesora pochodzi z /proc/cpuinfo (Linux) lub rejestru (Windows).
+ *
+ * @return Klucz maszyny.
+ */
+string strojenie::klucz_maszyny() {
+	string model;
+#if defined(_WIN32)
+	char nazwa[256];
+	DWORD rozmiar = sizeof(nazwa);
+	if (RegGetValueA(HKEY_LOCAL_MACHINE, "HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0", "ProcessorNameString",
+		RRF_RT_REG_SZ, nullptr, nazwa, &rozmiar) == ERROR_SUCCESS) {
+		model = nazwa;
+	}
+#elif defined(__linux__)
+	ifstream cpuinfo("/proc/cpuinfo");
+	string wiersz;
+	while (getline(cpuinfo, wiersz)) {
+		if (wiersz.compare(0, 10, "model name") == 0) {
+			size_t dwukropek = wiersz.find(':');
+			if (dwukropek != string::npos) {
+				model = wiersz.substr(dwukropek + 1);
+			}
+			break;
+		}
+	}
+#endif
+	size_t poczatek = model.find_first_not_of(" \t");
+	model = poczatek == string::npos ? "nieznany procesor" : model.substr(poczatek);
+	for (size_t i = 0; i < model.size(); i++) {
+		if (model[i] == '\t' || model[i] == '\r' || model[i] == '\n') {
+			model[i] = ' ';
+		}
+	}
+	return model + ", watki: " + to_string(pula_watkow::globalna().liczba_watkow());
+}
+
+/**
+ * @brief Dobiera parametry pomiarem.
+ *
+ * Parametry są dobierane kolejno, każdy przy najlepszych dotąd wybranych pozostałych:
+ * - kafel: transpozycja macierzy 2048 x 2048 (kafle 8 - 128),
+ * - rozwinięcie i pasek: iloczyn macierzy 512 x 512,
+ * - próg: najmniejszy rozmiar (16 - 512 wierszy), od którego operacja += z podziałem
+ *   na wątki jest co najmniej o 10% szybsza od wykonania w jednym wątku.
+ *
+ * @return Wybrane parametry.
+ */
+strojenie::ustawienia strojenie::dostroj() {
+	ustawienia u = domyslne_ustawienia();
+	zastosuj(u);
+
+	matrix t;
+	t.alokuj(2048);
+	t.losuj();
+	wybierz(u, &ustawienia::kafel, { 8, 16, 32, 64, 128 }, [&] { return najkrotszy([&] { t.odwroc(); }, 3); });
+
+	matrix a;
+	a.alokuj(512);
+	a.losuj();
+	auto iloczyn = [&] { return najkrotszy([&] { a.iloczyn(a); }, 2); };
+	wybierz(u, &ustawienia::rozwiniecie, { 1, 2, 4 }, iloczyn);
+	wybierz(u, &ustawienia::pasek_kb, { 64, 128, 256, 512, 1024 }, iloczyn);
+
+	if (pula_watkow::globalna().liczba_watkow() > 1) {
+		u.prog = 1024;
+		const int rozmiary[] = { 16, 32, 64, 128, 256, 512 };
+		for (int s : rozmiary) {
+			matrix m;
+			m.alokuj(s);
+			int powtorzenia = max(1, (1 << 20) / (s * s));
+			auto seria = [&] {
+				for (int p = 0; p < powtorzenia; p++) {
+					m += 1;
+				}
+			};
+			ustawienia proba = u;
+			proba.prog = INT_MAX;
+			zastosuj(proba);
+			long long jeden = najkrotszy(seria, 3);
+			proba.prog = 1;
+			zastosuj(proba);
+			long long wiele = najkrotszy(seria, 3);
+			if (wiele * 10 < jeden * 9) {
+				u.prog = s;
+				break;
+			}
+		}
+	}
+
+	zastosuj(u);
+	zrodlo_.store(zmierzone);
+	return u;
+}
+
+/**
+ * @brief Wczytuje parametry tej maszyny z pliku.
+ *
+ * Wiersz pliku: klucz maszyny, tabulacja, kafel, pasek_kb, rozwinięcie i próg
+ * oddzielone spacjami. Wiersze zaczynające się od '#' są pomijane.
+ *
+ * @param plik Ścieżka pliku.
+ * @return True, jeśli znaleziono poprawny wiersz dla tej maszyny.
+ */
+bool strojenie::wczytaj(const string& plik) {
+	ifstream f(plik);
+	if (!f) {
+		return false;
+	}
+	string klucz = klucz_maszyny();
+	string wiersz;
+	while (getline(f, wiersz)) {
+		if (wiersz.compare(0, klucz.size() + 1, klucz + '\t') != 0) {
+			continue;
+		}
+		istringstream wartosci(wiersz.substr(klucz.size() + 1));
+		ustawienia u;
+		if (wartosci >> u.kafel >> u.pasek_kb >> u.rozwiniecie >> u.prog && poprawne(u)) {
+			zastosuj(u);
+			zrodlo_.store(z_pliku);
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Zapisuje bieżące parametry w pliku.
+ * @param plik Ścieżka pliku.
+ * @throws std::runtime_error Jeśli nie można zapisać pliku.
+ */
+void strojenie::zapisz(const string& plik) {
+	string klucz = klucz_maszyny();
+	vector<string> inne;
+	{
+		ifstream f(plik);
+		string wiersz;
+		while (getline(f, wiersz)) {
+			if (wiersz.empty() || wiersz[0] == '#' || wiersz.compare(0, klucz.size() + 1, klucz + '\t') == 0) {
+				continue;
+			}
+			inne.push_back(wiersz);
+		}
+	}
+	ofstream f(plik, ios::trunc);
+	if (!f) {
+		throw runtime_error("Cannot write tuning file");
+	}
+	ustawienia u = biezace();
+	f << "# procesor, watki\tkafel pasek_kb rozwiniecie prog\n";
+	for (size_t i = 0; i < inne.size(); i++) {
+		f << inne[i] << '\n';
+	}
+	f << klucz << '\t' << u.kafel << ' ' << u.pasek_kb << ' ' << u.rozwiniecie << ' ' << u.prog << '\n';
+	if (!f) {
+		throw runtime_error("Cannot write tuning file");
+	}
+}
+
+/**
+ * @brief Wczytuje parametry z pliku, a jeśli ich brak - dobiera je i zapisuje.
+ * @param plik Ścieżka pliku.
+ * @return Bieżące parametry.
+ */
+strojenie::ustawienia strojenie::uruchom(const string& plik) {
+	if (!wczytaj(plik)) {
+		dostroj();
+		zapisz(plik);
+	}
+	return biezace();
+}
@@ -0,0 +1,104 @@
+#pragma once
+#ifndef STROJENIE_H
+#define STROJENIE_H
+
+#include <string>
+using namespace std;
+
+/**
+ * @class strojenie
+ * @brief Parametry jąder macierzy dobierane pomiarem na danej maszynie.
+ *
+ * Do czasu wywołania uruchom(), wczytaj(), dostroj() lub ustaw() obowiązują wartości
+ * domyślne. Pomiar trwa około sekundy, więc wynik jest zapisywany w pliku
+ * z osobnym wierszem dla każdego modelu procesora (i liczby wątków puli) - kolejne
+ * uruchomienia na tej samej maszynie tylko go wczytują. Jądra odczytują parametry
+ * na początku każdej operacji, więc zmiana w trakcie działania jest bezpieczna.
+ */
+class strojenie {
+public:
+    /**
+     * @brief Parametry jąder.
+     */
+    struct ustawienia {
+        int kafel; ///< Bok kafla transpozycji blokowej (matrix::odwroc)
+        int pasek_kb; ///< Rozmiar paska prawego czynnika w iloczynie (KB)
+        int rozwiniecie; ///< Liczba wierszy prawego czynnika na przebieg iloczynu (1, 2 lub 4)
+        int prog; ///< Liczba wierszy, od której operacje elementami są zrównoleglane
+    };
+
+    /**
+     * @brief Pochodzenie bieżących parametrów.
+     */
+    enum zrodlo {
+        domyslne, ///< Wartości wbudowane
+        z_pliku, ///< Wczytane z pliku
+        zmierzone, ///< Dobrane pomiarem w tym uruchomieniu
+        reczne ///< Ustawione przez ustaw()
+    };
+
+    /**
+     * @brief Zwraca wartości wbudowane.
+     * @return Parametry domyślne.
+     */
+    static ustawienia domyslne_ustawienia();
+
+    /**
+     * @brief Zwraca bieżące parametry.
+     * @return Parametry.
+     */
+    static ustawienia biezace();
+
+    /**
+     * @brief Zwraca pochodzenie bieżących parametrów.
+     * @return Pochodzenie.
+     */
+    static zrodlo pochodzenie();
+
+    /**
+     * @brief Zastępuje bieżące parametry.
+     * @param u Nowe parametry.
+     * @throws std::invalid_argument Jeśli parametry są niepoprawne.
+     */
+    static void ustaw(const ustawienia& u);
+
+    /**
+     * @brief Zwraca klucz maszyny: model procesora i liczbę wątków puli.
+     * @return Klucz (bez znaków tabulacji i końca wiersza).
+     */
+    static string klucz_maszyny();
+
+    /**
+     * @brief Dobiera parametry pomiarem i ustawia je.
+     *
+     * Kolejno mierzy transpozycję dla różnych kafli, iloczyn dla różnych rozwinięć
+     * i pasków oraz operację elementami z zrównolegleniem i bez dla rosnących
+     * rozmiarów. W trakcie pomiaru inne wątki mogą widzieć parametry próbne.
+     *
+     * @return Wybrane parametry.
+     */
+    static ustawienia dostroj();
+
+    /**
+     * @brief Wczytuje parametry tej maszyny z pliku.
+     * @param plik Ścieżka pliku.
+     * @return True, jeśli plik zawiera poprawny wiersz dla tej maszyny.
+     */
+    static bool wczytaj(const string& plik);
+
+    /**
+     * @brief Zapisuje bieżące parametry w pliku (wiersze innych maszyn są zachowywane).
+     * @param plik Ścieżka pliku.
+     * @throws std::runtime_error Jeśli nie można zapisać pliku.
+     */
+    static void zapisz(const string& plik);
+
+    /**
+     * @brief Wczytuje parametry z pliku, a jeśli ich brak - dobiera je i zapisuje.
+     * @param plik Ścieżka pliku.
+     * @return Bieżące parametry.
+     */
+    static ustawienia uruchom(const string& plik = "strojenie.txt");
+};
+
+#endif // !STROJENIE_H
@@ -0,0 +1,347 @@
+/**
+ * @file strumien.cpp
+ * @brief Implementacja strumieniowego przetwarzania macierzy blokami wierszy.
+ */
+
+#include "strumien.h"
+#include "watki.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+/**
+ * @class kolejka_blokow
+ * @brief Kolejka bloków o ograniczonej pojemności łącząca dwa etapy potoku.
+ */
+class kolejka_blokow {
+public:
+	explicit kolejka_blokow(int pojemnosc) : pojemnosc((size_t)max(pojemnosc, 1)), zamknieta(false), przerwana(false) {}
+
+	/**
+	 * @brief Wstawia blok, czekając na wolne miejsce.
+	 * @param b Blok.
+	 * @return False, jeśli potok został przerwany.
+	 */
+	bool wstaw(blok_wierszy&& b) {
+		unique_lock<mutex> blokada(mtx);
+		miejsce.wait(blokada, [this] { return przerwana || bloki.size() < pojemnosc; });
+		if (przerwana) {
+			return false;
+		}
+		bloki.push_back(move(b));
+		dane.notify_one();
+		return true;
+	}
+
+	/**
+	 * @brief Pobiera blok, czekając na jego nadejście.
+	 * @param b Pobrany blok.
+	 * @return False, jeśli kolejka jest zamknięta i pusta albo potok przerwano.
+	 */
+	bool pobierz(blok_wierszy& b) {
+		unique_lock<mutex> blokada(mtx);
+		dane.wait(blokada, [this] { return przerwana || zamknieta || !bloki.empty(); });
+		if (przerwana || bloki.empty()) {
+			return false;
+		}
+		b = move(bloki.front());
+		bloki.pop_front();
+		miejsce.notify_one();
+		return true;
+	}
+
+	/**
+	 * @brief Oznacza koniec danych (po pobraniu pozostałych bloków pobierz() zwróci false).
+	 */
+	void zamknij() {
+		lock_guard<mutex> blokada(mtx);
+		zamknieta = true;
+		dane.notify_all();
+	}
+
+	/**
+	 * @brief Przerywa potok, budząc wszystkie oczekujące wątki.
+	 */
+	void przerwij() {
+		lock_guard<mutex> blokada(mtx);
+		przerwana = true;
+		bloki.clear();
+		dane.notify_all();
+		miejsce.notify_all();
+	}
+
+private:
+	mutex mtx; ///< Chroni kolejkę
+	condition_variable dane; ///< Sygnał nadejścia bloku lub zamknięcia
+	condition_variable miejsce; ///< Sygnał zwolnienia miejsca
+	deque<blok_wierszy> bloki; ///< Bloki czekające na pobranie
+	size_t pojemnosc; ///< Największa liczba bloków w kolejce
+	bool zamknieta; ///< Czy nadawca skończył
+	bool przerwana; ///< Czy potok przerwano
+};
+
+/**
+ * @brief Źródło losowych wierszy.
+ * @param n Rozmiar macierzy.
+ * @param wiersze_bloku Liczba wierszy w bloku.
+ * @param ziarno Ziarno generatora.
+ * @param zakres Liczba możliwych wartości.
+ * @return Generator bloków.
+ */
+generator<blok_wierszy> strumien::losowe(int n, int wiersze_bloku, unsigned int ziarno, int zakres) {
+	if (wiersze_bloku < 1 || zakres < 1) {
+		throw invalid_argument("Invalid stream parameters");
+	}
+	for (int i0 = 0; i0 < n; i0 += wiersze_bloku) {
+		blok_wierszy b;
+		b.od = i0;
+		b.n = n;
+		int wiersze = min(wiersze_bloku, n - i0);
+		b.dane.resize((size_t)wiersze * n);
+		int* e = b.dane.data();
+		pula_watkow::globalna().rownolegle(wiersze, [=](int od, int do_, int) {
+			for (int i = od; i < do_; i++) {
+				minstd_rand gen(ziarno ^ ((unsigned int)(i0 + i) * 2654435761U));
+				int* w = e + (size_t)i * n;
+				for (int j = 0; j < n; j++) {
+					w[j] = (int)(gen() % (unsigned int)zakres);
+				}
+			}
+		}, 8);
+		co_yield move(b);
+	}
+}
+
+/**
+ * @brief Źródło wierszy istniejącej macierzy.
+ * @param m Macierz.
+ * @param wiersze_bloku Liczba wierszy w bloku.
+ * @return Generator bloków.
+ */
+generator<blok_wierszy> strumien::z_macierzy(const matrix& m, int wiersze_bloku) {
+	if (wiersze_bloku < 1) {
+		throw invalid_argument("Invalid stream parameters");
+	}
+	for (int i0 = 0; i0 < m.n; i0 += wiersze_bloku) {
+		blok_wierszy b;
+		b.od = i0;
+		b.n = m.n;
+		int wiersze = min(wiersze_bloku, m.n - i0);
+		b.dane.resize((size_t)wiersze * m.n);
+		for (int i = 0; i < wiersze; i++) {
+			copy(m.data[i0 + i], m.data[i0 + i] + m.n, b.wiersz(i));
+		}
+		co_yield move(b);
+	}
+}
+
+/**
+ * @brief Leniwie nakłada etap na bloki generatora.
+ * @param we Generator wejściowy.
+ * @param f Etap.
+ * @return Generator przekształconych bloków.
+ */
+generator<blok_wierszy> strumien::przeksztalc(generator<blok_wierszy> we, etap f) {
+	while (we.nastepny()) {
+		blok_wierszy b = move(we.wartosc());
+		f(b);
+		co_yield move(b);
+	}
+}
+
+/**
+ * @brief Etap stosujący funkcję do każdego elementu.
+ * @param f Funkcja elementu (może zgłosić wyjątek; pula przekazuje go do etapu).
+ * @return Etap.
+ */
+strumien::etap strumien::elementami(const function<int(int)>& f) {
+	return [f](blok_wierszy& b) {
+		int n = b.n;
+		int* e = b.dane.data();
+		pula_watkow::globalna().rownolegle(b.wiersze(), [&](int od, int do_, int) {
+			for (size_t i = (size_t)od * n; i < (size_t)do_ * n; i++) {
+				e[i] = f(e[i]);
+			}
+		}, 8);
+	};
+}
+
+/**
+ * @brief Etap dodający skalar.
+ * @param s Skalar.
+ * @return Etap.
+ */
+strumien::etap strumien::dodaj(int s) {
+	return [s](blok_wierszy& b) {
+		for (size_t i = 0; i < b.dane.size(); i++) {
+			b.dane[i] += s;
+		}
+	};
+}
+
+/**
+ * @brief Etap mnożący przez skalar.
+ * @param s Skalar.
+ * @return Etap.
+ */
+strumien::etap strumien::mnoz(int s) {
+	return [s](blok_wierszy& b) {
+		for (size_t i = 0; i < b.dane.size(); i++) {
+			b.dane[i] *= s;
+		}
+	};
+}
+
+/**
+ * @brief Ujście wypisujące wiersze.
+ * @param o Strumień wyjściowy.
+ * @return Ujście.
+ */
+strumien::ujscie strumien::wypisz(ostream& o) {
+	return [&o](const blok_wierszy& b) {
+		for (int i = 0; i < b.wiersze(); i++) {
+			const int* w = b.wiersz(i);
+			for (int j = 0; j < b.n; j++) {
+				o << w[j] << " ";
+			}
+			o << '\n';
+		}
+	};
+}
+
+/**
+ * @brief Ujście sumujące elementy.
+ * @param wynik Zmienna, do której dodawana jest suma.
+ * @return Ujście.
+ */
+strumien::ujscie strumien::sumuj(long long& wynik) {
+	return [&wynik](const blok_wierszy& b) {
+		long long s = 0;
+		for (size_t i = 0; i < b.dane.size(); i++) {
+			s += b.dane[i];
+		}
+		wynik += s;
+	};
+}
+
+/**
+ * @brief Ujście składające bloki w macierz.
+ * @param m Macierz docelowa.
+ * @return Ujście.
+ * @throws std::invalid_argument Jeśli blok nie pasuje do macierzy.
+ */
+strumien::ujscie strumien::do_macierzy(matrix& m) {
+	return [&m](const blok_wierszy& b) {
+		if (b.n != m.n || b.od + b.wiersze() > m.n) {
+			throw invalid_argument("Matrix dimensions mismatch");
+		}
+		m.do_zapisu();
+		for (int i = 0; i < b.wiersze(); i++) {
+			copy(b.wiersz(i), b.wiersz(i) + b.n, m.data[b.od + i]);
+		}
+	};
+}
+
+/**
+ * @brief Uruchamia potok.
+ *
+ * Między źródłem, kolejnymi etapami i ujściem są kolejki o pojemności `pojemnosc`.
+ * Liczba istniejących bloków jest liczona od pobrania bloku ze źródła do jego
+ * obsłużenia przez ujście i nie przekracza (liczba etapów + 1) * (pojemnosc + 1) + 1.
+ *
+ * @param zrodlo Generator bloków.
+ * @param etapy Kolejne etapy.
+ * @param u Ujście.
+ * @param pojemnosc Pojemność każdej kolejki.
+ * @return Statystyki przebiegu.
+ */
+strumien::statystyki strumien::uruchom(generator<blok_wierszy> zrodlo, const vector<etap>& etapy, const ujscie& u, int pojemnosc) {
+	size_t liczba_kolejek = etapy.size() + 1;
+	vector<unique_ptr<kolejka_blokow>> kolejki;
+	for (size_t i = 0; i < liczba_kolejek; i++) {
+		kolejki.emplace_back(new kolejka_blokow(pojemnosc));
+	}
+
+	atomic<int> istniejace(0);
+	atomic<int> najwiecej(0);
+	mutex mtx_bledu;
+	exception_ptr blad;
+	auto zglos = [&](exception_ptr e) {
+		{
+			lock_guard<mutex> blokada(mtx_bledu);
+			if (!blad) {
+				blad = e;
+			}
+		}
+		for (size_t i = 0; i < kolejki.size(); i++) {
+			kolejki[i]->przerwij();
+		}
+	};
+
+	vector<thread> watki;
+	watki.emplace_back([&] {
+		try {
+			while (zrodlo.nastepny()) {
+				int teraz = ++istniejace;
+				int poprzednie = najwiecej.load();
+				while (teraz > poprzednie && !najwiecej.compare_exchange_weak(poprzednie, teraz)) {
+				}
+				if (!kolejki[0]->wstaw(move(zrodlo.wartosc()))) {
+					return;
+				}
+			}
+			kolejki[0]->zamknij();
+		}
+		catch (...) {
+			zglos(current_exception());
+		}
+	});
+	for (size_t s = 0; s < etapy.size(); s++) {
+		watki.emplace_back([&, s] {
+			try {
+				blok_wierszy b;
+				while (kolejki[s]->pobierz(b)) {
+					etapy[s](b);
+					if (!kolejki[s + 1]->wstaw(move(b))) {
+						return;
+					}
+				}
+				kolejki[s + 1]->zamknij();
+			}
+			catch (...) {
+				zglos(current_exception());
+			}
+		});
+	}
+
+	statystyki st;
+	st.bloki = 0;
+	try {
+		blok_wierszy b;
+		while (kolejki.back()->pobierz(b)) {
+			u(b);
+			b.dane = vector<int>();
+			istniejace--;
+			st.bloki++;
+		}
+	}
+	catch (...) {
+		zglos(current_exception());
+	}
+	for (size_t i = 0; i < watki.size(); i++) {
+		watki[i].join();
+	}
+	if (blad) {
+		rethrow_exception(blad);
+	}
+	st.najwiecej_blokow = najwiecej.load();
+	return st;
+}
@@ -0,0 +1,236 @@
+#pragma once
+#ifndef STRUMIEN_H
+#define STRUMIEN_H
+
+#include "matrix.h"
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+using namespace std;
+
+/**
+ * @class generator
+ * @brief Leniwy ciąg wartości tworzony przez korutynę (co_yield).
+ *
+ * Korutyna jest wznawiana dopiero po żądaniu kolejnej wartości, więc w pamięci jest
+ * tylko bieżący element. Wyjątek zgłoszony w korutynie jest przekazywany do
+ * wywołującego nastepny().
+ *
+ * @tparam T Typ wartości (z konstruktorem domyślnym).
+ */
+template <class T>
+class generator {
+public:
+    /**
+     * @brief Stan korutyny wymagany przez język.
+     */
+    struct promise_type {
+        T wartosc; ///< Ostatnio zwrócona wartość
+        exception_ptr blad; ///< Wyjątek zgłoszony w korutynie
+
+        generator get_return_object() {
+            return generator(coroutine_handle<promise_type>::from_promise(*this));
+        }
+        suspend_always initial_suspend() noexcept { return {}; }
+        suspend_always final_suspend() noexcept { return {}; }
+        suspend_always yield_value(T w) {
+            wartosc = move(w);
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { blad = current_exception(); }
+    };
+
+    generator(generator&& g) noexcept : uchwyt(g.uchwyt) { g.uchwyt = nullptr; }
+
+    generator& operator=(generator&& g) noexcept {
+        if (this != &g) {
+            if (uchwyt) {
+                uchwyt.destroy();
+            }
+            uchwyt = g.uchwyt;
+            g.uchwyt = nullptr;
+        }
+        return *this;
+    }
+
+    generator(const generator&) = delete;
+    generator& operator=(const generator&) = delete;
+
+    ~generator() {
+        if (uchwyt) {
+            uchwyt.destroy();
+        }
+    }
+
+    /**
+     * @brief Wznawia korutynę do następnej wartości.
+     * @return False, jeśli ciąg się skończył.
+     */
+    bool nastepny() {
+        if (!uchwyt || uchwyt.done()) {
+            return false;
+        }
+        uchwyt.resume();
+        if (uchwyt.promise().blad) {
+            exception_ptr blad = uchwyt.promise().blad;
+            uchwyt.promise().blad = nullptr;
+            rethrow_exception(blad);
+        }
+        return !uchwyt.done();
+    }
+
+    /**
+     * @brief Zwraca bieżącą wartość (po udanym nastepny()).
+     * @return Referencja do wartości.
+     */
+    T& wartosc() { return uchwyt.promise().wartosc; }
+
+private:
+    explicit generator(coroutine_handle<promise_type> h) : uchwyt(h) {}
+
+    coroutine_handle<promise_type> uchwyt; ///< Korutyna
+};
+
+/**
+ * @struct blok_wierszy
+ * @brief Kolejne wiersze macierzy n x n przesyłane przez strumień.
+ */
+struct blok_wierszy {
+    int od = 0; ///< Numer pierwszego wiersza w macierzy
+    int n = 0; ///< Długość wiersza
+    vector<int> dane; ///< Elementy wierszy (wierszami)
+
+    /**
+     * @brief Zwraca liczbę wierszy w bloku.
+     * @return Liczba wierszy.
+     */
+    int wiersze() const { return n > 0 ? (int)(dane.size() / n) : 0; }
+
+    /**
+     * @brief Zwraca wskaźnik na i-ty wiersz bloku.
+     * @param i Numer wiersza w bloku.
+     * @return Wskaźnik na n elementów.
+     */
+    int* wiersz(int i) { return dane.data() + (size_t)i * n; }
+    const int* wiersz(int i) const { return dane.data() + (size_t)i * n; }
+};
+
+/**
+ * @class strumien
+ * @brief Przetwarzanie macierzy blokami wierszy bez tworzenia całej macierzy.
+ *
+ * Źródło (korutyna) tworzy kolejne bloki, etapy przekształcają je, a ujście zapisuje
+ * lub redukuje. W uruchom() źródło i każdy etap działają jednocześnie w osobnych
+ * wątkach połączonych kolejkami o ograniczonej pojemności: gdy kolejka jest pełna,
+ * poprzedni etap czeka (przeciwciśnienie). W pamięci jest więc najwyżej kilka
+ * bloków niezależnie od n. Praca wewnątrz bloku jest dzielona na wątki puli.
+ */
+class strumien {
+public:
+    typedef function<void(blok_wierszy&)> etap; ///< Przekształcenie bloku w miejscu
+    typedef function<void(const blok_wierszy&)> ujscie; ///< Odbiorca gotowych bloków
+
+    /**
+     * @brief Statystyki przebiegu.
+     */
+    struct statystyki {
+        long long bloki; ///< Liczba bloków, które dotarły do ujścia
+        int najwiecej_blokow; ///< Największa liczba bloków istniejących jednocześnie
+    };
+
+    /**
+     * @brief Źródło losowych wierszy (0 .. zakres-1).
+     *
+     * Wiersz i jest losowany generatorem zainicjowanym tak jak w matrix::losuj(),
+     * więc wynik zależy tylko od ziarna.
+     *
+     * @param n Rozmiar macierzy.
+     * @param wiersze_bloku Liczba wierszy w bloku.
+     * @param ziarno Ziarno generatora.
+     * @param zakres Liczba możliwych wartości.
+     * @return Generator bloków.
+     */
+    static generator<blok_wierszy> losowe(int n, int wiersze_bloku, unsigned int ziarno, int zakres = 10);
+
+    /**
+     * @brief Źródło wierszy istniejącej macierzy.
+     * @param m Macierz (musi istnieć do końca przetwarzania).
+     * @param wiersze_bloku Liczba wierszy w bloku.
+     * @return Generator bloków.
+     */
+    static generator<blok_wierszy> z_macierzy(const matrix& m, int wiersze_bloku);
+
+    /**
+     * @brief Leniwie nakłada etap na bloki generatora (w wątku konsumenta).
+     * @param we Generator wejściowy.
+     * @param f Etap.
+     * @return Generator przekształconych bloków.
+     */
+    static generator<blok_wierszy> przeksztalc(generator<blok_wierszy> we, etap f);
+
+    /**
+     * @brief Etap stosujący funkcję do każdego elementu (wiersze bloku dzielone na wątki puli).
+     *
+     * Wyjątek zgłoszony przez f w dowolnym wątku puli jest przekazywany z etapu
+     * (w uruchom() zatrzymuje potok).
+     *
+     * @param f Funkcja elementu.
+     * @return Etap.
+     */
+    static etap elementami(const function<int(int)>& f);
+
+    /**
+     * @brief Etap dodający skalar do każdego elementu.
+     * @param s Skalar.
+     * @return Etap.
+     */
+    static etap dodaj(int s);
+
+    /**
+     * @brief Etap mnożący każdy element przez skalar.
+     * @param s Skalar.
+     * @return Etap.
+     */
+    static etap mnoz(int s);
+
+    /**
+     * @brief Ujście wypisujące wiersze w formacie operator<< klasy matrix.
+     * @param o Strumień wyjściowy.
+     * @return Ujście.
+     */
+    static ujscie wypisz(ostream& o);
+
+    /**
+     * @brief Ujście sumujące elementy.
+     * @param wynik Zmienna, do której dodawana jest suma (64 bity).
+     * @return Ujście.
+     */
+    static ujscie sumuj(long long& wynik);
+
+    /**
+     * @brief Ujście składające bloki w macierz.
+     * @param m Macierz docelowa o odpowiednim rozmiarze.
+     * @return Ujście.
+     */
+    static ujscie do_macierzy(matrix& m);
+
+    /**
+     * @brief Uruchamia potok: źródło -> etapy -> ujście.
+     *
+     * Źródło i każdy etap działają w osobnych wątkach, ujście w wątku wywołującym.
+     * Wyjątek z dowolnego miejsca zatrzymuje potok i jest przekazywany dalej.
+     *
+     * @param zrodlo Generator bloków.
+     * @param etapy Kolejne etapy.
+     * @param u Ujście.
+     * @param pojemnosc Pojemność każdej kolejki między etapami (w blokach).
+     * @return Statystyki przebiegu.
+     */
+    static statystyki uruchom(generator<blok_wierszy> zrodlo, const vector<etap>& etapy, const ujscie& u, int pojemnosc = 2);
+};
+
+#endif // !STRUMIEN_H
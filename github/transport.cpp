@@ -0,0 +1,967 @@
+/**
+ * @file transport.cpp
+ * @brief Implementacja transportów komunikatów dla macierzy rozproszonej.
+ */
+
+#include "transport.h"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef SOCKET gniazdo_t;
+typedef int dlugosc_t;
+#define ZAMKNIJ_GNIAZDO closesocket
+#define BRAK_SYGNALU 0
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+typedef int gniazdo_t;
+typedef socklen_t dlugosc_t;
+#define ZAMKNIJ_GNIAZDO close
+#define BRAK_SYGNALU MSG_NOSIGNAL
+#endif
+
+using namespace std;
+
+/**
+ * @brief Nagłówek komunikatu przesyłanego przez TCP.
+ */
+struct naglowek {
+	int znacznik; ///< Znacznik komunikatu
+	int rezerwa; ///< Wyrównanie do 8 bajtów
+	unsigned long long ile; ///< Liczba elementów
+};
+
+/**
+ * @brief Inicjuje obsługę gniazd (tylko Windows, jednorazowo).
+ */
+static void inicjuj_gniazda() {
+#if defined(_WIN32)
+	static const bool gotowe = [] {
+		WSADATA wsa;
+		return WSAStartup(MAKEWORD(2, 2), &wsa) == 0;
+	}();
+	if (!gotowe) {
+		throw runtime_error("Socket initialization failed");
+	}
+#endif
+}
+
+/**
+ * @brief Wysyła cały bufor przez gniazdo.
+ * @param g Gniazdo.
+ * @param dane Bufor.
+ * @param bajty Długość bufora.
+ * @return True, jeśli wysłano wszystkie bajty.
+ */
+static bool wyslij_wszystko(gniazdo_t g, const char* dane, size_t bajty) {
+	while (bajty > 0) {
+		int porcja = (int)min(bajty, (size_t)1 << 30);
+		int wyslane = send(g, dane, porcja, BRAK_SYGNALU);
+		if (wyslane <= 0) {
+			return false;
+		}
+		dane += wyslane;
+		bajty -= (size_t)wyslane;
+	}
+	return true;
+}
+
+/**
+ * @brief Odbiera dokładnie podaną liczbę bajtów z gniazda.
+ * @param g Gniazdo.
+ * @param dane Bufor.
+ * @param bajty Liczba bajtów.
+ * @return True, jeśli odebrano wszystkie bajty.
+ */
+static bool odbierz_wszystko(gniazdo_t g, char* dane, size_t bajty) {
+	while (bajty > 0) {
+		int porcja = (int)min(bajty, (size_t)1 << 30);
+		int odebrane = recv(g, dane, porcja, 0);
+		if (odebrane <= 0) {
+			return false;
+		}
+		dane += odebrane;
+		bajty -= (size_t)odebrane;
+	}
+	return true;
+}
+
+/**
+ * @brief Tworzy gniazdo nasłuchujące.
+ * @param port Port (0 - wybrany przez system).
+ * @param lokalnie True - tylko pętla zwrotna (127.0.0.1), false - wszystkie interfejsy.
+ * @return Gniazdo.
+ * @throws std::runtime_error Jeśli nie udało się utworzyć gniazda.
+ */
+static gniazdo_t nasluchuj(int port, bool lokalnie) {
+	inicjuj_gniazda();
+	gniazdo_t g = socket(AF_INET, SOCK_STREAM, 0);
+	int tak = 1;
+	setsockopt(g, SOL_SOCKET, SO_REUSEADDR, (const char*)&tak, sizeof(tak));
+	sockaddr_in adres;
+	memset(&adres, 0, sizeof(adres));
+	adres.sin_family = AF_INET;
+	adres.sin_addr.s_addr = htonl(lokalnie ? INADDR_LOOPBACK : INADDR_ANY);
+	adres.sin_port = htons((unsigned short)port);
+	if (bind(g, (sockaddr*)&adres, sizeof(adres)) != 0 || listen(g, 64) != 0) {
+		ZAMKNIJ_GNIAZDO(g);
+		throw runtime_error("Cannot listen on port");
+	}
+	return g;
+}
+
+/**
+ * @brief Zwraca port, na którym nasłuchuje gniazdo.
+ * @param g Gniazdo.
+ * @return Numer portu.
+ */
+static int port_gniazda(gniazdo_t g) {
+	sockaddr_in adres;
+	dlugosc_t dlugosc = sizeof(adres);
+	getsockname(g, (sockaddr*)&adres, &dlugosc);
+	return ntohs(adres.sin_port);
+}
+
+/**
+ * @brief Łączy się z uczestnikiem, ponawiając próby do czasu jego uruchomienia.
+ * @param host Nazwa lub adres hosta.
+ * @param port Port.
+ * @return Połączone gniazdo.
+ * @throws std::runtime_error Jeśli połączenie się nie powiodło.
+ */
+static gniazdo_t polacz_z(const string& host, int port) {
+	inicjuj_gniazda();
+	addrinfo wskazowki;
+	memset(&wskazowki, 0, sizeof(wskazowki));
+	wskazowki.ai_family = AF_INET;
+	wskazowki.ai_socktype = SOCK_STREAM;
+	addrinfo* wynik = nullptr;
+	if (getaddrinfo(host.c_str(), to_string(port).c_str(), &wskazowki, &wynik) != 0 || !wynik) {
+		throw runtime_error("Cannot resolve host");
+	}
+	for (int proba = 0; proba < 100; proba++) {
+		gniazdo_t g = socket(AF_INET, SOCK_STREAM, 0);
+		if (connect(g, wynik->ai_addr, (dlugosc_t)wynik->ai_addrlen) == 0) {
+			freeaddrinfo(wynik);
+			return g;
+		}
+		ZAMKNIJ_GNIAZDO(g);
+		this_thread::sleep_for(chrono::milliseconds(50));
+	}
+	freeaddrinfo(wynik);
+	throw runtime_error("Cannot connect to peer");
+}
+
+/**
+ * @brief Destruktor.
+ */
+transport::~transport() {}
+
+/**
+ * @brief Umieszcza komunikat w skrzynce i budzi oczekujących.
+ * @param zrodlo Ranga nadawcy.
+ * @param znacznik Znacznik komunikatu.
+ * @param dane Elementy komunikatu.
+ */
+void transport::dostarcz(int zrodlo, int znacznik, vector<int>&& dane) {
+	{
+		lock_guard<mutex> blokada(mtx);
+		skrzynka[make_pair(zrodlo, znacznik)].push_back(move(dane));
+	}
+	nowy.notify_all();
+}
+
+/**
+ * @brief Oznacza połączenie z nadawcą jako zerwane.
+ * @param zrodlo Ranga nadawcy.
+ * @param powod Komunikat wyjątku zgłaszanego przez odbierz().
+ */
+void transport::zerwij(int zrodlo, const string& powod) {
+	{
+		lock_guard<mutex> blokada(mtx);
+		zerwane.insert(make_pair(zrodlo, powod));
+	}
+	nowy.notify_all();
+}
+
+/**
+ * @brief Odbiera komunikat.
+ *
+ * Komunikaty, które dotarły przed zerwaniem połączenia, są nadal odbierane.
+ *
+ * @param zrodlo Ranga nadawcy.
+ * @param znacznik Znacznik komunikatu.
+ * @return Elementy komunikatu.
+ * @throws std::runtime_error Jeśli połączenie z nadawcą zostało zerwane albo nadawca
+ *         naruszył protokół.
+ */
+vector<int> transport::odbierz(int zrodlo, int znacznik) {
+	pair<int, int> klucz = make_pair(zrodlo, znacznik);
+	unique_lock<mutex> blokada(mtx);
+	for (;;) {
+		map<pair<int, int>, deque<vector<int>>>::iterator it = skrzynka.find(klucz);
+		if (it != skrzynka.end() && !it->second.empty()) {
+			vector<int> dane = move(it->second.front());
+			it->second.pop_front();
+			if (it->second.empty()) {
+				skrzynka.erase(it);
+			}
+			return dane;
+		}
+		map<int, string>::const_iterator z = zerwane.find(zrodlo);
+		if (z != zerwane.end()) {
+			throw runtime_error(z->second);
+		}
+		nowy.wait(blokada);
+	}
+}
+
+/**
+ * @brief Uruchamia funkcję dla każdego uczestnika w osobnym wątku.
+ * @param uczestnicy Transporty wszystkich uczestników.
+ * @param f Funkcja wykonywana przez każdego uczestnika.
+ */
+void transport::uruchom(const vector<unique_ptr<transport>>& uczestnicy, const function<void(transport&)>& f) {
+	vector<exception_ptr> bledy(uczestnicy.size());
+	vector<thread> watki;
+	for (size_t i = 0; i < uczestnicy.size(); i++) {
+		watki.emplace_back([&, i] {
+			try {
+				f(*uczestnicy[i]);
+			}
+			catch (...) {
+				bledy[i] = current_exception();
+			}
+		});
+	}
+	for (size_t i = 0; i < watki.size(); i++) {
+		watki[i].join();
+	}
+	for (size_t i = 0; i < bledy.size(); i++) {
+		if (bledy[i]) {
+			rethrow_exception(bledy[i]);
+		}
+	}
+}
+
+/**
+ * @brief Nagłówek segmentu pamięci współdzielonej.
+ */
+struct alignas(64) naglowek_segmentu {
+	atomic<unsigned int> magia; ///< MAGIA_SEGMENTU po zainicjowaniu przez uczestnika 0
+	int liczba; ///< Liczba uczestników
+	atomic<int> dolaczeni; ///< Liczba uczestników, którzy odwzorowali segment
+};
+
+/// Znacznik zainicjowanego segmentu.
+static const unsigned int MAGIA_SEGMENTU = 0x4D545258;
+
+/**
+ * @brief Bufor cykliczny jednej pary (nadawca, odbiorca) w segmencie.
+ *
+ * Liczniki bajtów rosną bez zawijania; zapisuje je tylko jedna strona (zapisano -
+ * nadawca, odczytano - odbiorca), a każdy leży w osobnej linii pamięci podręcznej.
+ */
+struct transport_pamieci::kanal {
+	alignas(64) atomic<unsigned long long> zapisano; ///< Bajty zapisane przez nadawcę
+	alignas(64) atomic<unsigned long long> odczytano; ///< Bajty odczytane przez odbiorcę
+	alignas(64) atomic<int> nadawca_zamkniety; ///< Nadawca nie wyśle już nic
+	atomic<int> odbiorca_zamkniety; ///< Odbiorca nie odczyta już nic
+	atomic<unsigned long long> proces_nadawcy; ///< Numer procesu nadawcy (0 - jeszcze nie dołączył)
+	atomic<unsigned long long> proces_odbiorcy; ///< Numer procesu odbiorcy (0 - jeszcze nie dołączył)
+	alignas(64) char dane[POJEMNOSC_KANALU]; ///< Bufor
+};
+
+static_assert(atomic<unsigned long long>::is_always_lock_free, "Shared memory transport needs lock-free 64-bit atomics");
+
+/**
+ * @brief Zwraca numer bieżącego procesu.
+ * @return Numer procesu.
+ */
+static unsigned long long ten_proces() {
+#if defined(_WIN32)
+	return GetCurrentProcessId();
+#else
+	return (unsigned long long)getpid();
+#endif
+}
+
+/**
+ * @brief Sprawdza, czy proces uczestnika nadal działa.
+ * @param proces Numer procesu (0 - nieznany, uznawany za działający).
+ * @return False, jeśli proces zakończył się bez zamknięcia kanałów.
+ */
+static bool proces_zyje(unsigned long long proces) {
+	if (proces == 0 || proces == ten_proces()) {
+		return true;
+	}
+#if defined(_WIN32)
+	HANDLE h = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)proces);
+	if (!h) {
+		return false;
+	}
+	bool zyje = WaitForSingleObject(h, 0) == WAIT_TIMEOUT;
+	CloseHandle(h);
+	return zyje;
+#else
+	return kill((pid_t)proces, 0) == 0 || errno != ESRCH;
+#endif
+}
+
+/**
+ * @brief Krótko czeka w pętli oczekiwania: najpierw oddaje procesor, potem usypia.
+ *
+ * Co około 100 ms oczekiwania sprawdza, czy proces drugiej strony kanału działa,
+ * bo zakończony awaryjnie proces nie zamknie swoich kanałów.
+ *
+ * @param proby Licznik prób bieżącego oczekiwania.
+ * @param proces Numer procesu drugiej strony kanału.
+ * @return False, jeśli proces drugiej strony już nie działa.
+ */
+static bool odczekaj(int& proby, unsigned long long proces) {
+	if (++proby < 64) {
+		this_thread::yield();
+		return true;
+	}
+	this_thread::sleep_for(chrono::microseconds(100));
+	return proby % 1000 != 0 || proces_zyje(proces);
+}
+
+/**
+ * @brief Usuwa nazwę segmentu (POSIX; w Windows segment znika z ostatnim uchwytem).
+ * @param nazwa Nazwa segmentu w systemie.
+ */
+static void usun_nazwe(const string& nazwa) {
+#if defined(_WIN32)
+	(void)nazwa;
+#else
+	shm_unlink(nazwa.c_str());
+#endif
+}
+
+/**
+ * @brief Dołącza uczestnika do segmentu i czeka na pozostałych.
+ * @param nazwa Nazwa segmentu.
+ * @param ranga Ranga bieżącego uczestnika.
+ * @param liczba Liczba uczestników.
+ * @throws std::invalid_argument Jeśli ranga lub liczba uczestników jest niepoprawna.
+ * @throws std::runtime_error Jeśli nie udało się dołączyć do segmentu.
+ */
+transport_pamieci::transport_pamieci(const string& nazwa, int ranga, int liczba) : transport_pamieci(nazwa, ranga, liczba, true) {}
+
+/**
+ * @brief Konstruktor.
+ * @param nazwa Nazwa segmentu.
+ * @param ranga Ranga bieżącego uczestnika.
+ * @param liczba Liczba uczestników.
+ * @param czekaj Czy czekać na dołączenie pozostałych uczestników.
+ * @throws std::invalid_argument Jeśli ranga lub liczba uczestników jest niepoprawna.
+ * @throws std::runtime_error Jeśli nie udało się dołączyć do segmentu.
+ */
+transport_pamieci::transport_pamieci(const string& nazwa, int ranga, int liczba, bool czekaj)
+	: r(ranga), p(liczba), uchwyt(-1), mapa(nullptr), zatrzymaj(false) {
+	if (liczba < 1 || ranga < 0 || ranga >= liczba) {
+		throw invalid_argument("Invalid rank");
+	}
+#if defined(_WIN32)
+	this->nazwa = "Local\\" + nazwa;
+#else
+	this->nazwa = "/" + nazwa;
+#endif
+	bajty = sizeof(naglowek_segmentu) + (size_t)liczba * liczba * sizeof(kanal);
+	for (int i = 0; i < liczba; i++) {
+		zapis.emplace_back(new mutex);
+	}
+	otworz(czekaj);
+	for (int j = 0; j < p; j++) {
+		if (j != r) {
+			czytelnicy.emplace_back(&transport_pamieci::czytaj, this, j);
+		}
+	}
+}
+
+/**
+ * @brief Tworzy (uczestnik 0) lub otwiera segment i odwzorowuje go w pamięci.
+ *
+ * Uczestnik 0 tworzy świeży segment, konstruuje nagłówek i kanały, a na końcu zapisuje
+ * znacznik MAGIA_SEGMENTU. Pozostali ponawiają otwarcie, aż segment istnieje i ma
+ * znacznik. Każdy zwiększa licznik dołączonych; przy `czekaj` uczestnik czeka, aż
+ * dołączą wszyscy, a uczestnik 0 usuwa wtedy nazwę segmentu.
+ *
+ * @param czekaj Czy czekać na dołączenie pozostałych uczestników.
+ * @throws std::runtime_error Jeśli nie udało się dołączyć do segmentu.
+ */
+void transport_pamieci::otworz(bool czekaj) {
+	try {
+		for (int proba = 0; !mapa; proba++) {
+			if (proba == 100) {
+				throw runtime_error("Cannot open shared memory segment");
+			}
+#if defined(_WIN32)
+			HANDLE h;
+			if (r == 0) {
+				h = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+					(DWORD)((unsigned long long)bajty >> 32), (DWORD)bajty, nazwa.c_str());
+				if (h && GetLastError() == ERROR_ALREADY_EXISTS) {
+					CloseHandle(h);
+					throw runtime_error("Shared memory segment already exists");
+				}
+			}
+			else {
+				h = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, nazwa.c_str());
+			}
+			if (h) {
+				uchwyt = (long long)(intptr_t)h;
+				mapa = (char*)MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, bajty);
+				if (!mapa) {
+					throw runtime_error("Cannot map shared memory segment");
+				}
+			}
+#else
+			int fd;
+			if (r == 0) {
+				shm_unlink(nazwa.c_str());
+				fd = shm_open(nazwa.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+				if (fd < 0 || ftruncate(fd, (off_t)bajty) != 0) {
+					if (fd >= 0) {
+						close(fd);
+					}
+					throw runtime_error("Cannot create shared memory segment");
+				}
+			}
+			else {
+				fd = shm_open(nazwa.c_str(), O_RDWR, 0600);
+				struct stat st;
+				if (fd >= 0 && (fstat(fd, &st) != 0 || (size_t)st.st_size < bajty)) {
+					close(fd);
+					fd = -1;
+				}
+			}
+			if (fd >= 0) {
+				uchwyt = fd;
+				void* m = mmap(nullptr, bajty, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+				if (m == MAP_FAILED) {
+					throw runtime_error("Cannot map shared memory segment");
+				}
+				mapa = (char*)m;
+			}
+#endif
+			if (!mapa) {
+				this_thread::sleep_for(chrono::milliseconds(50));
+			}
+		}
+
+		naglowek_segmentu* n = (naglowek_segmentu*)mapa;
+		if (r == 0) {
+			n = new (mapa) naglowek_segmentu;
+			n->liczba = p;
+			n->dolaczeni.store(0);
+			for (int i = 0; i < p * p; i++) {
+				kanal* k = new (mapa + sizeof(naglowek_segmentu) + (size_t)i * sizeof(kanal)) kanal;
+				k->zapisano.store(0);
+				k->odczytano.store(0);
+				k->nadawca_zamkniety.store(0);
+				k->odbiorca_zamkniety.store(0);
+				k->proces_nadawcy.store(0);
+				k->proces_odbiorcy.store(0);
+			}
+			n->magia.store(MAGIA_SEGMENTU, memory_order_release);
+		}
+		for (int proba = 0; n->magia.load(memory_order_acquire) != MAGIA_SEGMENTU; proba++) {
+			if (proba == 100) {
+				throw runtime_error("Shared memory segment not initialized");
+			}
+			this_thread::sleep_for(chrono::milliseconds(50));
+		}
+		if (n->liczba != p) {
+			throw runtime_error("Shared memory segment has a different number of participants");
+		}
+		for (int j = 0; j < p; j++) {
+			kanal_pary(r, j).proces_nadawcy.store(ten_proces());
+			kanal_pary(j, r).proces_odbiorcy.store(ten_proces());
+		}
+		n->dolaczeni.fetch_add(1);
+		if (czekaj) {
+			for (int proba = 0; n->dolaczeni.load() < p; proba++) {
+				if (proba == 100) {
+					throw runtime_error("Not all participants joined");
+				}
+				this_thread::sleep_for(chrono::milliseconds(50));
+			}
+			if (r == 0) {
+				usun_nazwe(nazwa);
+			}
+		}
+	}
+	catch (...) {
+		if (r == 0) {
+			usun_nazwe(nazwa);
+		}
+		zamknij();
+		throw;
+	}
+}
+
+/**
+ * @brief Zwalnia odwzorowanie i uchwyt segmentu.
+ */
+void transport_pamieci::zamknij() {
+#if defined(_WIN32)
+	if (mapa) {
+		UnmapViewOfFile(mapa);
+	}
+	if (uchwyt != -1) {
+		CloseHandle((HANDLE)(intptr_t)uchwyt);
+	}
+#else
+	if (mapa) {
+		munmap(mapa, bajty);
+	}
+	if (uchwyt != -1) {
+		close((int)uchwyt);
+	}
+#endif
+	mapa = nullptr;
+	uchwyt = -1;
+}
+
+/**
+ * @brief Tworzy połączonych uczestników w jednym procesie.
+ *
+ * Nazwa segmentu zawiera numer procesu i licznik wywołań. Uczestnicy są tworzeni
+ * kolejno bez czekania na siebie; nazwa jest usuwana po dołączeniu wszystkich.
+ *
+ * @param liczba Liczba uczestników.
+ * @return Transporty uczestników.
+ * @throws std::invalid_argument Jeśli liczba < 1.
+ * @throws std::runtime_error Jeśli nie udało się utworzyć segmentu.
+ */
+vector<unique_ptr<transport>> transport_pamieci::utworz(int liczba) {
+	if (liczba < 1) {
+		throw invalid_argument("Invalid number of participants");
+	}
+	static atomic<int> licznik(0);
+	string nazwa = "macierz_" + to_string(ten_proces()) + "_" + to_string(licznik++);
+	vector<unique_ptr<transport>> wynik;
+	try {
+		for (int i = 0; i < liczba; i++) {
+			wynik.emplace_back(new transport_pamieci(nazwa, i, liczba, false));
+		}
+	}
+	catch (...) {
+		if (!wynik.empty()) {
+			usun_nazwe(((transport_pamieci*)wynik[0].get())->nazwa);
+		}
+		throw;
+	}
+	usun_nazwe(((transport_pamieci*)wynik[0].get())->nazwa);
+	return wynik;
+}
+
+/**
+ * @brief Destruktor.
+ *
+ * Zamyka kanały wychodzące (odbiorcy odczytają jeszcze zapisane komunikaty) i przychodzące,
+ * kończy wątki odczytu i zwalnia segment.
+ */
+transport_pamieci::~transport_pamieci() {
+	for (int j = 0; j < p; j++) {
+		kanal_pary(r, j).nadawca_zamkniety.store(1);
+		kanal_pary(j, r).odbiorca_zamkniety.store(1);
+	}
+	zatrzymaj = true;
+	for (size_t i = 0; i < czytelnicy.size(); i++) {
+		czytelnicy[i].join();
+	}
+	zamknij();
+}
+
+int transport_pamieci::ranga() const {
+	return r;
+}
+
+int transport_pamieci::rozmiar() const {
+	return p;
+}
+
+/**
+ * @brief Zwraca kanał pary uczestników w segmencie.
+ * @param nadawca Ranga nadawcy.
+ * @param odbiorca Ranga odbiorcy.
+ * @return Kanał.
+ */
+transport_pamieci::kanal& transport_pamieci::kanal_pary(int nadawca, int odbiorca) const {
+	return *(kanal*)(mapa + sizeof(naglowek_segmentu) + ((size_t)nadawca * p + odbiorca) * sizeof(kanal));
+}
+
+/**
+ * @brief Zapisuje bajty do kanału, czekając na wolne miejsce.
+ * @param k Kanał.
+ * @param dane Bufor.
+ * @param bajty Liczba bajtów.
+ * @return False, jeśli odbiorca zamknął kanał lub jego proces się zakończył.
+ */
+bool transport_pamieci::zapisz(kanal& k, const char* dane, size_t bajty) {
+	int proby = 0;
+	while (bajty > 0) {
+		unsigned long long z = k.zapisano.load(memory_order_relaxed);
+		size_t wolne = POJEMNOSC_KANALU - (size_t)(z - k.odczytano.load(memory_order_acquire));
+		if (wolne == 0) {
+			if (k.odbiorca_zamkniety.load()) {
+				return false;
+			}
+			if (!odczekaj(proby, k.proces_odbiorcy.load())) {
+				k.odbiorca_zamkniety.store(1);
+			}
+			continue;
+		}
+		proby = 0;
+		size_t poczatek = (size_t)(z % POJEMNOSC_KANALU);
+		size_t porcja = min(min(wolne, bajty), POJEMNOSC_KANALU - poczatek);
+		memcpy(k.dane + poczatek, dane, porcja);
+		k.zapisano.store(z + porcja, memory_order_release);
+		dane += porcja;
+		bajty -= porcja;
+	}
+	return true;
+}
+
+/**
+ * @brief Odczytuje bajty z kanału, czekając na ich zapisanie.
+ * @param k Kanał.
+ * @param dane Bufor.
+ * @param bajty Liczba bajtów.
+ * @return False, jeśli kanał zamknięto (nadawca zamknął go lub jego proces się
+ *         zakończył i wszystko odczytano albo bieżący uczestnik jest niszczony).
+ */
+bool transport_pamieci::odczytaj(kanal& k, char* dane, size_t bajty) {
+	int proby = 0;
+	while (bajty > 0) {
+		unsigned long long o = k.odczytano.load(memory_order_relaxed);
+		size_t dostepne = (size_t)(k.zapisano.load(memory_order_acquire) - o);
+		if (dostepne == 0) {
+			if (zatrzymaj.load() || (k.nadawca_zamkniety.load() && k.zapisano.load(memory_order_acquire) == o)) {
+				return false;
+			}
+			if (!odczekaj(proby, k.proces_nadawcy.load())) {
+				k.nadawca_zamkniety.store(1);
+			}
+			continue;
+		}
+		proby = 0;
+		size_t poczatek = (size_t)(o % POJEMNOSC_KANALU);
+		size_t porcja = min(min(dostepne, bajty), POJEMNOSC_KANALU - poczatek);
+		memcpy(dane, k.dane + poczatek, porcja);
+		k.odczytano.store(o + porcja, memory_order_release);
+		dane += porcja;
+		bajty -= porcja;
+	}
+	return true;
+}
+
+/**
+ * @brief Wysyła komunikat przez kanał pary w segmencie.
+ *
+ * Komunikat do samego siebie trafia bezpośrednio do skrzynki.
+ *
+ * @param cel Ranga odbiorcy.
+ * @param znacznik Znacznik komunikatu.
+ * @param dane Elementy komunikatu.
+ * @throws std::invalid_argument Jeśli ranga odbiorcy jest niepoprawna albo komunikat jest za duży.
+ * @throws std::runtime_error Jeśli odbiorca zamknął kanał.
+ */
+void transport_pamieci::wyslij(int cel, int znacznik, const vector<int>& dane) {
+	if (cel < 0 || cel >= p) {
+		throw invalid_argument("Invalid rank");
+	}
+	if (dane.size() > MAKS_ELEMENTOW) {
+		throw invalid_argument("Message too large");
+	}
+	if (cel == r) {
+		dostarcz(r, znacznik, vector<int>(dane));
+		return;
+	}
+	naglowek n;
+	n.znacznik = znacznik;
+	n.rezerwa = 0;
+	n.ile = dane.size();
+	lock_guard<mutex> blokada(*zapis[cel]);
+	kanal& k = kanal_pary(r, cel);
+	if (!zapisz(k, (const char*)&n, sizeof(n)) || !zapisz(k, (const char*)dane.data(), dane.size() * sizeof(int))) {
+		throw runtime_error("Send failed");
+	}
+}
+
+/**
+ * @brief Pętla wątku odczytu kanału od jednego uczestnika.
+ *
+ * Nagłówek z liczbą elementów większą niż MAKS_ELEMENTOW jest błędem protokołu:
+ * kanał jest zamykany, a odbierz() od tego nadawcy zgłasza wyjątek.
+ *
+ * @param zrodlo Ranga nadawcy.
+ */
+void transport_pamieci::czytaj(int zrodlo) {
+	kanal& k = kanal_pary(zrodlo, r);
+	for (;;) {
+		naglowek n;
+		if (!odczytaj(k, (char*)&n, sizeof(n))) {
+			break;
+		}
+		if (n.ile > MAKS_ELEMENTOW) {
+			k.odbiorca_zamkniety.store(1);
+			zerwij(zrodlo, "Protocol error: message too large");
+			return;
+		}
+		vector<int> dane((size_t)n.ile);
+		if (!odczytaj(k, (char*)dane.data(), dane.size() * sizeof(int))) {
+			break;
+		}
+		dostarcz(zrodlo, n.znacznik, move(dane));
+	}
+	zerwij(zrodlo);
+}
+
+/**
+ * @brief Konstruktor pomocniczy (bez połączeń).
+ * @param ranga Ranga.
+ * @param liczba Liczba uczestników.
+ */
+transport_tcp::transport_tcp(int ranga, int liczba) : r(ranga), p(liczba), gniazda(liczba, -1) {
+	for (int i = 0; i < liczba; i++) {
+		zapis.emplace_back(new mutex);
+	}
+}
+
+/**
+ * @brief Łączy uczestnika z pozostałymi.
+ * @param ranga Ranga bieżącego uczestnika.
+ * @param adresy Adresy (host, port) wszystkich uczestników.
+ * @throws std::runtime_error Jeśli nie udało się nawiązać połączeń.
+ */
+transport_tcp::transport_tcp(int ranga, const vector<pair<string, int>>& adresy) : transport_tcp(ranga, (int)adresy.size()) {
+	if (ranga < 0 || ranga >= p) {
+		throw invalid_argument("Invalid rank");
+	}
+	polacz((long long)nasluchuj(adresy[ranga].second, false), adresy);
+}
+
+/**
+ * @brief Nawiązuje połączenia i uruchamia wątki odczytu.
+ *
+ * Po nawiązaniu połączenia strona łącząca się wysyła swoją rangę.
+ *
+ * @param nasluch Gniazdo nasłuchujące bieżącego uczestnika.
+ * @param adresy Adresy wszystkich uczestników.
+ */
+void transport_tcp::polacz(long long nasluch, const vector<pair<string, int>>& adresy) {
+	gniazdo_t g_nasluch = (gniazdo_t)nasluch;
+	try {
+		for (int j = 0; j < r; j++) {
+			gniazdo_t g = polacz_z(adresy[j].first, adresy[j].second);
+			int tak = 1;
+			setsockopt(g, IPPROTO_TCP, TCP_NODELAY, (const char*)&tak, sizeof(tak));
+			if (!wyslij_wszystko(g, (const char*)&r, sizeof(r))) {
+				ZAMKNIJ_GNIAZDO(g);
+				throw runtime_error("Handshake failed");
+			}
+			gniazda[j] = (long long)g;
+		}
+		for (int j = r + 1; j < p; j++) {
+			gniazdo_t g = accept(g_nasluch, nullptr, nullptr);
+			int kto = -1;
+			if (!odbierz_wszystko(g, (char*)&kto, sizeof(kto)) || kto <= r || kto >= p || gniazda[kto] != -1) {
+				ZAMKNIJ_GNIAZDO(g);
+				throw runtime_error("Handshake failed");
+			}
+			int tak = 1;
+			setsockopt(g, IPPROTO_TCP, TCP_NODELAY, (const char*)&tak, sizeof(tak));
+			gniazda[kto] = (long long)g;
+		}
+	}
+	catch (...) {
+		ZAMKNIJ_GNIAZDO(g_nasluch);
+		for (int j = 0; j < p; j++) {
+			if (gniazda[j] != -1) {
+				ZAMKNIJ_GNIAZDO((gniazdo_t)gniazda[j]);
+			}
+		}
+		throw;
+	}
+	ZAMKNIJ_GNIAZDO(g_nasluch);
+	for (int j = 0; j < p; j++) {
+		if (j != r) {
+			czytelnicy.emplace_back(&transport_tcp::czytaj, this, j);
+		}
+	}
+}
+
+/**
+ * @brief Tworzy uczestników połączonych przez pętlę zwrotną.
+ *
+ * Gniazda nasłuchujące są tworzone z góry (porty wybiera system) tylko na pętli
+ * zwrotnej, więc nie są osiągalne z sieci, a połączenia nawiązywane równolegle,
+ * bo każdy uczestnik czeka na uczestników o większych rangach.
+ *
+ * @param liczba Liczba uczestników.
+ * @return Transporty uczestników.
+ * @throws std::runtime_error Jeśli nie udało się nawiązać połączeń.
+ */
+vector<unique_ptr<transport>> transport_tcp::utworz_lokalnie(int liczba) {
+	if (liczba < 1) {
+		throw invalid_argument("Invalid number of participants");
+	}
+	vector<long long> nasluchy;
+	vector<pair<string, int>> adresy;
+	for (int i = 0; i < liczba; i++) {
+		gniazdo_t g = nasluchuj(0, true);
+		nasluchy.push_back((long long)g);
+		adresy.push_back(make_pair(string("127.0.0.1"), port_gniazda(g)));
+	}
+	vector<unique_ptr<transport_tcp>> uczestnicy;
+	for (int i = 0; i < liczba; i++) {
+		uczestnicy.emplace_back(new transport_tcp(i, liczba));
+	}
+	vector<exception_ptr> bledy(liczba);
+	vector<thread> watki;
+	for (int i = 0; i < liczba; i++) {
+		watki.emplace_back([&, i] {
+			try {
+				uczestnicy[i]->polacz(nasluchy[i], adresy);
+			}
+			catch (...) {
+				bledy[i] = current_exception();
+			}
+		});
+	}
+	for (int i = 0; i < liczba; i++) {
+		watki[i].join();
+	}
+	for (int i = 0; i < liczba; i++) {
+		if (bledy[i]) {
+			rethrow_exception(bledy[i]);
+		}
+	}
+	vector<unique_ptr<transport>> wynik;
+	for (int i = 0; i < liczba; i++) {
+		wynik.emplace_back(uczestnicy[i].release());
+	}
+	return wynik;
+}
+
+/**
+ * @brief Destruktor.
+ *
+ * Zamyka połączenia (co kończy wątki odczytu) i czeka na wątki.
+ */
+transport_tcp::~transport_tcp() {
+	for (int j = 0; j < p; j++) {
+		if (gniazda[j] != -1) {
+#if defined(_WIN32)
+			shutdown((gniazdo_t)gniazda[j], SD_BOTH);
+#else
+			shutdown((gniazdo_t)gniazda[j], SHUT_RDWR);
+#endif
+		}
+	}
+	for (size_t i = 0; i < czytelnicy.size(); i++) {
+		czytelnicy[i].join();
+	}
+	for (int j = 0; j < p; j++) {
+		if (gniazda[j] != -1) {
+			ZAMKNIJ_GNIAZDO((gniazdo_t)gniazda[j]);
+		}
+	}
+}
+
+int transport_tcp::ranga() const {
+	return r;
+}
+
+int transport_tcp::rozmiar() const {
+	return p;
+}
+
+/**
+ * @brief Wysyła komunikat przez połączenie z odbiorcą.
+ *
+ * Komunikat do samego siebie trafia bezpośrednio do skrzynki.
+ *
+ * @param cel Ranga odbiorcy.
+ * @param znacznik Znacznik komunikatu.
+ * @param dane Elementy komunikatu.
+ * @throws std::invalid_argument Jeśli ranga odbiorcy jest niepoprawna.
+ * @throws std::runtime_error Jeśli wysłanie się nie powiodło.
+ */
+void transport_tcp::wyslij(int cel, int znacznik, const vector<int>& dane) {
+	if (cel < 0 || cel >= p) {
+		throw invalid_argument("Invalid rank");
+	}
+	if (dane.size() > MAKS_ELEMENTOW) {
+		throw invalid_argument("Message too large");
+	}
+	if (cel == r) {
+		dostarcz(r, znacznik, vector<int>(dane));
+		return;
+	}
+	naglowek n;
+	n.znacznik = znacznik;
+	n.rezerwa = 0;
+	n.ile = dane.size();
+	lock_guard<mutex> blokada(*zapis[cel]);
+	gniazdo_t g = (gniazdo_t)gniazda[cel];
+	if (!wyslij_wszystko(g, (const char*)&n, sizeof(n)) ||
+		!wyslij_wszystko(g, (const char*)dane.data(), dane.size() * sizeof(int))) {
+		throw runtime_error("Send failed");
+	}
+}
+
+/**
+ * @brief Pętla wątku odczytu połączenia z jednym uczestnikiem.
+ *
+ * Nagłówek z liczbą elementów większą niż MAKS_ELEMENTOW jest błędem protokołu:
+ * połączenie jest zamykane bez przydzielania pamięci, a odbierz() od tego nadawcy
+ * zgłasza wyjątek.
+ *
+ * @param zrodlo Ranga uczestnika po drugiej stronie połączenia.
+ */
+void transport_tcp::czytaj(int zrodlo) {
+	gniazdo_t g = (gniazdo_t)gniazda[zrodlo];
+	for (;;) {
+		naglowek n;
+		if (!odbierz_wszystko(g, (char*)&n, sizeof(n))) {
+			break;
+		}
+		if (n.ile > MAKS_ELEMENTOW) {
+#if defined(_WIN32)
+			shutdown(g, SD_BOTH);
+#else
+			shutdown(g, SHUT_RDWR);
+#endif
+			zerwij(zrodlo, "Protocol error: message too large");
+			return;
+		}
+		vector<int> dane((size_t)n.ile);
+		if (!odbierz_wszystko(g, (char*)dane.data(), dane.size() * sizeof(int))) {
+			break;
+		}
+		dostarcz(zrodlo, n.znacznik, move(dane));
+	}
+	zerwij(zrodlo);
+}
@@ -0,0 +1,225 @@
+#pragma once
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+using namespace std;
+
+/**
+ * @class transport
+ * @brief Wymiana komunikatów między procesami roboczymi macierzy rozproszonej.
+ *
+ * Każdy uczestnik ma numer (rangę) z zakresu [0, rozmiar). Komunikat to tablica
+ * liczb całkowitych ze znacznikiem. Wysyłanie jest buforowane i nie czeka na odbiorcę,
+ * więc można wysłać kolejny blok i liczyć, zanim odbiorca go odczyta. Komunikaty
+ * od jednego nadawcy z tym samym znacznikiem są odbierane w kolejności wysłania.
+ */
+class transport {
+public:
+    static const size_t MAKS_ELEMENTOW = (size_t)1 << 28; ///< Największy komunikat (1 GB elementów)
+
+    virtual ~transport();
+
+    /**
+     * @brief Zwraca numer bieżącego uczestnika.
+     * @return Ranga.
+     */
+    virtual int ranga() const = 0;
+
+    /**
+     * @brief Zwraca liczbę uczestników.
+     * @return Liczba uczestników.
+     */
+    virtual int rozmiar() const = 0;
+
+    /**
+     * @brief Wysyła komunikat (bez czekania na odbiór).
+     * @param cel Ranga odbiorcy.
+     * @param znacznik Znacznik komunikatu.
+     * @param dane Elementy komunikatu (najwyżej MAKS_ELEMENTOW).
+     * @throws std::invalid_argument Jeśli ranga odbiorcy jest niepoprawna albo komunikat
+     *         jest za duży.
+     * @throws std::runtime_error Jeśli wysłanie się nie powiodło.
+     */
+    virtual void wyslij(int cel, int znacznik, const vector<int>& dane) = 0;
+
+    /**
+     * @brief Odbiera komunikat, czekając na jego nadejście.
+     * @param zrodlo Ranga nadawcy.
+     * @param znacznik Znacznik komunikatu.
+     * @return Elementy komunikatu.
+     * @throws std::runtime_error Jeśli połączenie z nadawcą zostało zerwane albo nadawca
+     *         naruszył protokół.
+     */
+    vector<int> odbierz(int zrodlo, int znacznik);
+
+    /**
+     * @brief Uruchamia funkcję dla każdego uczestnika w osobnym wątku i czeka na wszystkie.
+     *
+     * Służy do testowania: uczestnicy, którzy zwykle są osobnymi procesami, działają
+     * w jednym procesie. Pierwszy zgłoszony wyjątek jest przekazywany dalej.
+     *
+     * @param uczestnicy Transporty wszystkich uczestników.
+     * @param f Funkcja wykonywana przez każdego uczestnika.
+     */
+    static void uruchom(const vector<unique_ptr<transport>>& uczestnicy, const function<void(transport&)>& f);
+
+protected:
+    /**
+     * @brief Umieszcza nadesłany komunikat w skrzynce odbiorczej.
+     * @param zrodlo Ranga nadawcy.
+     * @param znacznik Znacznik komunikatu.
+     * @param dane Elementy komunikatu.
+     */
+    void dostarcz(int zrodlo, int znacznik, vector<int>&& dane);
+
+    /**
+     * @brief Oznacza połączenie z nadawcą jako zerwane i budzi oczekujących.
+     * @param zrodlo Ranga nadawcy.
+     * @param powod Komunikat wyjątku zgłaszanego przez odbierz().
+     */
+    void zerwij(int zrodlo, const string& powod = "Connection closed");
+
+private:
+    mutex mtx; ///< Chroni skrzynkę
+    condition_variable nowy; ///< Sygnał nadejścia komunikatu
+    map<pair<int, int>, deque<vector<int>>> skrzynka; ///< (nadawca, znacznik) -> komunikaty
+    map<int, string> zerwane; ///< Ranga nadawcy z zerwanym połączeniem -> powód
+};
+
+/**
+ * @class transport_pamieci
+ * @brief Transport przez nazwany segment pamięci współdzielonej procesów jednego węzła.
+ *
+ * Segment (shm_open/mmap, w Windows CreateFileMapping) zawiera bufor cykliczny dla
+ * każdej uporządkowanej pary uczestników. Nadawca kopiuje nagłówek i elementy do
+ * bufora pary, a wątek odczytu odbiorcy przenosi je do skrzynki, więc duże komunikaty
+ * wysyłane jednocześnie w obu kierunkach nie blokują się nawzajem. Nadawca czeka tylko
+ * wtedy, gdy bufor pary jest pełny. Proces uczestnika zakończony bez zniszczenia
+ * transportu jest wykrywany po około 100 ms oczekiwania na jego kanał, a odbierz()
+ * zgłasza wtedy zerwanie połączenia, jak w transport_tcp.
+ *
+ * Nazwa segmentu musi być niepowtarzalna dla uruchomienia: uczestnik 0 usuwa
+ * pozostałość po poprzednim uruchomieniu i tworzy segment, a po dołączeniu wszystkich
+ * uczestników usuwa nazwę (segment znika po zakończeniu ostatniego procesu).
+ */
+class transport_pamieci : public transport {
+public:
+    static const size_t POJEMNOSC_KANALU = (size_t)1 << 18; ///< Bajty bufora każdej pary uczestników
+
+    /**
+     * @brief Dołącza uczestnika do segmentu i czeka na pozostałych.
+     * @param nazwa Nazwa segmentu (litery, cyfry i '_').
+     * @param ranga Ranga bieżącego uczestnika.
+     * @param liczba Liczba uczestników.
+     * @throws std::invalid_argument Jeśli ranga lub liczba uczestników jest niepoprawna.
+     * @throws std::runtime_error Jeśli nie udało się utworzyć lub otworzyć segmentu
+     *         albo pozostali uczestnicy nie dołączyli w ciągu kilku sekund.
+     */
+    transport_pamieci(const string& nazwa, int ranga, int liczba);
+
+    /**
+     * @brief Tworzy połączonych uczestników w jednym procesie (np. do testów).
+     *
+     * Każdy uczestnik odwzorowuje segment osobno, tak jak osobny proces.
+     *
+     * @param liczba Liczba uczestników.
+     * @return Transporty uczestników (indeks = ranga).
+     * @throws std::invalid_argument Jeśli liczba < 1.
+     * @throws std::runtime_error Jeśli nie udało się utworzyć segmentu.
+     */
+    static vector<unique_ptr<transport>> utworz(int liczba);
+
+    ~transport_pamieci() override;
+
+    int ranga() const override;
+    int rozmiar() const override;
+    void wyslij(int cel, int znacznik, const vector<int>& dane) override;
+
+private:
+    struct kanal;
+
+    transport_pamieci(const string& nazwa, int ranga, int liczba, bool czekaj);
+
+    void otworz(bool czekaj);
+    void zamknij();
+    kanal& kanal_pary(int nadawca, int odbiorca) const;
+    bool zapisz(kanal& k, const char* dane, size_t bajty);
+    bool odczytaj(kanal& k, char* dane, size_t bajty);
+    void czytaj(int zrodlo);
+
+    int r; ///< Ranga
+    int p; ///< Liczba uczestników
+    string nazwa; ///< Nazwa segmentu w systemie
+    size_t bajty; ///< Rozmiar segmentu
+    long long uchwyt; ///< Deskryptor (POSIX) lub uchwyt odwzorowania (Windows), -1 - brak
+    char* mapa; ///< Początek odwzorowanego segmentu
+    atomic<bool> zatrzymaj; ///< Kończy wątki odczytu
+    vector<unique_ptr<mutex>> zapis; ///< Szereguje wysyłanie do każdego uczestnika
+    vector<thread> czytelnicy; ///< Wątki odczytu kanałów
+};
+
+/**
+ * @class transport_tcp
+ * @brief Transport przez gniazda TCP (między węzłami lub przez pętlę zwrotną).
+ *
+ * Każda para uczestników ma jedno połączenie. Osobny wątek dla każdego połączenia
+ * stale odczytuje nadchodzące komunikaty do skrzynki, więc duże komunikaty wysyłane
+ * jednocześnie w obu kierunkach nie blokują się nawzajem.
+ */
+class transport_tcp : public transport {
+public:
+    /**
+     * @brief Łączy uczestnika z pozostałymi.
+     *
+     * Uczestnik nasłuchuje na porcie z pozycji `ranga`, łączy się z uczestnikami
+     * o mniejszych rangach i przyjmuje połączenia od uczestników o większych.
+     *
+     * @param ranga Ranga bieżącego uczestnika.
+     * @param adresy Adresy (host, port) wszystkich uczestników.
+     * @throws std::runtime_error Jeśli nie udało się nawiązać połączeń.
+     */
+    transport_tcp(int ranga, const vector<pair<string, int>>& adresy);
+
+    /**
+     * @brief Tworzy uczestników połączonych przez pętlę zwrotną (127.0.0.1).
+     *
+     * Uczestnicy nasłuchują tylko na 127.0.0.1, a nie na wszystkich interfejsach.
+     *
+     * @param liczba Liczba uczestników.
+     * @return Transporty uczestników (indeks = ranga).
+     * @throws std::runtime_error Jeśli nie udało się nawiązać połączeń.
+     */
+    static vector<unique_ptr<transport>> utworz_lokalnie(int liczba);
+
+    ~transport_tcp() override;
+
+    int ranga() const override;
+    int rozmiar() const override;
+    void wyslij(int cel, int znacznik, const vector<int>& dane) override;
+
+private:
+    transport_tcp(int ranga, int liczba);
+
+    void polacz(long long nasluch, const vector<pair<string, int>>& adresy);
+    void czytaj(int zrodlo);
+
+    int r; ///< Ranga
+    int p; ///< Liczba uczestników
+    vector<long long> gniazda; ///< Gniazdo połączenia z każdym uczestnikiem (-1 - brak)
+    vector<unique_ptr<mutex>> zapis; ///< Szereguje wysyłanie do każdego uczestnika
+    vector<thread> czytelnicy; ///< Wątki odczytu połączeń
+};
+
+#endif // !TRANSPORT_H
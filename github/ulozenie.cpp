@@ -0,0 +1,234 @@
+/**
+ * @file ulozenie.cpp
+ * @brief Implementacja operacji dla polityk ułożenia pamięci macierzy.
+ */
+
+#include "ulozenie.h"
+#include "watki.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * @brief Bok bloku przy transpozycji ułożeń liniowych.
+ */
+static const int BLOK_TRANSPOZYCJI = 32;
+
+/**
+ * @brief Transponuje w miejscu tablicę n x n blokami BLOK_TRANSPOZYCJI x BLOK_TRANSPOZYCJI.
+ *
+ * Wspólne dla ułożenia wierszami i kolumnami: transpozycja tablicy transponuje
+ * macierz niezależnie od tego, jak jest interpretowana.
+ *
+ * @param d Elementy macierzy.
+ * @param n Rozmiar macierzy.
+ */
+static void transponuj_liniowo(int* d, int n) {
+	int bloki = (n + BLOK_TRANSPOZYCJI - 1) / BLOK_TRANSPOZYCJI;
+	pula_watkow::globalna().rownolegle(bloki, [=](int od, int do_, int) {
+		for (int bi = od; bi < do_; bi++) {
+			int i0 = bi * BLOK_TRANSPOZYCJI;
+			int ik = min(i0 + BLOK_TRANSPOZYCJI, n);
+			for (int j0 = 0; j0 <= i0; j0 += BLOK_TRANSPOZYCJI) {
+				int jk = min(j0 + BLOK_TRANSPOZYCJI, n);
+				for (int i = i0; i < ik; i++) {
+					int koniec = j0 == i0 ? i : jk;
+					for (int j = j0; j < koniec; j++) {
+						swap(d[(size_t)i * n + j], d[(size_t)j * n + i]);
+					}
+				}
+			}
+		}
+	}, 4);
+}
+
+/**
+ * @brief Wypełnia kolumnę x (elementy odległe o n).
+ * @param d Elementy macierzy.
+ * @param n Rozmiar macierzy.
+ * @param x Indeks kolumny.
+ * @param t Tablica n wartości.
+ */
+void wierszowe::wypelnij_kolumne(int* d, int n, int x, const int* t) {
+	if (x < 0 || x >= n) {
+		return;
+	}
+	for (int i = 0; i < n; i++) {
+		d[(size_t)i * n + x] = t[i];
+	}
+}
+
+/**
+ * @brief Transponuje macierz w miejscu.
+ * @param d Elementy macierzy.
+ * @param n Rozmiar macierzy.
+ */
+void wierszowe::transponuj(int* d, int n) {
+	transponuj_liniowo(d, n);
+}
+
+/**
+ * @brief Oblicza iloczyn c = a * b w kolejności i-k-j (wiersze b i c czytane ciągle).
+ *
+ * Wiersze wyniku są dzielone między wątki puli. Arytmetyka bez znaku daje
+ * zawijanie modulo 2^32, tak jak w matrix::iloczyn.
+ *
+ * @param a Lewy czynnik.
+ * @param b Prawy czynnik.
+ * @param c Wynik (wyzerowany).
+ * @param n Rozmiar macierzy.
+ */
+void wierszowe::mnoz(const int* a, const int* b, int* c, int n) {
+	pula_watkow::globalna().rownolegle(n, [=](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			unsigned* ci = (unsigned*)c + (size_t)i * n;
+			for (int k = 0; k < n; k++) {
+				unsigned aik = (unsigned)a[(size_t)i * n + k];
+				const unsigned* bk = (const unsigned*)b + (size_t)k * n;
+				for (int j = 0; j < n; j++) {
+					ci[j] += aik * bk[j];
+				}
+			}
+		}
+	}, 8);
+}
+
+/**
+ * @brief Wypełnia kolumnę x (jeden ciągły blok pamięci).
+ * @param d Elementy macierzy.
+ * @param n Rozmiar macierzy.
+ * @param x Indeks kolumny.
+ * @param t Tablica n wartości.
+ */
+void kolumnowe::wypelnij_kolumne(int* d, int n, int x, const int* t) {
+	if (x < 0 || x >= n) {
+		return;
+	}
+	memcpy(d + (size_t)x * n, t, (size_t)n * sizeof(int));
+}
+
+/**
+ * @brief Transponuje macierz w miejscu.
+ * @param d Elementy macierzy.
+ * @param n Rozmiar macierzy.
+ */
+void kolumnowe::transponuj(int* d, int n) {
+	transponuj_liniowo(d, n);
+}
+
+/**
+ * @brief Oblicza iloczyn c = a * b w kolejności j-k-i (kolumny a i c czytane ciągle).
+ *
+ * Kolumna j wyniku to kombinacja kolumn a ze współczynnikami z kolumny j macierzy b.
+ * Kolumny wyniku są dzielone między wątki puli.
+ *
+ * @param a Lewy czynnik.
+ * @param b Prawy czynnik.
+ * @param c Wynik (wyzerowany).
+ * @param n Rozmiar macierzy.
+ */
+void kolumnowe::mnoz(const int* a, const int* b, int* c, int n) {
+	pula_watkow::globalna().rownolegle(n, [=](int od, int do_, int) {
+		for (int j = od; j < do_; j++) {
+			unsigned* cj = (unsigned*)c + (size_t)j * n;
+			for (int k = 0; k < n; k++) {
+				unsigned bkj = (unsigned)b[(size_t)j * n + k];
+				const unsigned* ak = (const unsigned*)a + (size_t)k * n;
+				for (int i = 0; i < n; i++) {
+					cj[i] += bkj * ak[i];
+				}
+			}
+		}
+	}, 8);
+}
+
+/**
+ * @brief Wypełnia kolumnę x (po jednym elemencie w kaflach jednej kolumny kafli).
+ * @param d Elementy macierzy.
+ * @param n Rozmiar macierzy.
+ * @param x Indeks kolumny.
+ * @param t Tablica n wartości.
+ */
+void morton::wypelnij_kolumne(int* d, int n, int x, const int* t) {
+	if (x < 0 || x >= n) {
+		return;
+	}
+	for (int ti = 0; ti < n; ti += KAFEL) {
+		int* e = d + indeks(ti, x, n);
+		int ik = min(ti + KAFEL, n);
+		for (int i = ti; i < ik; i++) {
+			e[(i - ti) * KAFEL] = t[i];
+		}
+	}
+}
+
+/**
+ * @brief Transponuje macierz w miejscu.
+ *
+ * Kafel (ti, tj) jest zamieniany z kaflem (tj, ti) z jednoczesną transpozycją zawartości,
+ * a kafle na przekątnej są transponowane w miejscu. Obszar dopełnienia zawiera zera
+ * i przechodzi sam na siebie.
+ *
+ * @param d Elementy macierzy.
+ * @param n Rozmiar macierzy.
+ */
+void morton::transponuj(int* d, int n) {
+	int k = kafle(n);
+	pula_watkow::globalna().rownolegle(k, [=](int od, int do_, int) {
+		for (int ti = od; ti < do_; ti++) {
+			for (int tj = 0; tj <= ti; tj++) {
+				int* p = d + indeks(ti * KAFEL, tj * KAFEL, n);
+				int* q = d + indeks(tj * KAFEL, ti * KAFEL, n);
+				for (int r = 0; r < KAFEL; r++) {
+					for (int c = ti == tj ? r + 1 : 0; c < KAFEL; c++) {
+						swap(p[r * KAFEL + c], q[c * KAFEL + r]);
+					}
+				}
+			}
+		}
+	}, 2);
+}
+
+/**
+ * @brief Oblicza iloczyn c = a * b kafel po kaflu.
+ *
+ * Dla każdego kafla wyniku sumowane są iloczyny kafli 8 x 8 z wiersza kafli a i kolumny
+ * kafli b. Trzy kafle (768 bajtów) mieszczą się w L1, a kolejne kafle leżą blisko
+ * w pamięci dzięki kolejności Z. Początki kafli są liczone raz, przed pętlą. Wiersze
+ * kafli wyniku są dzielone między wątki puli.
+ *
+ * @param a Lewy czynnik.
+ * @param b Prawy czynnik.
+ * @param c Wynik (wyzerowany).
+ * @param n Rozmiar macierzy.
+ */
+void morton::mnoz(const int* a, const int* b, int* c, int n) {
+	int k = kafle(n);
+	vector<size_t> poczatek((size_t)k * k);
+	for (int ti = 0; ti < k; ti++) {
+		for (int tj = 0; tj < k; tj++) {
+			poczatek[(size_t)ti * k + tj] = pozycja_kafla(ti, tj, k) * KAFEL * KAFEL;
+		}
+	}
+	const size_t* p = poczatek.data();
+	pula_watkow::globalna().rownolegle(k, [=](int od, int do_, int) {
+		for (int ti = od; ti < do_; ti++) {
+			for (int tj = 0; tj < k; tj++) {
+				unsigned* ct = (unsigned*)c + p[(size_t)ti * k + tj];
+				for (int tk = 0; tk < k; tk++) {
+					const unsigned* at = (const unsigned*)a + p[(size_t)ti * k + tk];
+					const unsigned* bt = (const unsigned*)b + p[(size_t)tk * k + tj];
+					for (int r = 0; r < KAFEL; r++) {
+						for (int s = 0; s < KAFEL; s++) {
+							unsigned ars = at[r * KAFEL + s];
+							for (int q = 0; q < KAFEL; q++) {
+								ct[r * KAFEL + q] += ars * bt[s * KAFEL + q];
+							}
+						}
+					}
+				}
+			}
+		}
+	}, 2);
+}
@@ -0,0 +1,400 @@
+#pragma once
+#ifndef ULOZENIE_H
+#define ULOZENIE_H
+
+#include "matrix.h"
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+/**
+ * @struct wierszowe
+ * @brief Ułożenie wierszami: element (i, j) pod indeksem i * n + j.
+ */
+struct wierszowe {
+    static const char* nazwa() { return "wierszowe"; }
+    static size_t rozmiar(int n) { return (size_t)n * n; }
+    static size_t indeks(int i, int j, int n) { return (size_t)i * n + j; }
+
+    /**
+     * @brief Odległość między kolejnymi wierszami wewnątrz kafla 8 x 8.
+     */
+    static size_t krok_wiersza(int n) { return (size_t)n; }
+
+    /**
+     * @brief Odległość między kolejnymi kolumnami wewnątrz kafla 8 x 8.
+     */
+    static size_t krok_kolumny(int) { return 1; }
+
+    /**
+     * @brief Wypełnia kolumnę x wartościami z tablicy t.
+     */
+    static void wypelnij_kolumne(int* d, int n, int x, const int* t);
+
+    /**
+     * @brief Transponuje macierz w miejscu.
+     */
+    static void transponuj(int* d, int n);
+
+    /**
+     * @brief Oblicza iloczyn c = a * b (kolejność i-k-j).
+     */
+    static void mnoz(const int* a, const int* b, int* c, int n);
+};
+
+/**
+ * @struct kolumnowe
+ * @brief Ułożenie kolumnami: element (i, j) pod indeksem j * n + i.
+ */
+struct kolumnowe {
+    static const char* nazwa() { return "kolumnowe"; }
+    static size_t rozmiar(int n) { return (size_t)n * n; }
+    static size_t indeks(int i, int j, int n) { return (size_t)j * n + i; }
+
+    /**
+     * @brief Odległość między kolejnymi wierszami wewnątrz kafla 8 x 8.
+     */
+    static size_t krok_wiersza(int) { return 1; }
+
+    /**
+     * @brief Odległość między kolejnymi kolumnami wewnątrz kafla 8 x 8.
+     */
+    static size_t krok_kolumny(int n) { return (size_t)n; }
+
+    /**
+     * @brief Wypełnia kolumnę x wartościami z tablicy t (ciągły blok pamięci).
+     */
+    static void wypelnij_kolumne(int* d, int n, int x, const int* t);
+
+    /**
+     * @brief Transponuje macierz w miejscu.
+     */
+    static void transponuj(int* d, int n);
+
+    /**
+     * @brief Oblicza iloczyn c = a * b (kolejność j-k-i).
+     */
+    static void mnoz(const int* a, const int* b, int* c, int n);
+};
+
+/**
+ * @struct morton
+ * @brief Ułożenie kaflowe: kafle 8 x 8 (wierszami wewnątrz kafla) w kolejności Z (Mortona).
+ *
+ * Kafle leżą w kolejności kodów Z w siatce kafle(n) x kafle(n), ale bez dopełniania
+ * do potęgi dwójki: pozycja kafla to liczba rzeczywistych kafli o mniejszym kodzie Z,
+ * więc bufor ma tylko kafle(n)^2 * 64 elementów (dopełniane są jedynie brzegowe kafle
+ * do boku 8, a nadmiarowe elementy mają wartość 0). Sąsiednie kafle w obu kierunkach
+ * leżą blisko siebie w pamięci.
+ */
+struct morton {
+    static const int KAFEL = 8; ///< Bok kafla
+
+    static const char* nazwa() { return "morton"; }
+
+    /**
+     * @brief Liczba kafli w wierszu.
+     */
+    static int kafle(int n) { return n > 0 ? (n + KAFEL - 1) / KAFEL : 0; }
+
+    static size_t rozmiar(int n) { return (size_t)kafle(n) * kafle(n) * KAFEL * KAFEL; }
+
+    /**
+     * @brief Rozsuwa bity liczby na pozycje parzyste.
+     */
+    static size_t rozsun(size_t x) {
+        x &= 0xffffffffULL;
+        x = (x | (x << 16)) & 0x0000ffff0000ffffULL;
+        x = (x | (x << 8)) & 0x00ff00ff00ff00ffULL;
+        x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        x = (x | (x << 2)) & 0x3333333333333333ULL;
+        x = (x | (x << 1)) & 0x5555555555555555ULL;
+        return x;
+    }
+
+    /**
+     * @brief Liczba kafli siatki k x k w przedziale [od, od + s) jednej współrzędnej.
+     */
+    static int w_siatce(int od, int s, int k) {
+        return k - od <= 0 ? 0 : (k - od < s ? k - od : s);
+    }
+
+    /**
+     * @brief Pozycja kafla (ti, tj) wśród kafli siatki k x k ułożonych w kolejności Z.
+     *
+     * Dla k będącego potęgą dwójki to po prostu kod Z. W przeciwnym razie schodzi po
+     * poziomach kwadrantów siatki otaczającej i dolicza rzeczywiste kafle kwadrantów
+     * poprzedzających ten, w którym leży kafel - O(log k) bez żadnej tablicy.
+     */
+    static size_t pozycja_kafla(int ti, int tj, int k) {
+        if ((k & (k - 1)) == 0) {
+            return (rozsun((size_t)ti) << 1) | rozsun((size_t)tj);
+        }
+        int s = 1;
+        while (s < k) {
+            s <<= 1;
+        }
+        size_t p = 0;
+        int wi = 0, wj = 0;
+        for (s >>= 1; s > 0; s >>= 1) {
+            if (ti & s) {
+                p += (size_t)w_siatce(wi, s, k) * w_siatce(wj, 2 * s, k);
+                wi += s;
+            }
+            if (tj & s) {
+                p += (size_t)w_siatce(wi, s, k) * w_siatce(wj, s, k);
+                wj += s;
+            }
+        }
+        return p;
+    }
+
+    static size_t indeks(int i, int j, int n) {
+        return pozycja_kafla(i >> 3, j >> 3, kafle(n)) * KAFEL * KAFEL + (size_t)(i & 7) * KAFEL + (j & 7);
+    }
+
+    /**
+     * @brief Odległość między kolejnymi wierszami wewnątrz kafla 8 x 8.
+     */
+    static size_t krok_wiersza(int) { return KAFEL; }
+
+    /**
+     * @brief Odległość między kolejnymi kolumnami wewnątrz kafla 8 x 8.
+     */
+    static size_t krok_kolumny(int) { return 1; }
+
+    /**
+     * @brief Wypełnia kolumnę x wartościami z tablicy t.
+     */
+    static void wypelnij_kolumne(int* d, int n, int x, const int* t);
+
+    /**
+     * @brief Transponuje macierz w miejscu (zamiana i transpozycja par kafli).
+     */
+    static void transponuj(int* d, int n);
+
+    /**
+     * @brief Oblicza iloczyn c = a * b kafel po kaflu.
+     */
+    static void mnoz(const int* a, const int* b, int* c, int n);
+};
+
+/**
+ * @class macierz_ulozona
+ * @brief Macierz kwadratowa z ułożeniem pamięci wybieranym parametrem szablonu.
+ *
+ * Parametr U (wierszowe, kolumnowe, morton) określa, gdzie leży element (i, j),
+ * oraz dostarcza wersji operacji z kolejnością przechodzenia dobraną do ułożenia.
+ *
+ * @tparam U Polityka ułożenia pamięci.
+ */
+template <class U>
+class macierz_ulozona {
+private:
+    int n; ///< Rozmiar macierzy (n x n)
+    vector<int> d; ///< Elementy w ułożeniu U
+
+public:
+    typedef U ulozenie; ///< Polityka ułożenia
+
+    /**
+     * @brief Konstruktor tworzący macierz wypełnioną zerami.
+     * @param size Rozmiar macierzy.
+     */
+    explicit macierz_ulozona(int size = 0) : n(size > 0 ? size : 0), d(U::rozmiar(size > 0 ? size : 0), 0) {}
+
+    /**
+     * @brief Tworzy macierz o ułożeniu U z macierzy klasy matrix.
+     *
+     * Kopiuje kaflami 8 x 8, tak jak przeksztalc().
+     *
+     * @param m Macierz źródłowa.
+     * @return Nowa macierz.
+     */
+    static macierz_ulozona z_macierzy(const matrix& m) {
+        const int n = m.n;
+        macierz_ulozona w(n);
+        const size_t kw = U::krok_wiersza(n), kk = U::krok_kolumny(n);
+        for (int ti = 0; ti < n; ti += 8) {
+            int ik = ti + 8 < n ? ti + 8 : n;
+            for (int tj = 0; tj < n; tj += 8) {
+                int jk = tj + 8 < n ? tj + 8 : n;
+                int* kafel = w.d.data() + U::indeks(ti, tj, n);
+                for (int i = ti; i < ik; i++) {
+                    const int* wiersz = m.data[i];
+                    int* cel = kafel + (i - ti) * kw;
+                    for (int j = tj; j < jk; j++) {
+                        cel[(j - tj) * kk] = wiersz[j];
+                    }
+                }
+            }
+        }
+        return w;
+    }
+
+    /**
+     * @brief Przepisuje macierz do klasy matrix (ułożenie wierszami).
+     *
+     * Kopiuje kaflami 8 x 8, tak jak przeksztalc().
+     *
+     * @return Nowa macierz.
+     */
+    matrix do_macierzy() const {
+        matrix m(n);
+        const size_t kw = U::krok_wiersza(n), kk = U::krok_kolumny(n);
+        for (int ti = 0; ti < n; ti += 8) {
+            int ik = ti + 8 < n ? ti + 8 : n;
+            for (int tj = 0; tj < n; tj += 8) {
+                int jk = tj + 8 < n ? tj + 8 : n;
+                const int* kafel = d.data() + U::indeks(ti, tj, n);
+                for (int i = ti; i < ik; i++) {
+                    int* wiersz = m.data[i];
+                    const int* zrodlo = kafel + (i - ti) * kw;
+                    for (int j = tj; j < jk; j++) {
+                        wiersz[j] = zrodlo[(j - tj) * kk];
+                    }
+                }
+            }
+        }
+        return m;
+    }
+
+    /**
+     * @brief Przepisuje macierz do innego ułożenia.
+     *
+     * Elementy są kopiowane kaflami 8 x 8, więc ani odczyt, ani zapis nie przechodzi
+     * przez pamięć z dużym krokiem w żadnym z ułożeń, a indeks w ułożeniu jest liczony
+     * raz na kafel (wewnątrz kafla wystarczą kroki krok_wiersza() i krok_kolumny()).
+     *
+     * @tparam V Docelowa polityka ułożenia.
+     * @return Nowa macierz.
+     */
+    template <class V>
+    macierz_ulozona<V> przeksztalc() const {
+        macierz_ulozona<V> w(n);
+        const size_t uw = U::krok_wiersza(n), uk = U::krok_kolumny(n);
+        const size_t vw = V::krok_wiersza(n), vk = V::krok_kolumny(n);
+        for (int ti = 0; ti < n; ti += 8) {
+            int ik = ti + 8 < n ? ti + 8 : n;
+            for (int tj = 0; tj < n; tj += 8) {
+                int jk = tj + 8 < n ? tj + 8 : n;
+                const int* zrodlo = d.data() + U::indeks(ti, tj, n);
+                int* cel = w.dane() + V::indeks(ti, tj, n);
+                for (int i = 0; i < ik - ti; i++) {
+                    for (int j = 0; j < jk - tj; j++) {
+                        cel[i * vw + j * vk] = zrodlo[i * uw + j * uk];
+                    }
+                }
+            }
+        }
+        return w;
+    }
+
+    /**
+     * @brief Zwraca rozmiar macierzy.
+     * @return Rozmiar n.
+     */
+    int rozmiar() const { return n; }
+
+    /**
+     * @brief Zwraca wskaźnik na elementy w ułożeniu U.
+     * @return Wskaźnik na pierwszy element.
+     */
+    int* dane() { return d.data(); }
+
+    /**
+     * @brief Zwraca wskaźnik na elementy w ułożeniu U (tylko do odczytu).
+     * @return Wskaźnik na pierwszy element.
+     */
+    const int* dane() const { return d.data(); }
+
+    /**
+     * @brief Wstawia wartość do macierzy (poza zakresem nic nie robi).
+     * @param x Indeks wiersza.
+     * @param y Indeks kolumny.
+     * @param wartosc Wartość do wstawienia.
+     * @return Referencja do macierzy.
+     */
+    macierz_ulozona& wstaw(int x, int y, int wartosc) {
+        if (x >= 0 && x < n && y >= 0 && y < n) {
+            d[U::indeks(x, y, n)] = wartosc;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Pobiera wartość z macierzy.
+     * @param x Indeks wiersza.
+     * @param y Indeks kolumny.
+     * @return Wartość lub 0 poza zakresem.
+     */
+    int pokaz(int x, int y) const {
+        if (x >= 0 && x < n && y >= 0 && y < n) {
+            return d[U::indeks(x, y, n)];
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Wypełnia kolumnę wartościami z tablicy.
+     * @param x Indeks kolumny.
+     * @param t Tablica n wartości.
+     * @return Referencja do macierzy.
+     */
+    macierz_ulozona& kolumna(int x, const int* t) {
+        U::wypelnij_kolumne(d.data(), n, x, t);
+        return *this;
+    }
+
+    /**
+     * @brief Sumuje elementy kolumny.
+     * @param x Indeks kolumny.
+     * @return Suma (64 bity).
+     */
+    long long suma_kolumny(int x) const {
+        long long s = 0;
+        if (x < 0 || x >= n) {
+            return s;
+        }
+        const size_t kw = U::krok_wiersza(n);
+        for (int ti = 0; ti < n; ti += 8) {
+            const int* e = d.data() + U::indeks(ti, x, n);
+            int ik = ti + 8 < n ? ti + 8 : n;
+            for (int i = 0; i < ik - ti; i++) {
+                s += e[i * kw];
+            }
+        }
+        return s;
+    }
+
+    /**
+     * @brief Transponuje macierz w miejscu.
+     * @return Referencja do macierzy.
+     */
+    macierz_ulozona& odwroc() {
+        U::transponuj(d.data(), n);
+        return *this;
+    }
+
+    /**
+     * @brief Iloczyn macierzy w sensie algebraicznym.
+     * @param m Prawy czynnik.
+     * @return Nowa macierz w tym samym ułożeniu.
+     */
+    macierz_ulozona iloczyn(const macierz_ulozona& m) const {
+        macierz_ulozona w(n);
+        U::mnoz(d.data(), m.d.data(), w.d.data(), n);
+        return w;
+    }
+
+    /**
+     * @brief Porównuje dwie macierze pod kątem równości.
+     * @param m Macierz do porównania.
+     * @return True, jeśli macierze są równe.
+     */
+    bool operator==(const macierz_ulozona& m) const {
+        return n == m.n && d == m.d;
+    }
+};
+
+#endif // !ULOZENIE_H
@@ -0,0 +1,206 @@
+/**
+ * @file watki.cpp
+ * @brief Implementacja puli wątków używanej przez operacje na macierzach.
+ */
+
+#include "watki.h"
+#include "sledzenie.h"
+
+using namespace std;
+
+/// Ustawiana w wątkach, które właśnie wykonują fragment zadania puli.
+static thread_local bool w_puli = false;
+
+/**
+ * @brief Ustawia w_puli na czas życia obiektu i przywraca poprzednią wartość
+ * (również gdy fragment zadania zgłosi wyjątek).
+ */
+struct w_puli_na_czas {
+	bool poprzednie; ///< Wartość sprzed ustawienia
+
+	w_puli_na_czas() : poprzednie(w_puli) {
+		w_puli = true;
+	}
+
+	~w_puli_na_czas() {
+		w_puli = poprzednie;
+	}
+};
+
+/**
+ * @brief Zwraca globalną pulę wątków.
+ *
+ * Pula ma tyle wątków, ile rdzeni zgłasza system (co najmniej jeden).
+ *
+ * @return Referencja do puli.
+ */
+pula_watkow& pula_watkow::globalna() {
+	static pula_watkow pula((int)thread::hardware_concurrency());
+	return pula;
+}
+
+/**
+ * @brief Konstruktor.
+ *
+ * Uruchamia `watki - 1` wątków roboczych; wątek wywołujący rownolegle() jest wątkiem numer 0.
+ *
+ * @param watki Łączna liczba wątków.
+ */
+pula_watkow::pula_watkow(int watki)
+	: biezace(nullptr), zakres(0), aktywne(0), pokolenie(0), pozostalo(0), zatrzymaj(false) {
+	if (watki < 1) {
+		watki = 1;
+	}
+	for (int i = 1; i < watki; i++) {
+		this->watki.emplace_back(&pula_watkow::petla, this, i);
+	}
+}
+
+/**
+ * @brief Destruktor.
+ *
+ * Budzi wszystkie wątki robocze i czeka na ich zakończenie.
+ */
+pula_watkow::~pula_watkow() {
+	{
+		lock_guard<mutex> blokada(mtx);
+		zatrzymaj = true;
+	}
+	start.notify_all();
+	for (size_t i = 0; i < watki.size(); i++) {
+		watki[i].join();
+	}
+}
+
+/**
+ * @brief Zwraca liczbę wątków biorących udział w pętli.
+ * @return Liczba wątków roboczych powiększona o wątek wywołujący.
+ */
+int pula_watkow::liczba_watkow() const {
+	return (int)watki.size() + 1;
+}
+
+/**
+ * @brief Wyznacza fragment zakresu przypadający na wątek.
+ *
+ * Fragmenty są ciągłe i różnią się długością co najwyżej o 1.
+ *
+ * @param n Długość zakresu.
+ * @param watek Numer wątku.
+ * @param od Początek fragmentu.
+ * @param do_ Koniec fragmentu (wyłącznie).
+ */
+void pula_watkow::podzial(int n, int watek, int& od, int& do_) const {
+	long long t = liczba_watkow();
+	od = (int)(n * (long long)watek / t);
+	do_ = (int)(n * (long long)(watek + 1) / t);
+}
+
+/**
+ * @brief Wykonuje zadanie równolegle.
+ *
+ * Wątek wywołujący wykonuje fragment numer 0, a następnie czeka na pozostałe wątki.
+ * Wyjątek zgłoszony w dowolnym fragmencie jest przechwytywany; po zakończeniu
+ * wszystkich fragmentów pierwszy z nich jest zgłaszany ponownie w wątku wywołującym.
+ *
+ * @param n Długość zakresu.
+ * @param z Zadanie do wykonania.
+ * @param prog Minimalna długość zakresu, od której opłaca się zrównoleglenie.
+ */
+void pula_watkow::rownolegle(int n, const zadanie& z, int prog) {
+	if (n <= 0) {
+		return;
+	}
+	if (watki.empty() || n < prog || w_puli) {
+		z(0, n, 0);
+		return;
+	}
+
+	lock_guard<mutex> szereg(wywolanie);
+	{
+		lock_guard<mutex> blokada(mtx);
+		biezace = &z;
+		zakres = n;
+		aktywne = liczba_watkow();
+		pozostalo = aktywne - 1;
+		pokolenie++;
+	}
+	start.notify_all();
+
+	int od, do_;
+	podzial(n, 0, od, do_);
+	try {
+		w_puli_na_czas straz;
+		sledzenie::zakres sledz("zadanie puli", do_ - od);
+		z(od, do_, 0);
+	}
+	catch (...) {
+		zapamietaj_blad();
+	}
+
+	exception_ptr e;
+	{
+		unique_lock<mutex> blokada(mtx);
+		koniec.wait(blokada, [this] { return pozostalo == 0; });
+		biezace = nullptr;
+		e = blad;
+		blad = nullptr;
+	}
+	if (e) {
+		rethrow_exception(e);
+	}
+}
+
+/**
+ * @brief Zapamiętuje bieżący wyjątek fragmentu zadania (zachowywany jest pierwszy).
+ */
+void pula_watkow::zapamietaj_blad() {
+	lock_guard<mutex> blokada(mtx);
+	if (!blad) {
+		blad = current_exception();
+	}
+}
+
+/**
+ * @brief Pętla wątku roboczego.
+ *
+ * Czeka na kolejne zadanie, wykonuje swój fragment i zgłasza zakończenie.
+ *
+ * @param id Numer wątku.
+ */
+void pula_watkow::petla(int id) {
+	int widziane = 0;
+	w_puli = true;
+	for (;;) {
+		const zadanie* z;
+		int n;
+		{
+			unique_lock<mutex> blokada(mtx);
+			start.wait(blokada, [this, widziane] { return zatrzymaj || pokolenie != widziane; });
+			if (zatrzymaj) {
+				return;
+			}
+			widziane = pokolenie;
+			z = biezace;
+			n = zakres;
+		}
+
+		int od, do_;
+		podzial(n, id, od, do_);
+		if (od < do_) {
+			try {
+				sledzenie::zakres sledz("zadanie puli", do_ - od);
+				(*z)(od, do_, id);
+			}
+			catch (...) {
+				zapamietaj_blad();
+			}
+		}
+
+		{
+			lock_guard<mutex> blokada(mtx);
+			pozostalo--;
+		}
+		koniec.notify_one();
+	}
+}
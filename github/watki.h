@@ -0,0 +1,89 @@
+#pragma once
+#ifndef WATKI_H
+#define WATKI_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+/**
+ * @class pula_watkow
+ * @brief Stała pula wątków wykonująca pętle równoległe po wierszach macierzy.
+ *
+ * Zakres [0, n) jest dzielony na ciągłe, równe fragmenty - po jednym na wątek.
+ * Podział jest zawsze taki sam dla tego samego n, więc kolejne operacje na tej
+ * samej macierzy trafiają na te same wątki.
+ */
+class pula_watkow {
+public:
+    /**
+     * @brief Zadanie wykonywane na fragmencie zakresu.
+     *
+     * Argumenty: początek fragmentu, koniec fragmentu (wyłącznie), numer wątku.
+     */
+    typedef function<void(int, int, int)> zadanie;
+
+    /**
+     * @brief Zwraca globalną pulę wątków (tworzoną przy pierwszym użyciu).
+     * @return Referencja do puli.
+     */
+    static pula_watkow& globalna();
+
+    /**
+     * @brief Zwraca liczbę wątków biorących udział w pętli (łącznie z wywołującym).
+     * @return Liczba wątków.
+     */
+    int liczba_watkow() const;
+
+    /**
+     * @brief Wyznacza fragment zakresu [0, n) przypadający na dany wątek.
+     * @param n Długość zakresu.
+     * @param watek Numer wątku.
+     * @param od Początek fragmentu.
+     * @param do_ Koniec fragmentu (wyłącznie).
+     */
+    void podzial(int n, int watek, int& od, int& do_) const;
+
+    /**
+     * @brief Wykonuje zadanie równolegle na zakresie [0, n).
+     *
+     * Dla krótkich zakresów oraz wywołań zagnieżdżonych zadanie jest wykonywane
+     * w całości przez wątek wywołujący.
+     *
+     * @param n Długość zakresu.
+     * @param z Zadanie do wykonania.
+     * @param prog Minimalna długość zakresu, od której opłaca się zrównoleglenie.
+     * @throws Pierwszy wyjątek zgłoszony przez którykolwiek fragment zadania, po
+     * zakończeniu wszystkich fragmentów.
+     */
+    void rownolegle(int n, const zadanie& z, int prog = 64);
+
+    pula_watkow(const pula_watkow&) = delete;
+    pula_watkow& operator=(const pula_watkow&) = delete;
+
+private:
+    explicit pula_watkow(int watki);
+    ~pula_watkow();
+
+    void petla(int id);
+    void zapamietaj_blad();
+
+    vector<thread> watki; ///< Wątki robocze (bez wątku wywołującego)
+    mutex mtx; ///< Chroni stan bieżącego zadania
+    mutex wywolanie; ///< Szereguje równoczesne wywołania rownolegle()
+    condition_variable start; ///< Sygnał rozpoczęcia nowego zadania
+    condition_variable koniec; ///< Sygnał zakończenia zadania przez wszystkie wątki
+    const zadanie* biezace; ///< Aktualnie wykonywane zadanie
+    int zakres; ///< Długość zakresu bieżącego zadania
+    int aktywne; ///< Liczba wątków uczestniczących w bieżącym zadaniu
+    int pokolenie; ///< Numer kolejnego zadania
+    int pozostalo; ///< Liczba wątków, które jeszcze nie skończyły
+    bool zatrzymaj; ///< Flaga zakończenia pracy puli
+    exception_ptr blad; ///< Pierwszy wyjątek zgłoszony w bieżącym zadaniu
+};
+
+#endif // !WATKI_H
@@ -0,0 +1,326 @@
+/**
+ * @file wektor.cpp
+ * @brief Implementacja klasy wektor oraz jąder BLAS poziomu 1 i 2.
+ */
+
+#include "wektor.h"
+#include "watki.h"
+#include <stdexcept>
+
+using namespace std;
+
+/// Minimalna długość wektora, od której operacje poziomu 1 są zrównoleglane.
+static const int PROG_WEKTOROWY = 1 << 16;
+
+/**
+ * @brief Konstruktor domyślny.
+ */
+wektor::wektor() {}
+
+/**
+ * @brief Konstruktor tworzący wektor wypełniony zerami.
+ * @param size Długość wektora.
+ */
+wektor::wektor(int size) : dane(size > 0 ? size : 0, 0) {}
+
+/**
+ * @brief Konstruktor inicjalizujący wektor wartościami z tablicy.
+ * @param size Długość wektora.
+ * @param t Tablica przechowująca elementy wektora.
+ */
+wektor::wektor(int size, const int* t) : dane(t, t + (size > 0 ? size : 0)) {}
+
+/**
+ * @brief Zwraca długość wektora.
+ * @return Długość wektora.
+ */
+int wektor::rozmiar() const {
+	return (int)dane.size();
+}
+
+/**
+ * @brief Wstawia wartość do wektora.
+ *
+ * Jeśli indeks wykracza poza zakres, funkcja nie wykonuje żadnych działań.
+ *
+ * @param i Indeks elementu.
+ * @param wartosc Wartość do wstawienia.
+ * @return Referencja do bieżącego wektora.
+ */
+wektor& wektor::wstaw(int i, int wartosc) {
+	if (i >= 0 && i < rozmiar()) {
+		dane[i] = wartosc;
+	}
+	return *this;
+}
+
+/**
+ * @brief Pobiera wartość z wektora.
+ * @param i Indeks elementu.
+ * @return Wartość elementu lub 0, jeśli indeks wykracza poza zakres.
+ */
+int wektor::pokaz(int i) const {
+	if (i >= 0 && i < rozmiar()) {
+		return dane[i];
+	}
+	return 0;
+}
+
+/**
+ * @brief Zwraca wskaźnik na elementy wektora.
+ * @return Wskaźnik na pierwszy element.
+ */
+int* wektor::dane_ptr() {
+	return dane.data();
+}
+
+/**
+ * @brief Zwraca wskaźnik na elementy wektora (tylko do odczytu).
+ * @return Wskaźnik na pierwszy element.
+ */
+const int* wektor::dane_ptr() const {
+	return dane.data();
+}
+
+/**
+ * @brief Porównuje dwa wektory na równość.
+ * @param w Wektor do porównania.
+ * @return True, jeśli wektory mają tę samą długość i te same elementy.
+ */
+bool wektor::operator==(const wektor& w) const {
+	return dane == w.dane;
+}
+
+/**
+ * @brief Wypisuje elementy wektora oddzielone spacjami.
+ * @param o Strumień wyjściowy.
+ * @param w Wektor do wypisania.
+ * @return Referencja do strumienia wyjściowego.
+ */
+ostream& operator<<(ostream& o, const wektor& w) {
+	for (int i = 0; i < w.rozmiar(); i++) {
+		o << w.dane[i] << " ";
+	}
+	o << endl;
+	return o;
+}
+
+/**
+ * @brief Iloczyn skalarny dwóch tablic z czterema niezależnymi akumulatorami.
+ *
+ * Niezależne akumulatory przerywają łańcuch zależności dodawań, co pozwala
+ * kompilatorowi na wektoryzację pętli.
+ *
+ * @param a Pierwsza tablica.
+ * @param b Druga tablica.
+ * @param n Liczba elementów.
+ * @return Iloczyn skalarny (64 bity).
+ */
+static long long iloczyn_skalarny(const int* a, const int* b, int n) {
+	long long s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	int j = 0;
+	for (; j + 4 <= n; j += 4) {
+		s0 += (long long)a[j] * b[j];
+		s1 += (long long)a[j + 1] * b[j + 1];
+		s2 += (long long)a[j + 2] * b[j + 2];
+		s3 += (long long)a[j + 3] * b[j + 3];
+	}
+	for (; j < n; j++) {
+		s0 += (long long)a[j] * b[j];
+	}
+	return s0 + s1 + s2 + s3;
+}
+
+/**
+ * @brief Sprawdza zgodność rozmiarów macierzy i wektora.
+ * @throws std::invalid_argument Jeśli rozmiary się różnią.
+ */
+static void sprawdz_rozmiar(int n, int m) {
+	if (n != m) {
+		throw invalid_argument("Matrix and vector dimensions mismatch");
+	}
+}
+
+/**
+ * @brief Iloczyn macierz-wektor.
+ *
+ * Wiersze macierzy są dzielone między wątki puli; każdy wiersz jest czytany dokładnie raz,
+ * więc operacja jest ograniczona przepustowością pamięci.
+ *
+ * @param alfa Mnożnik iloczynu.
+ * @param a Macierz n x n.
+ * @param x Wektor długości n.
+ * @param beta Mnożnik wektora y.
+ * @param y Wektor wynikowy długości n.
+ * @throws std::invalid_argument Jeśli rozmiary się różnią.
+ */
+void blas::gemv(int alfa, const matrix& a, const wektor& x, int beta, wektor& y) {
+	int n = a.n;
+	sprawdz_rozmiar(n, x.rozmiar());
+	sprawdz_rozmiar(n, y.rozmiar());
+	const int* px = x.dane_ptr();
+	int* py = y.dane_ptr();
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			py[i] = (int)(alfa * iloczyn_skalarny(a.data[i], px, n) + (long long)beta * py[i]);
+		}
+	});
+}
+
+/**
+ * @brief Iloczyn transponowanej macierzy i wektora.
+ *
+ * Macierz jest czytana wierszami (bez transpozycji), a wątki dzielą między siebie kolumny:
+ * każdy wątek dodaje do swoich akumulatorów odcinki kolejnych wierszy pomnożone przez x[i].
+ *
+ * @param alfa Mnożnik iloczynu.
+ * @param a Macierz n x n.
+ * @param x Wektor długości n.
+ * @param beta Mnożnik wektora y.
+ * @param y Wektor wynikowy długości n.
+ * @throws std::invalid_argument Jeśli rozmiary się różnią.
+ */
+void blas::gemv_t(int alfa, const matrix& a, const wektor& x, int beta, wektor& y) {
+	int n = a.n;
+	sprawdz_rozmiar(n, x.rozmiar());
+	sprawdz_rozmiar(n, y.rozmiar());
+	const int* px = x.dane_ptr();
+	int* py = y.dane_ptr();
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+		vector<long long> akumulator(do_ - od, 0);
+		for (int i = 0; i < n; i++) {
+			long long xi = px[i];
+			if (xi == 0) {
+				continue;
+			}
+			const int* w = a.data[i];
+			for (int j = od; j < do_; j++) {
+				akumulator[j - od] += xi * w[j];
+			}
+		}
+		for (int j = od; j < do_; j++) {
+			py[j] = (int)(alfa * akumulator[j - od] + (long long)beta * py[j]);
+		}
+	});
+}
+
+/**
+ * @brief Iloczyn macierzy i wielu wektorów.
+ *
+ * Każdy wiersz macierzy jest mnożony przez wszystkie wektory, zanim zostanie pobrany
+ * następny, więc macierz jest czytana z pamięci tylko raz dla całej paczki.
+ *
+ * @param alfa Mnożnik iloczynu.
+ * @param a Macierz n x n.
+ * @param x Wektory wejściowe.
+ * @param beta Mnożnik wektorów y.
+ * @param y Wektory wynikowe (tyle samo co wejściowych).
+ * @throws std::invalid_argument Jeśli rozmiary się różnią.
+ */
+void blas::gemv(int alfa, const matrix& a, const vector<wektor>& x, int beta, vector<wektor>& y) {
+	int n = a.n;
+	sprawdz_rozmiar((int)x.size(), (int)y.size());
+	for (size_t v = 0; v < x.size(); v++) {
+		sprawdz_rozmiar(n, x[v].rozmiar());
+		sprawdz_rozmiar(n, y[v].rozmiar());
+	}
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			const int* w = a.data[i];
+			for (size_t v = 0; v < x.size(); v++) {
+				int* py = y[v].dane_ptr();
+				py[i] = (int)(alfa * iloczyn_skalarny(w, x[v].dane_ptr(), n) + (long long)beta * py[i]);
+			}
+		}
+	});
+}
+
+/**
+ * @brief Aktualizacja rzędu 1.
+ *
+ * Do każdego wiersza i macierzy dodawany jest wektor y pomnożony przez alfa * x[i].
+ * Wiersze są dzielone między wątki puli.
+ *
+ * @param alfa Mnożnik.
+ * @param x Wektor kolumnowy długości n.
+ * @param y Wektor wierszowy długości n.
+ * @param a Macierz n x n modyfikowana w miejscu.
+ * @throws std::invalid_argument Jeśli rozmiary się różnią.
+ */
+void blas::ger(int alfa, const wektor& x, const wektor& y, matrix& a) {
+	int n = a.n;
+	sprawdz_rozmiar(n, x.rozmiar());
+	sprawdz_rozmiar(n, y.rozmiar());
+	a.do_zapisu();
+	const int* px = x.dane_ptr();
+	const int* py = y.dane_ptr();
+	pula_watkow::globalna().rownolegle(n, [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			int s = alfa * px[i];
+			if (s == 0) {
+				continue;
+			}
+			int* w = a.data[i];
+			for (int j = 0; j < n; j++) {
+				w[j] += s * py[j];
+			}
+		}
+	});
+}
+
+/**
+ * @brief Operacja y = alfa * x + y.
+ * @param alfa Mnożnik.
+ * @param x Wektor wejściowy.
+ * @param y Wektor modyfikowany w miejscu.
+ * @throws std::invalid_argument Jeśli długości wektorów się różnią.
+ */
+void blas::axpy(int alfa, const wektor& x, wektor& y) {
+	sprawdz_rozmiar(x.rozmiar(), y.rozmiar());
+	const int* px = x.dane_ptr();
+	int* py = y.dane_ptr();
+	pula_watkow::globalna().rownolegle(x.rozmiar(), [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			py[i] += alfa * px[i];
+		}
+	}, PROG_WEKTOROWY);
+}
+
+/**
+ * @brief Iloczyn skalarny.
+ *
+ * Sumy częściowe wątków są łączone w stałej kolejności, więc wynik nie zależy
+ * od przeplotu wątków.
+ *
+ * @param x Pierwszy wektor.
+ * @param y Drugi wektor.
+ * @return Iloczyn skalarny (64 bity).
+ * @throws std::invalid_argument Jeśli długości wektorów się różnią.
+ */
+long long blas::dot(const wektor& x, const wektor& y) {
+	sprawdz_rozmiar(x.rozmiar(), y.rozmiar());
+	pula_watkow& pula = pula_watkow::globalna();
+	vector<long long> czesciowe(pula.liczba_watkow(), 0);
+	pula.rownolegle(x.rozmiar(), [&](int od, int do_, int watek) {
+		czesciowe[watek] = iloczyn_skalarny(x.dane_ptr() + od, y.dane_ptr() + od, do_ - od);
+	}, PROG_WEKTOROWY);
+	long long suma = 0;
+	for (size_t t = 0; t < czesciowe.size(); t++) {
+		suma += czesciowe[t];
+	}
+	return suma;
+}
+
+/**
+ * @brief Mnoży wektor przez skalar w miejscu.
+ * @param alfa Mnożnik.
+ * @param x Wektor modyfikowany w miejscu.
+ */
+void blas::skaluj(int alfa, wektor& x) {
+	int* px = x.dane_ptr();
+	pula_watkow::globalna().rownolegle(x.rozmiar(), [&](int od, int do_, int) {
+		for (int i = od; i < do_; i++) {
+			px[i] *= alfa;
+		}
+	}, PROG_WEKTOROWY);
+}
@@ -0,0 +1,159 @@
+#pragma once
+#ifndef WEKTOR_H
+#define WEKTOR_H
+
+#include "matrix.h"
+#include <iostream>
+#include <vector>
+using namespace std;
+
+/**
+ * @class wektor
+ * @brief Wektor liczb całkowitych współpracujący z klasą matrix.
+ */
+class wektor {
+private:
+    vector<int> dane; ///< Elementy wektora
+
+public:
+    /**
+     * @brief Konstruktor domyślny (wektor pusty).
+     */
+    wektor();
+
+    /**
+     * @brief Konstruktor tworzący wektor wypełniony zerami.
+     * @param size Długość wektora.
+     */
+    explicit wektor(int size);
+
+    /**
+     * @brief Konstruktor z tablicą.
+     * @param size Długość wektora.
+     * @param t Wskaźnik na tablicę.
+     */
+    wektor(int size, const int* t);
+
+    /**
+     * @brief Zwraca długość wektora.
+     * @return Długość wektora.
+     */
+    int rozmiar() const;
+
+    /**
+     * @brief Wstawia wartość do wektora.
+     * @param i Indeks elementu.
+     * @param wartosc Wartość do wstawienia.
+     * @return Referencja do wektora.
+     */
+    wektor& wstaw(int i, int wartosc);
+
+    /**
+     * @brief Pobiera wartość z wektora.
+     * @param i Indeks elementu.
+     * @return Wartość elementu lub 0 poza zakresem.
+     */
+    int pokaz(int i) const;
+
+    /**
+     * @brief Zwraca wskaźnik na elementy wektora.
+     * @return Wskaźnik na pierwszy element.
+     */
+    int* dane_ptr();
+
+    /**
+     * @brief Zwraca wskaźnik na elementy wektora (tylko do odczytu).
+     * @return Wskaźnik na pierwszy element.
+     */
+    const int* dane_ptr() const;
+
+    /**
+     * @brief Porównuje dwa wektory pod kątem równości.
+     * @param w Wektor do porównania.
+     * @return True, jeśli wektory są równe.
+     */
+    bool operator==(const wektor& w) const;
+
+    /**
+     * @brief Wypisuje wektor do strumienia wyjściowego.
+     * @param o Strumień wyjściowy.
+     * @param w Wektor do wypisania.
+     * @return Strumień wyjściowy.
+     */
+    friend ostream& operator<<(ostream& o, const wektor& w);
+};
+
+/**
+ * @class blas
+ * @brief Jądra BLAS poziomu 1 i 2 działające bezpośrednio na pamięci macierzy i wektorów.
+ *
+ * Wszystkie iloczyny skalarne są akumulowane na 64 bitach, a wynik zapisywany do elementu
+ * typu int jest obcinany tak jak w operatorach klasy matrix. Operacje na macierzach
+ * są dzielone między wątki puli.
+ */
+class blas {
+public:
+    /**
+     * @brief Iloczyn macierz-wektor: y = alfa * A * x + beta * y.
+     * @param alfa Mnożnik iloczynu.
+     * @param a Macierz n x n.
+     * @param x Wektor długości n.
+     * @param beta Mnożnik wektora y.
+     * @param y Wektor wynikowy długości n.
+     */
+    static void gemv(int alfa, const matrix& a, const wektor& x, int beta, wektor& y);
+
+    /**
+     * @brief Iloczyn transponowanej macierzy i wektora: y = alfa * A^T * x + beta * y.
+     * @param alfa Mnożnik iloczynu.
+     * @param a Macierz n x n.
+     * @param x Wektor długości n.
+     * @param beta Mnożnik wektora y.
+     * @param y Wektor wynikowy długości n.
+     */
+    static void gemv_t(int alfa, const matrix& a, const wektor& x, int beta, wektor& y);
+
+    /**
+     * @brief Iloczyn macierzy i wielu wektorów: y[v] = alfa * A * x[v] + beta * y[v].
+     * @param alfa Mnożnik iloczynu.
+     * @param a Macierz n x n.
+     * @param x Wektory wejściowe.
+     * @param beta Mnożnik wektorów y.
+     * @param y Wektory wynikowe (tyle samo co wejściowych).
+     */
+    static void gemv(int alfa, const matrix& a, const vector<wektor>& x, int beta, vector<wektor>& y);
+
+    /**
+     * @brief Aktualizacja rzędu 1: A = A + alfa * x * y^T.
+     * @param alfa Mnożnik.
+     * @param x Wektor kolumnowy długości n.
+     * @param y Wektor wierszowy długości n.
+     * @param a Macierz n x n modyfikowana w miejscu.
+     */
+    static void ger(int alfa, const wektor& x, const wektor& y, matrix& a);
+
+    /**
+     * @brief Operacja y = alfa * x + y.
+     * @param alfa Mnożnik.
+     * @param x Wektor wejściowy.
+     * @param y Wektor modyfikowany w miejscu.
+     */
+    static void axpy(int alfa, const wektor& x, wektor& y);
+
+    /**
+     * @brief Iloczyn skalarny.
+     * @param x Pierwszy wektor.
+     * @param y Drugi wektor.
+     * @return Iloczyn skalarny (64 bity).
+     */
+    static long long dot(const wektor& x, const wektor& y);
+
+    /**
+     * @brief Mnoży wektor przez skalar w miejscu.
+     * @param alfa Mnożnik.
+     * @param x Wektor modyfikowany w miejscu.
+     */
+    static void skaluj(int alfa, wektor& x);
+};
+
+#endif // !WEKTOR_H
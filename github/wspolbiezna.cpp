@@ -0,0 +1,382 @@
+/**
+ * @file wspolbiezna.cpp
+ * @brief Implementacja macierzy z migawkami bez blokad i publikacją partiami.
+ */
+
+#include "wspolbiezna.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Miejsce, w którym wątek ogłasza epokę swoich migawek.
+ *
+ * Stan to epoka przesunięta o BITY_LICZNIKA bitów i liczba żywych migawek wziętych
+ * przez to miejsce w młodszych bitach. Jedno słowo atomowe pozwala zniszczyć migawkę
+ * w innym wątku: zmniejszenie licznika do zera i wycofanie epoki to ta sama operacja,
+ * więc nie może nadpisać epoki ogłoszonej w międzyczasie przez właściciela miejsca.
+ * Wyrównane do linii pamięci podręcznej, żeby czytelnicy nie unieważniali sobie linii.
+ */
+struct alignas(64) miejsce_epoki {
+	static const int BITY_LICZNIKA = 16; ///< Bity licznika migawek (epoka ma 48 bitów)
+	static const unsigned long long LICZNIK = (1ULL << BITY_LICZNIKA) - 1; ///< Maska licznika
+
+	atomic<unsigned long long> stan{ 0 }; ///< Epoka << BITY_LICZNIKA | liczba migawek
+	atomic<bool> zajete{ false }; ///< Czy miejsce należy do któregoś wątku
+
+	/**
+	 * @brief Zwraca ogłoszoną epokę.
+	 * @return Epoka lub 0, gdy miejsce nie ma żywych migawek.
+	 */
+	unsigned long long epoka() const {
+		unsigned long long s = stan.load();
+		return (s & LICZNIK) ? s >> BITY_LICZNIKA : 0;
+	}
+};
+
+/// Bieżąca epoka (wspólna dla wszystkich macierzy, zaczyna się od 1).
+static atomic<unsigned long long> epoka_(1);
+/// Miejsca ogłaszania epok.
+static miejsce_epoki miejsca_[macierz_wspolbiezna::MAKS_WATKOW];
+
+/**
+ * @brief Miejsce epoki wątku.
+ *
+ * Miejsce jest zajmowane przy pierwszej migawce wątku i zwalniane po jego zakończeniu.
+ * Migawki przeniesione do innych wątków mogą je przeżyć; następny wątek, który zajmie
+ * miejsce, dolicza swoje migawki do ich licznika i zachowuje ich (starszą) epokę.
+ */
+struct czytelnik {
+	int miejsce = -1; ///< Indeks w miejsca_ lub -1
+
+	~czytelnik() {
+		if (miejsce >= 0) {
+			miejsca_[miejsce].zajete.store(false);
+		}
+	}
+
+	/**
+	 * @brief Zwraca indeks miejsca wątku, zajmując wolne przy pierwszym wywołaniu.
+	 * @return Indeks w miejsca_.
+	 * @throws std::runtime_error Jeśli wszystkie miejsca są zajęte.
+	 */
+	int moje() {
+		if (miejsce < 0) {
+			for (int i = 0; i < macierz_wspolbiezna::MAKS_WATKOW; i++) {
+				bool wolne = false;
+				if (miejsca_[i].zajete.compare_exchange_strong(wolne, true)) {
+					miejsce = i;
+					break;
+				}
+			}
+			if (miejsce < 0) {
+				throw runtime_error("Too many reader threads");
+			}
+		}
+		return miejsce;
+	}
+};
+
+/// Stan czytelnika bieżącego wątku.
+static thread_local czytelnik czytelnik_;
+
+/**
+ * @brief Tworzy migawkę wersji (epoka miejsca jest już ogłoszona).
+ * @param w Wersja.
+ * @param miejsce Indeks miejsca epoki, które chroni wersję.
+ */
+macierz_wspolbiezna::migawka::migawka(const wersja* w, int miejsce) : w(w), miejsce(miejsce) {}
+
+macierz_wspolbiezna::migawka::migawka(migawka&& m) noexcept : w(m.w), miejsce(m.miejsce) {
+	m.w = nullptr;
+}
+
+/**
+ * @brief Kończy migawkę; ostatnia migawka miejsca wycofuje jego epokę.
+ *
+ * Zmniejsza licznik miejsca zapisanego w migawce, więc może działać w dowolnym wątku.
+ */
+macierz_wspolbiezna::migawka::~migawka() {
+	if (w) {
+		miejsca_[miejsce].stan.fetch_sub(1);
+	}
+}
+
+/**
+ * @brief Pobiera wartość z macierzy.
+ * @param x Indeks wiersza.
+ * @param y Indeks kolumny.
+ * @return Wartość lub 0 poza zakresem.
+ */
+int macierz_wspolbiezna::migawka::pokaz(int x, int y) const {
+	if (x < 0 || x >= w->n || y < 0 || y >= w->n) {
+		return 0;
+	}
+	const kafel& k = *w->kafle[(size_t)(x / KAFEL) * w->kafle_w_wierszu + y / KAFEL];
+	return k.e[(x % KAFEL) * KAFEL + y % KAFEL];
+}
+
+/**
+ * @brief Zwraca rozmiar macierzy.
+ * @return Rozmiar n.
+ */
+int macierz_wspolbiezna::migawka::rozmiar() const {
+	return w->n;
+}
+
+/**
+ * @brief Zwraca numer wersji.
+ * @return Numer wersji.
+ */
+unsigned long long macierz_wspolbiezna::migawka::numer() const {
+	return w->numer;
+}
+
+/**
+ * @brief Liczy kafle współdzielone z inną migawką.
+ * @param m Druga migawka.
+ * @return Liczba wspólnych kafli.
+ */
+int macierz_wspolbiezna::migawka::wspolne_kafle(const migawka& m) const {
+	if (w->kafle.size() != m.w->kafle.size()) {
+		return 0;
+	}
+	int wspolne = 0;
+	for (size_t i = 0; i < w->kafle.size(); i++) {
+		if (w->kafle[i] == m.w->kafle[i]) {
+			wspolne++;
+		}
+	}
+	return wspolne;
+}
+
+/**
+ * @brief Kopiuje wersję do klasy matrix.
+ * @return Nowa macierz.
+ */
+matrix macierz_wspolbiezna::migawka::do_macierzy() const {
+	int n = w->n;
+	matrix m(n);
+	for (int i = 0; i < n; i++) {
+		for (int j0 = 0; j0 < n; j0 += KAFEL) {
+			const kafel& k = *w->kafle[(size_t)(i / KAFEL) * w->kafle_w_wierszu + j0 / KAFEL];
+			const int* zrodlo = k.e + (i % KAFEL) * KAFEL;
+			copy(zrodlo, zrodlo + min(n - j0, (int)KAFEL), m.data[i] + j0);
+		}
+	}
+	return m;
+}
+
+/**
+ * @brief Tworzy pustą partię.
+ * @param n Rozmiar macierzy.
+ */
+macierz_wspolbiezna::partia::partia(int n) : n(n) {}
+
+/**
+ * @brief Dodaje zmianę elementu.
+ * @param x Indeks wiersza.
+ * @param y Indeks kolumny.
+ * @param wartosc Nowa wartość.
+ * @return Referencja do partii.
+ */
+macierz_wspolbiezna::partia& macierz_wspolbiezna::partia::wstaw(int x, int y, int wartosc) {
+	if (x >= 0 && x < n && y >= 0 && y < n) {
+		zmiany.push_back({ x, y, wartosc });
+	}
+	return *this;
+}
+
+/**
+ * @brief Dodaje zmianę całego wiersza (poza zakresem jest pomijana).
+ * @param y Indeks wiersza.
+ * @param t Tablica n wartości.
+ * @return Referencja do partii.
+ */
+macierz_wspolbiezna::partia& macierz_wspolbiezna::partia::wiersz(int y, const int* t) {
+	if (y >= 0 && y < n) {
+		for (int i = 0; i < n; i++) {
+			zmiany.push_back({ y, i, t[i] });
+		}
+	}
+	return *this;
+}
+
+/**
+ * @brief Dodaje zmianę całej kolumny (poza zakresem jest pomijana).
+ * @param x Indeks kolumny.
+ * @param t Tablica n wartości.
+ * @return Referencja do partii.
+ */
+macierz_wspolbiezna::partia& macierz_wspolbiezna::partia::kolumna(int x, const int* t) {
+	if (x >= 0 && x < n) {
+		for (int i = 0; i < n; i++) {
+			zmiany.push_back({ i, x, t[i] });
+		}
+	}
+	return *this;
+}
+
+/**
+ * @brief Zwraca liczbę zmienionych elementów.
+ * @return Liczba zmian.
+ */
+size_t macierz_wspolbiezna::partia::rozmiar() const {
+	return zmiany.size();
+}
+
+/**
+ * @brief Tworzy macierz z kopii danej macierzy (wersja 0).
+ * @param m Macierz początkowa.
+ */
+macierz_wspolbiezna::macierz_wspolbiezna(const matrix& m) : n(m.n) {
+	wersja* w = new wersja;
+	w->n = n;
+	w->kafle_w_wierszu = (n + KAFEL - 1) / KAFEL;
+	w->numer = 0;
+	for (int bi = 0; bi < w->kafle_w_wierszu; bi++) {
+		for (int bj = 0; bj < w->kafle_w_wierszu; bj++) {
+			shared_ptr<kafel> k = make_shared<kafel>();
+			fill(k->e, k->e + KAFEL * KAFEL, 0);
+			for (int i = bi * KAFEL; i < min(n, (bi + 1) * KAFEL); i++) {
+				for (int j = bj * KAFEL; j < min(n, (bj + 1) * KAFEL); j++) {
+					k->e[(i % KAFEL) * KAFEL + j % KAFEL] = m.data[i][j];
+				}
+			}
+			w->kafle.push_back(k);
+		}
+	}
+	biezaca.store(w);
+}
+
+/**
+ * @brief Zwalnia wszystkie wersje (migawki muszą już być zniszczone).
+ */
+macierz_wspolbiezna::~macierz_wspolbiezna() {
+	for (size_t i = 0; i < wycofane.size(); i++) {
+		delete wycofane[i].second;
+	}
+	delete biezaca.load();
+}
+
+/**
+ * @brief Zwraca rozmiar macierzy.
+ * @return Rozmiar n.
+ */
+int macierz_wspolbiezna::rozmiar() const {
+	return n;
+}
+
+/**
+ * @brief Bierze migawkę bieżącej wersji.
+ *
+ * Pierwsza żywa migawka miejsca ogłasza bieżącą epokę, a dopiero potem odczytuje
+ * wskaźnik wersji; kolejne tylko zwiększają licznik. Pętla powtarza się jedynie wtedy,
+ * gdy równocześnie inny wątek niszczy migawkę przeniesioną z tego miejsca. Pisarz, który wycofał wersję przed odczytem epoki, zwiększył już epokę,
+ * więc odczytany wskaźnik jest nowszy; wersja wycofana później ma epokę większą od
+ * ogłoszonej i nie zostanie zwolniona do końca migawek wątku.
+ *
+ * @return Migawka.
+ * @throws std::runtime_error Jeśli migawki ma już MAKS_WATKOW innych wątków albo
+ *         wątek ma już 65535 żywych migawek.
+ */
+macierz_wspolbiezna::migawka macierz_wspolbiezna::czytaj() const {
+	int i = czytelnik_.moje();
+	miejsce_epoki& m = miejsca_[i];
+	unsigned long long s = m.stan.load();
+	unsigned long long nowy;
+	do {
+		if ((s & miejsce_epoki::LICZNIK) == miejsce_epoki::LICZNIK) {
+			throw runtime_error("Too many snapshots in one thread");
+		}
+		nowy = (s & miejsce_epoki::LICZNIK) ? s + 1 : (epoka_.load() << miejsce_epoki::BITY_LICZNIKA) | 1;
+	} while (!m.stan.compare_exchange_weak(s, nowy));
+	return migawka(biezaca.load(), i);
+}
+
+/**
+ * @brief Pobiera wartość z bieżącej wersji.
+ * @param x Indeks wiersza.
+ * @param y Indeks kolumny.
+ * @return Wartość lub 0 poza zakresem.
+ */
+int macierz_wspolbiezna::pokaz(int x, int y) const {
+	return czytaj().pokaz(x, y);
+}
+
+/**
+ * @brief Tworzy pustą partię zmian.
+ * @return Partia.
+ */
+macierz_wspolbiezna::partia macierz_wspolbiezna::zmiany() const {
+	return partia(n);
+}
+
+/**
+ * @brief Publikuje partię jako nową wersję.
+ * @param p Partia zmian.
+ * @return Numer nowej wersji.
+ * @throws std::invalid_argument Jeśli partia dotyczy macierzy innego rozmiaru.
+ */
+unsigned long long macierz_wspolbiezna::opublikuj(const partia& p) {
+	if (p.n != n) {
+		throw invalid_argument("Matrix dimensions mismatch");
+	}
+	lock_guard<mutex> blokada(pisarz);
+	const wersja* stara = biezaca.load();
+	wersja* nowa = new wersja(*stara);
+	nowa->numer = stara->numer + 1;
+
+	vector<kafel*> kopie(nowa->kafle.size(), nullptr);
+	for (size_t i = 0; i < p.zmiany.size(); i++) {
+		const partia::zmiana& z = p.zmiany[i];
+		size_t t = (size_t)(z.x / KAFEL) * nowa->kafle_w_wierszu + z.y / KAFEL;
+		if (!kopie[t]) {
+			shared_ptr<kafel> k = make_shared<kafel>(*nowa->kafle[t]);
+			kopie[t] = k.get();
+			nowa->kafle[t] = k;
+		}
+		kopie[t]->e[(z.x % KAFEL) * KAFEL + z.y % KAFEL] = z.wartosc;
+	}
+
+	biezaca.store(nowa);
+	wycofane.push_back(make_pair(epoka_.fetch_add(1) + 1, stara));
+	odzyskaj();
+	return nowa->numer;
+}
+
+/**
+ * @brief Zwalnia wycofane wersje, których nie może już widzieć żaden czytelnik.
+ *
+ * Wersja wycofana w epoce e jest bezpieczna, gdy każdy wątek z migawkami ogłosił
+ * epokę co najmniej e. Wywoływana pod blokadą pisarza.
+ */
+void macierz_wspolbiezna::odzyskaj() {
+	unsigned long long najstarsza = ~0ULL;
+	for (int i = 0; i < MAKS_WATKOW; i++) {
+		unsigned long long e = miejsca_[i].epoka();
+		if (e != 0 && e < najstarsza) {
+			najstarsza = e;
+		}
+	}
+	size_t zostaja = 0;
+	for (size_t i = 0; i < wycofane.size(); i++) {
+		if (wycofane[i].first <= najstarsza) {
+			delete wycofane[i].second;
+		}
+		else {
+			wycofane[zostaja++] = wycofane[i];
+		}
+	}
+	wycofane.resize(zostaja);
+}
+
+/**
+ * @brief Zwraca liczbę wycofanych wersji czekających na zwolnienie.
+ * @return Liczba wersji.
+ */
+size_t macierz_wspolbiezna::oczekujace() const {
+	lock_guard<mutex> blokada(pisarz);
+	return wycofane.size();
+}
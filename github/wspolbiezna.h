@@ -0,0 +1,226 @@
+#pragma once
+#ifndef WSPOLBIEZNA_H
+#define WSPOLBIEZNA_H
+
+#include "matrix.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+using namespace std;
+
+/**
+ * @class macierz_wspolbiezna
+ * @brief Macierz czytana przez wiele wątków i zmieniana partiami przez pisarza.
+ *
+ * Macierz jest podzielona na kafle KAFEL x KAFEL. Wersja to tablica wskaźników na
+ * niezmienne kafle; opublikowanie partii zmian kopiuje tylko zmienione kafle, tworzy
+ * nową wersję współdzielącą resztę z poprzednią i podmienia ją jednym zapisem atomowym.
+ * Czytelnik bierze migawkę bez blokad i bez czekania na pisarza (po pierwszym użyciu
+ * w wątku): ogłasza bieżącą epokę i odczytuje wskaźnik wersji. Stara wersja jest
+ * zwalniana przy kolejnej publikacji dopiero wtedy, gdy żaden czytelnik nie ogłosił
+ * epoki sprzed jej wycofania - pisarz nigdy nie czeka na czytelników.
+ */
+class macierz_wspolbiezna {
+private:
+    struct wersja;
+
+public:
+    static const int KAFEL = 64; ///< Bok kafla
+    static const int MAKS_WATKOW = 256; ///< Największa liczba wątków z migawkami jednocześnie
+
+    /**
+     * @class migawka
+     * @brief Spójny, niezmienny widok jednej wersji macierzy.
+     *
+     * Migawkę trzeba zniszczyć przed zniszczeniem macierzy. Można ją przenieść do innego
+     * wątku i tam zniszczyć: pamięta miejsce epoki, które chroni jej wersję.
+     * Wątek może mieć kilka migawek naraz.
+     */
+    class migawka {
+    public:
+        migawka(migawka&& m) noexcept;
+        migawka(const migawka&) = delete;
+        migawka& operator=(const migawka&) = delete;
+        migawka& operator=(migawka&&) = delete;
+        ~migawka();
+
+        /**
+         * @brief Pobiera wartość z macierzy.
+         * @param x Indeks wiersza.
+         * @param y Indeks kolumny.
+         * @return Wartość lub 0 poza zakresem.
+         */
+        int pokaz(int x, int y) const;
+
+        /**
+         * @brief Zwraca rozmiar macierzy.
+         * @return Rozmiar n.
+         */
+        int rozmiar() const;
+
+        /**
+         * @brief Zwraca numer wersji (0 dla wersji początkowej).
+         * @return Numer wersji.
+         */
+        unsigned long long numer() const;
+
+        /**
+         * @brief Liczy kafle współdzielone z inną migawką tej samej macierzy.
+         * @param m Druga migawka.
+         * @return Liczba wspólnych kafli.
+         */
+        int wspolne_kafle(const migawka& m) const;
+
+        /**
+         * @brief Kopiuje wersję do klasy matrix.
+         * @return Nowa macierz.
+         */
+        matrix do_macierzy() const;
+
+    private:
+        friend class macierz_wspolbiezna;
+        migawka(const wersja* w, int miejsce);
+
+        const wersja* w; ///< Wersja lub nullptr po przeniesieniu
+        int miejsce; ///< Indeks miejsca epoki, które chroni wersję
+    };
+
+    /**
+     * @class partia
+     * @brief Zmiany publikowane razem jako jedna nowa wersja.
+     */
+    class partia {
+    public:
+        /**
+         * @brief Dodaje zmianę elementu (poza zakresem jest pomijana).
+         * @param x Indeks wiersza.
+         * @param y Indeks kolumny.
+         * @param wartosc Nowa wartość.
+         * @return Referencja do partii.
+         */
+        partia& wstaw(int x, int y, int wartosc);
+
+        /**
+         * @brief Dodaje zmianę całego wiersza.
+         * @param y Indeks wiersza.
+         * @param t Tablica n wartości.
+         * @return Referencja do partii.
+         */
+        partia& wiersz(int y, const int* t);
+
+        /**
+         * @brief Dodaje zmianę całej kolumny.
+         * @param x Indeks kolumny.
+         * @param t Tablica n wartości.
+         * @return Referencja do partii.
+         */
+        partia& kolumna(int x, const int* t);
+
+        /**
+         * @brief Zwraca liczbę zmienionych elementów.
+         * @return Liczba zmian.
+         */
+        size_t rozmiar() const;
+
+    private:
+        friend class macierz_wspolbiezna;
+        explicit partia(int n);
+
+        /**
+         * @brief Zmiana jednego elementu.
+         */
+        struct zmiana {
+            int x; ///< Wiersz
+            int y; ///< Kolumna
+            int wartosc; ///< Nowa wartość
+        };
+
+        int n; ///< Rozmiar macierzy
+        vector<zmiana> zmiany; ///< Zmiany w kolejności dodania
+    };
+
+    /**
+     * @brief Tworzy macierz z kopii danej macierzy.
+     * @param m Macierz początkowa.
+     */
+    explicit macierz_wspolbiezna(const matrix& m);
+
+    ~macierz_wspolbiezna();
+
+    macierz_wspolbiezna(const macierz_wspolbiezna&) = delete;
+    macierz_wspolbiezna& operator=(const macierz_wspolbiezna&) = delete;
+
+    /**
+     * @brief Zwraca rozmiar macierzy.
+     * @return Rozmiar n.
+     */
+    int rozmiar() const;
+
+    /**
+     * @brief Bierze migawkę bieżącej wersji.
+     * @return Migawka.
+     * @throws std::runtime_error Jeśli migawki ma już MAKS_WATKOW innych wątków albo
+     *         wątek ma już 65535 żywych migawek.
+     */
+    migawka czytaj() const;
+
+    /**
+     * @brief Pobiera wartość z bieżącej wersji (jednorazowa migawka).
+     * @param x Indeks wiersza.
+     * @param y Indeks kolumny.
+     * @return Wartość lub 0 poza zakresem.
+     */
+    int pokaz(int x, int y) const;
+
+    /**
+     * @brief Tworzy pustą partię zmian dla tej macierzy.
+     * @return Partia.
+     */
+    partia zmiany() const;
+
+    /**
+     * @brief Publikuje partię jako nową wersję.
+     *
+     * Zmienione kafle są kopiowane raz na partię. Publikacje z kilku wątków są szeregowane.
+     *
+     * @param p Partia zmian.
+     * @return Numer nowej wersji.
+     * @throws std::invalid_argument Jeśli partia dotyczy macierzy innego rozmiaru.
+     */
+    unsigned long long opublikuj(const partia& p);
+
+    /**
+     * @brief Zwraca liczbę wycofanych wersji czekających na zwolnienie.
+     * @return Liczba wersji.
+     */
+    size_t oczekujace() const;
+
+private:
+    /**
+     * @brief Niezmienny kafel.
+     */
+    struct kafel {
+        int e[KAFEL * KAFEL]; ///< Elementy wierszami
+    };
+
+    /**
+     * @brief Wersja macierzy.
+     */
+    struct wersja {
+        int n; ///< Rozmiar macierzy
+        int kafle_w_wierszu; ///< Liczba kafli w pasie
+        unsigned long long numer; ///< Numer wersji
+        vector<shared_ptr<const kafel>> kafle; ///< Kafle wierszami
+    };
+
+    void odzyskaj();
+
+    int n; ///< Rozmiar macierzy
+    atomic<const wersja*> biezaca; ///< Opublikowana wersja
+    mutable mutex pisarz; ///< Szereguje publikacje
+    vector<pair<unsigned long long, const wersja*>> wycofane; ///< Wersje z epoką wycofania
+};
+
+#endif // !WSPOLBIEZNA_H